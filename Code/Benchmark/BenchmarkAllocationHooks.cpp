@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------------------------------
+// BenchmarkAllocationHooks.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include <cstdlib>
+#include <new>
+
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Game/GameBuildPreferences.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Every heap allocation in the process goes through these, so allocations made by worker threads on
+// behalf of a benchmark are counted too. With GAME_ENABLE_ALLOCATION_TRACKING the AllocationTracker
+// owns the global operators instead, and its totals are read in their place.
+//
+#if !defined(GAME_ENABLE_ALLOCATION_TRACKING)
+
+//----------------------------------------------------------------------------------------------------
+static void* AllocateCounted(size_t const numBytes)
+{
+    BenchmarkRunner::CountAllocation(numBytes);
+
+    if (void* memory = std::malloc(numBytes > 0 ? numBytes : 1)) return memory;
+
+    throw std::bad_alloc();
+}
+
+//----------------------------------------------------------------------------------------------------
+static void* AllocateCountedAligned(size_t const numBytes, std::align_val_t const alignment)
+{
+    BenchmarkRunner::CountAllocation(numBytes);
+
+    size_t const alignmentBytes = static_cast<size_t>(alignment);
+
+#if defined(_MSC_VER)
+    void* memory = _aligned_malloc(numBytes > 0 ? numBytes : 1, alignmentBytes);
+#else
+    void* memory = std::aligned_alloc(alignmentBytes, (numBytes + alignmentBytes - 1) / alignmentBytes * alignmentBytes);
+#endif
+
+    if (memory) return memory;
+
+    throw std::bad_alloc();
+}
+
+//----------------------------------------------------------------------------------------------------
+static void FreeCountedAligned(void* memory)
+{
+#if defined(_MSC_VER)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+void* operator new(size_t const numBytes) { return AllocateCounted(numBytes); }
+void* operator new[](size_t const numBytes) { return AllocateCounted(numBytes); }
+void* operator new(size_t const numBytes, std::align_val_t const alignment) { return AllocateCountedAligned(numBytes, alignment); }
+void* operator new[](size_t const numBytes, std::align_val_t const alignment) { return AllocateCountedAligned(numBytes, alignment); }
+void  operator delete(void* memory) noexcept { std::free(memory); }
+void  operator delete[](void* memory) noexcept { std::free(memory); }
+void  operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void  operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void  operator delete(void* memory, std::align_val_t) noexcept { FreeCountedAligned(memory); }
+void  operator delete[](void* memory, std::align_val_t) noexcept { FreeCountedAligned(memory); }
+void  operator delete(void* memory, size_t, std::align_val_t) noexcept { FreeCountedAligned(memory); }
+void  operator delete[](void* memory, size_t, std::align_val_t) noexcept { FreeCountedAligned(memory); }
+
+#endif
@@ -0,0 +1,384 @@
+//----------------------------------------------------------------------------------------------------
+// BenchmarkRunner.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Benchmark/BenchmarkRunner.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/AllocationTracker.hpp"
+#include "Game/GameBuildPreferences.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Fed by the global operator new replacements in BenchmarkAllocationHooks.cpp, which only the
+// Benchmark executable links; in the game (bench.run) they stay at zero.
+//
+static std::atomic<int64_t> s_numAllocations{0};
+static std::atomic<int64_t> s_numAllocatedBytes{0};
+
+//----------------------------------------------------------------------------------------------------
+void BenchmarkResult::SetCountersPerOp(HardwareCounterSample const& totals, int64_t const numOps)
+{
+    for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+    {
+        m_countersPerOp[counterIndex] = totals.m_values[counterIndex] >= 0 && numOps > 0
+                                            ? static_cast<double>(totals.m_values[counterIndex]) / static_cast<double>(numOps)
+                                            : -1.0;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+BenchmarkRunner::BenchmarkRunner(BenchmarkConfig const& config)
+    : m_config(config)
+{
+    if (m_config.m_isReadingCounters) m_counters = std::make_unique<HardwareCounterGroup>();
+}
+
+//----------------------------------------------------------------------------------------------------
+String BenchmarkRunner::GetCountersDescription() const
+{
+    if (!m_counters) return "off";
+    if (!m_counters->IsAvailable()) return "unavailable (" + m_counters->GetUnavailableReason() + ")";
+
+    String description;
+
+    for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+    {
+        if (!m_counters->IsCounterAvailable(static_cast<HardwareCounter>(counterIndex))) continue;
+
+        description += description.empty() ? "" : " ";
+        description += GetHardwareCounterName(static_cast<HardwareCounter>(counterIndex));
+    }
+
+    return description;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Describes the machine and build the results came from, e.g. the mask kernel in use.
+//
+void BenchmarkRunner::SetContextValue(String const& key, String const& value)
+{
+    m_context.emplace_back(key, value);
+}
+
+//----------------------------------------------------------------------------------------------------
+bool BenchmarkRunner::IsSelected(String const& name) const
+{
+    return m_config.m_filter.empty() || name.find(m_config.m_filter) != String::npos;
+}
+
+//----------------------------------------------------------------------------------------------------
+void BenchmarkRunner::Run(String const&                name,
+                          String const&                mapName,
+                          IntVec2 const&               mapDimensions,
+                          int const                    numEntities,
+                          std::function<void()> const& operation)
+{
+    if (!IsSelected(name)) return;
+
+    using Clock = std::chrono::steady_clock;
+
+    operation();
+
+    HardwareCounterSample countersBefore;
+    HardwareCounterSample countersAfter;
+
+    if (GetCounters()) m_counters->Read(countersBefore);
+
+    int64_t const allocationsBefore = GetNumAllocations();
+    int64_t const bytesBefore       = GetNumAllocatedBytes();
+    int64_t       numIterations     = 0;
+    int64_t       batchSize         = 1;
+    double        elapsedSeconds    = 0.0;
+
+    while (elapsedSeconds < m_config.m_minSecondsPerBenchmark || numIterations < m_config.m_minIterations)
+    {
+        Clock::time_point const batchStart = Clock::now();
+
+        for (int64_t iteration = 0; iteration < batchSize; ++iteration)
+        {
+            operation();
+        }
+
+        elapsedSeconds += std::chrono::duration<double>(Clock::now() - batchStart).count();
+        numIterations  += batchSize;
+        batchSize      *= 2;
+    }
+
+    if (GetCounters()) m_counters->Read(countersAfter);
+
+    BenchmarkResult result;
+
+    result.m_name             = name;
+    result.m_mapName          = mapName;
+    result.m_mapDimensions    = mapDimensions;
+    result.m_numEntities      = numEntities;
+    result.m_numIterations    = numIterations;
+    result.m_nanosecondsPerOp = elapsedSeconds * 1e9 / static_cast<double>(numIterations);
+    result.m_opsPerSecond     = static_cast<double>(numIterations) / elapsedSeconds;
+    result.m_allocationsPerOp = static_cast<double>(GetNumAllocations() - allocationsBefore) / static_cast<double>(numIterations);
+    result.m_bytesPerOp       = static_cast<double>(GetNumAllocatedBytes() - bytesBefore) / static_cast<double>(numIterations);
+
+    if (GetCounters())
+    {
+        HardwareCounterSample counterTotals;
+        counterTotals.AddDifference(countersBefore, countersAfter);
+        result.SetCountersPerOp(counterTotals, numIterations);
+    }
+
+    AddResult(result);
+}
+
+//----------------------------------------------------------------------------------------------------
+void BenchmarkRunner::AddResult(BenchmarkResult const& result)
+{
+    if (m_config.m_isPrintingResults)
+    {
+        printf("%-64s %14.1f ns/op %12.1f op/s %8.2f allocs/op\n",
+               result.m_name.c_str(),
+               result.m_nanosecondsPerOp,
+               result.m_opsPerSecond,
+               result.m_allocationsPerOp);
+    }
+
+    m_results.push_back(result);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Per-op counters as read, plus IPC and, when the benchmark has entities, the misses per entity per op.
+//
+static String GetCountersAsJson(BenchmarkResult const& result)
+{
+    String json;
+
+    for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+    {
+        if (result.m_countersPerOp[counterIndex] < 0.0) continue;
+
+        json += Stringf(", \"%sPerOp\": %.3f", GetHardwareCounterName(static_cast<HardwareCounter>(counterIndex)), result.m_countersPerOp[counterIndex]);
+    }
+
+    double const cyclesPerOp       = result.m_countersPerOp[HARDWARE_COUNTER_CYCLES];
+    double const instructionsPerOp = result.m_countersPerOp[HARDWARE_COUNTER_INSTRUCTIONS];
+
+    if (cyclesPerOp > 0.0 && instructionsPerOp >= 0.0) json += Stringf(", \"ipc\": %.3f", instructionsPerOp / cyclesPerOp);
+
+    if (result.m_numEntities <= 0) return json;
+
+    for (HardwareCounter const counter : {HARDWARE_COUNTER_L1D_READ_MISSES, HARDWARE_COUNTER_LLC_MISSES, HARDWARE_COUNTER_BRANCH_MISSES})
+    {
+        if (result.m_countersPerOp[counter] < 0.0) continue;
+
+        json += Stringf(", \"%sPerEntity\": %.3f", GetHardwareCounterName(counter), result.m_countersPerOp[counter] / static_cast<double>(result.m_numEntities));
+    }
+
+    return json;
+}
+
+//----------------------------------------------------------------------------------------------------
+String BenchmarkRunner::GetResultsAsJson() const
+{
+    String json = "{\n  \"context\": {";
+
+    for (size_t contextIndex = 0; contextIndex < m_context.size(); ++contextIndex)
+    {
+        json += Stringf("%s\"%s\": \"%s\"", contextIndex > 0 ? ", " : "", m_context[contextIndex].first.c_str(), m_context[contextIndex].second.c_str());
+    }
+
+    json += "},\n  \"benchmarks\": [\n";
+
+    for (size_t resultIndex = 0; resultIndex < m_results.size(); ++resultIndex)
+    {
+        BenchmarkResult const& result = m_results[resultIndex];
+
+        json += Stringf("    {\"name\": \"%s\", \"map\": \"%s\", \"mapWidth\": %d, \"mapHeight\": %d, \"entities\": %d, "
+                        "\"iterations\": %lld, \"nsPerOp\": %.3f, \"opsPerSecond\": %.3f, \"allocsPerOp\": %.3f, \"bytesPerOp\": %.3f",
+                        result.m_name.c_str(),
+                        result.m_mapName.c_str(),
+                        result.m_mapDimensions.x,
+                        result.m_mapDimensions.y,
+                        result.m_numEntities,
+                        static_cast<long long>(result.m_numIterations),
+                        result.m_nanosecondsPerOp,
+                        result.m_opsPerSecond,
+                        result.m_allocationsPerOp,
+                        result.m_bytesPerOp);
+
+        if (result.m_maxNanoseconds > 0.0)
+        {
+            json += Stringf(", \"p50Ns\": %.3f, \"p99Ns\": %.3f, \"maxNs\": %.3f", result.m_p50Nanoseconds, result.m_p99Nanoseconds, result.m_maxNanoseconds);
+        }
+
+        json += GetCountersAsJson(result);
+
+        json += resultIndex + 1 < m_results.size() ? "},\n" : "}\n";
+    }
+
+    json += "  ]\n}\n";
+
+    return json;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void SkipJsonWhitespace(String const& json, size_t& cursor)
+{
+    while (cursor < json.size() && (json[cursor] == ' ' || json[cursor] == '\t' || json[cursor] == '\r' || json[cursor] == '\n'))
+    {
+        ++cursor;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool ParseJsonString(String const& json, size_t& cursor, String& outString)
+{
+    SkipJsonWhitespace(json, cursor);
+
+    if (cursor >= json.size() || json[cursor] != '"') return false;
+
+    outString.clear();
+
+    for (++cursor; cursor < json.size(); ++cursor)
+    {
+        if (json[cursor] == '"')
+        {
+            ++cursor;
+            return true;
+        }
+
+        if (json[cursor] == '\\' && cursor + 1 < json.size()) ++cursor;
+
+        outString += json[cursor];
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool ParseJsonNumber(String const& json, size_t& cursor, double& outNumber)
+{
+    SkipJsonWhitespace(json, cursor);
+
+    char const* start = json.c_str() + cursor;
+    char*       end   = nullptr;
+
+    outNumber = std::strtod(start, &end);
+
+    if (end == start) return false;
+
+    cursor += static_cast<size_t>(end - start);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool ExpectJsonCharacter(String const& json, size_t& cursor, char const character)
+{
+    SkipJsonWhitespace(json, cursor);
+
+    if (cursor >= json.size() || json[cursor] != character) return false;
+
+    ++cursor;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Reads back what GetResultsAsJson writes: the "benchmarks" array of flat objects whose values are
+// strings or numbers. Unknown keys are skipped, so older and newer files still load.
+//
+STATIC bool BenchmarkRunner::ParseResultsJson(String const& json, std::vector<BenchmarkResult>& outResults)
+{
+    size_t cursor = json.find("\"benchmarks\"");
+
+    if (cursor == String::npos) return false;
+
+    cursor += 12;
+
+    if (!ExpectJsonCharacter(json, cursor, ':') || !ExpectJsonCharacter(json, cursor, '[')) return false;
+
+    outResults.clear();
+
+    if (ExpectJsonCharacter(json, cursor, ']')) return true;
+
+    do
+    {
+        if (!ExpectJsonCharacter(json, cursor, '{')) return false;
+
+        BenchmarkResult result;
+
+        do
+        {
+            String key;
+            String stringValue;
+            double numberValue = 0.0;
+
+            if (!ParseJsonString(json, cursor, key) || !ExpectJsonCharacter(json, cursor, ':')) return false;
+
+            SkipJsonWhitespace(json, cursor);
+
+            if (cursor < json.size() && json[cursor] == '"')
+            {
+                if (!ParseJsonString(json, cursor, stringValue)) return false;
+            }
+            else if (!ParseJsonNumber(json, cursor, numberValue)) return false;
+
+            if (key == "name") result.m_name = stringValue;
+            else if (key == "map") result.m_mapName = stringValue;
+            else if (key == "mapWidth") result.m_mapDimensions.x = static_cast<int>(numberValue);
+            else if (key == "mapHeight") result.m_mapDimensions.y = static_cast<int>(numberValue);
+            else if (key == "entities") result.m_numEntities = static_cast<int>(numberValue);
+            else if (key == "iterations") result.m_numIterations = static_cast<int64_t>(numberValue);
+            else if (key == "nsPerOp") result.m_nanosecondsPerOp = numberValue;
+            else if (key == "opsPerSecond") result.m_opsPerSecond = numberValue;
+            else if (key == "allocsPerOp") result.m_allocationsPerOp = numberValue;
+            else if (key == "bytesPerOp") result.m_bytesPerOp = numberValue;
+            else if (key == "p50Ns") result.m_p50Nanoseconds = numberValue;
+            else if (key == "p99Ns") result.m_p99Nanoseconds = numberValue;
+            else if (key == "maxNs") result.m_maxNanoseconds = numberValue;
+
+            for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+            {
+                if (key == Stringf("%sPerOp", GetHardwareCounterName(static_cast<HardwareCounter>(counterIndex)))) result.m_countersPerOp[counterIndex] = numberValue;
+            }
+        }
+        while (ExpectJsonCharacter(json, cursor, ','));
+
+        if (!ExpectJsonCharacter(json, cursor, '}')) return false;
+
+        outResults.push_back(result);
+    }
+    while (ExpectJsonCharacter(json, cursor, ','));
+
+    return ExpectJsonCharacter(json, cursor, ']');
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC void BenchmarkRunner::CountAllocation(size_t const numBytes)
+{
+    s_numAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_numAllocatedBytes.fetch_add(static_cast<int64_t>(numBytes), std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int64_t BenchmarkRunner::GetNumAllocations()
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    return AllocationTracker::GetTotalNumAllocations();
+#else
+    return s_numAllocations.load(std::memory_order_relaxed);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int64_t BenchmarkRunner::GetNumAllocatedBytes()
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    return AllocationTracker::GetTotalNumAllocatedBytes();
+#else
+    return s_numAllocatedBytes.load(std::memory_order_relaxed);
+#endif
+}
@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------------------------------
+// BenchmarkRunner.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/HardwareCounters.hpp"
+
+//----------------------------------------------------------------------------------------------------
+struct BenchmarkConfig
+{
+    String m_filter;                            // Only names containing this run; empty runs everything
+    double m_minSecondsPerBenchmark = 0.25;
+    int    m_minIterations          = 3;
+    bool   m_isPrintingResults      = true;     // One line per result as it is added
+    bool   m_isReadingCounters      = false;    // Hardware counters around every timed span (Linux only)
+};
+
+//----------------------------------------------------------------------------------------------------
+struct BenchmarkResult
+{
+    String  m_name;                            // "Group/Case/MapName", unique within a run
+    String  m_mapName;
+    IntVec2 m_mapDimensions    = IntVec2::ZERO;
+    int     m_numEntities      = 0;
+    int64_t m_numIterations    = 0;
+    double  m_nanosecondsPerOp = 0.0;
+    double  m_opsPerSecond     = 0.0;
+    double  m_allocationsPerOp = 0.0;
+    double  m_bytesPerOp       = 0.0;
+    double  m_p50Nanoseconds   = 0.0;          // Distribution fields are only filled by runs that
+    double  m_p99Nanoseconds   = 0.0;          // time every iteration on its own (scenarios)
+    double  m_maxNanoseconds   = 0.0;
+    double  m_countersPerOp[NUM_HARDWARE_COUNTERS] = {-1.0, -1.0, -1.0, -1.0, -1.0};     // -1 where not read
+
+    void SetCountersPerOp(HardwareCounterSample const& totals, int64_t numOps);
+};
+
+//----------------------------------------------------------------------------------------------------
+// Times one operation at a time. Each benchmark runs once to warm caches, then in doubling batches
+// until it has run for at least m_minSecondsPerBenchmark; heap allocations made on any thread
+// during the timed batches are counted and divided by the iteration count.
+//
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(BenchmarkConfig const& config);
+
+    void SetContextValue(String const& key, String const& value);
+    bool IsSelected(String const& name) const;
+    void Run(String const& name, String const& mapName, IntVec2 const& mapDimensions, int numEntities, std::function<void()> const& operation);
+    void AddResult(BenchmarkResult const& result);
+
+    HardwareCounterGroup const* GetCounters() const { return m_counters && m_counters->IsAvailable() ? m_counters.get() : nullptr; }
+    String                      GetCountersDescription() const;
+
+    std::vector<BenchmarkResult> const& GetResults() const { return m_results; }
+    String                              GetResultsAsJson() const;
+
+    static bool    ParseResultsJson(String const& json, std::vector<BenchmarkResult>& outResults);
+
+    static void    CountAllocation(size_t numBytes);
+    static int64_t GetNumAllocations();
+    static int64_t GetNumAllocatedBytes();
+
+private:
+    BenchmarkConfig                        m_config;
+    std::vector<std::pair<String, String>> m_context;
+    std::vector<BenchmarkResult>           m_results;
+    std::unique_ptr<HardwareCounterGroup>  m_counters;     // Opened on the constructing thread when asked for
+};
@@ -0,0 +1,232 @@
+//----------------------------------------------------------------------------------------------------
+// Main_Benchmark.cpp
+//
+// Benchmark.exe [--filter=Substring] [--min-time=Seconds] [--out=Results.json]
+//               [--suite=micro|scenario|all|check] [--scenarios=Data/Definitions/BenchmarkScenarios.xml]
+//               [--repeat=N] [--baseline=Baseline.json [--update-baseline]] [--gate=Data/Definitions/BenchmarkGate.xml]
+//               [--counters]
+//
+// Exits 0 on success, 1 when a file cannot be read or written, 2 on bad arguments, 3 when the run
+// regresses against the baseline in a gated group and 4 when --suite=check finds a mismatch.
+// --suite=check times nothing: it checks the visible set against direct shadowcasting and exits.
+// --counters adds hardware counters per op where perf_event_open allows it (Linux).
+// Run from the Run/ folder so Data/ resolves, the same as the game.
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Benchmark/MapBenchmark.hpp"
+#include "Benchmark/RegressionGate.hpp"
+#include "Benchmark/ScenarioRunner.hpp"
+#include "Benchmark/VisibilityCheck.hpp"
+#include "Game/App.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/TileMasks.hpp"
+#include "Game/WorkerPool.hpp"
+
+//----------------------------------------------------------------------------------------------------
+static bool ParseArgument(char const* argument, char const* prefix, String& outValue)
+{
+    String const argumentString = argument;
+    String const prefixString   = prefix;
+
+    if (argumentString.compare(0, prefixString.size(), prefixString) != 0) return false;
+
+    outValue = argumentString.substr(prefixString.size());
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool WriteTextFile(String const& filePath, String const& text)
+{
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    file << text;
+    file.close();
+
+    return static_cast<bool>(file);
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool ReadTextFile(String const& filePath, String& outText)
+{
+    std::ifstream file(filePath, std::ios::in);
+
+    if (!file) return false;
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    outText = stream.str();
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool RunSuites(BenchmarkRunner& runner, String const& suite, String const& scenariosPath)
+{
+    bool areScenariosLoaded = true;
+
+    if (suite != "scenario")
+    {
+        MapBenchmark mapBenchmark(runner);
+        mapBenchmark.RunAll();
+    }
+
+    if (suite != "micro")
+    {
+        ScenarioRunner scenarioRunner(runner);
+        areScenariosLoaded = scenarioRunner.RunAll(scenariosPath);
+    }
+
+    return areScenariosLoaded;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Boots the same engine and game the player gets (entities load their textures and sounds through
+// it), then runs the suites in place of the main loop. With more than one repeat, the results
+// written (and compared or stored as the baseline) are per-metric medians across the repeats.
+//
+int main(int const argc, char* argv[])
+{
+    BenchmarkConfig config;
+    String          outputPath       = "BenchmarkResults.json";
+    String          suite            = "all";
+    String          scenariosPath    = "Data/Definitions/BenchmarkScenarios.xml";
+    String          baselinePath;
+    String          gatePath         = "Data/Definitions/BenchmarkGate.xml";
+    int             numRepeats       = 0;
+    bool            isUpdateBaseline = false;
+
+    for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+    {
+        String value;
+
+        if (ParseArgument(argv[argumentIndex], "--filter=", value)) config.m_filter = value;
+        else if (ParseArgument(argv[argumentIndex], "--min-time=", value)) config.m_minSecondsPerBenchmark = std::atof(value.c_str());
+        else if (ParseArgument(argv[argumentIndex], "--out=", value)) outputPath = value;
+        else if (ParseArgument(argv[argumentIndex], "--suite=", value)) suite = value;
+        else if (ParseArgument(argv[argumentIndex], "--scenarios=", value)) scenariosPath = value;
+        else if (ParseArgument(argv[argumentIndex], "--repeat=", value)) numRepeats = std::atoi(value.c_str());
+        else if (ParseArgument(argv[argumentIndex], "--baseline=", value)) baselinePath = value;
+        else if (ParseArgument(argv[argumentIndex], "--gate=", value)) gatePath = value;
+        else if (String(argv[argumentIndex]) == "--update-baseline") isUpdateBaseline = true;
+        else if (String(argv[argumentIndex]) == "--counters") config.m_isReadingCounters = true;
+        else
+        {
+            printf("Unknown argument \"%s\"\nUsage: Benchmark [--filter=Substring] [--min-time=Seconds] [--out=Results.json] [--suite=micro|scenario|all|check] [--scenarios=File.xml] "
+                   "[--repeat=N] [--baseline=Baseline.json [--update-baseline]] [--gate=File.xml] [--counters]\n", argv[argumentIndex]);
+            return 2;
+        }
+    }
+
+    if (suite != "micro" && suite != "scenario" && suite != "all" && suite != "check")
+    {
+        printf("Unknown suite \"%s\"; expected micro, scenario, all or check\n", suite.c_str());
+        return 2;
+    }
+
+    if (isUpdateBaseline && baselinePath.empty())
+    {
+        printf("--update-baseline needs --baseline=Path.json\n");
+        return 2;
+    }
+
+    RegressionGate               gate;
+    std::vector<BenchmarkResult> baseline;
+    bool const                   isComparing = !baselinePath.empty() && !isUpdateBaseline;
+
+    if (!baselinePath.empty() && !gate.LoadConfig(gatePath)) return 1;
+
+    if (isComparing)
+    {
+        String baselineJson;
+
+        if (!ReadTextFile(baselinePath, baselineJson) || !BenchmarkRunner::ParseResultsJson(baselineJson, baseline))
+        {
+            printf("Could not read baseline %s; record one on the reference machine with --update-baseline\n", baselinePath.c_str());
+            return 1;
+        }
+    }
+
+    if (numRepeats <= 0) numRepeats = baselinePath.empty() ? 1 : gate.GetNumRepeats();
+
+    g_theApp = new App();
+    g_theApp->Startup();
+
+    if (suite == "check")
+    {
+        VisibilityCheck visibilityCheck;
+        bool const      isPassed = visibilityCheck.RunAll();
+
+        g_theApp->Shutdown();
+        delete g_theApp;
+        g_theApp = nullptr;
+
+        return isPassed ? 0 : 4;
+    }
+
+    std::vector<std::vector<BenchmarkResult>> runs;
+    bool                                      areScenariosLoaded = true;
+
+    for (int repeatIndex = 0; repeatIndex < numRepeats; ++repeatIndex)
+    {
+        if (numRepeats > 1) printf("Run %d of %d\n", repeatIndex + 1, numRepeats);
+
+        BenchmarkRunner runner(config);
+        areScenariosLoaded = RunSuites(runner, suite, scenariosPath) && areScenariosLoaded;
+        runs.push_back(runner.GetResults());
+    }
+
+    BenchmarkConfig summaryConfig = config;
+
+    summaryConfig.m_isPrintingResults = numRepeats > 1;
+
+    BenchmarkRunner summary(summaryConfig);
+
+    summary.SetContextValue("tileMaskKernel", GetTileMaskKernelName());
+    summary.SetContextValue("workerThreads", Stringf("%d", g_theWorkerPool->GetNumWorkerThreads()));
+    summary.SetContextValue("repeats", Stringf("%d", numRepeats));
+    summary.SetContextValue("hardwareCounters", summary.GetCountersDescription());
+
+    if (numRepeats > 1) printf("Medians of %d runs\n", numRepeats);
+
+    for (BenchmarkResult const& result : numRepeats > 1 ? RegressionGate::GetMedianResults(runs) : runs.front())
+    {
+        summary.AddResult(result);
+    }
+
+    String const resultsJson = summary.GetResultsAsJson();
+    bool         isWritten   = WriteTextFile(outputPath, resultsJson);
+
+    printf(isWritten ? "Wrote %d results to %s\n" : "Could not write %d results to %s\n", static_cast<int>(summary.GetResults().size()), outputPath.c_str());
+
+    if (isUpdateBaseline)
+    {
+        bool const isBaselineWritten = WriteTextFile(baselinePath, resultsJson);
+
+        printf(isBaselineWritten ? "Wrote baseline %s\n" : "Could not write baseline %s\n", baselinePath.c_str());
+        isWritten = isWritten && isBaselineWritten;
+    }
+
+    int numGatedRegressions = 0;
+
+    if (isComparing)
+    {
+        printf("Comparing against %s\n", baselinePath.c_str());
+        numGatedRegressions = gate.Compare(baseline, summary.GetResults());
+        printf(numGatedRegressions > 0 ? "FAILED: %d regressions or missing results in gated groups\n" : "PASSED: %d regressions or missing results in gated groups\n", numGatedRegressions);
+    }
+
+    g_theApp->Shutdown();
+    delete g_theApp;
+    g_theApp = nullptr;
+
+    if (!isWritten || !areScenariosLoaded) return 1;
+
+    return numGatedRegressions > 0 ? 3 : 0;
+}
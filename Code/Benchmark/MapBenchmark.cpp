@@ -0,0 +1,329 @@
+//----------------------------------------------------------------------------------------------------
+// MapBenchmark.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Benchmark/MapBenchmark.hpp"
+
+#include <algorithm>
+
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/PathArena.hpp"
+#include "Game/TileDistanceField.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Inputs are rolled up front and cycled, so the timed loop measures the query and not the RNG.
+//
+static constexpr int NUM_QUERY_INPUTS = 256;
+
+//----------------------------------------------------------------------------------------------------
+// Results are folded in here so the optimizer cannot drop a query whose answer is unused.
+//
+static volatile int s_resultSink = 0;
+
+//----------------------------------------------------------------------------------------------------
+// The names each Run* function times, less the map suffix, so a map the filter leaves nothing to run
+// on is never built. Keep them in step with the m_runner.Run calls below.
+//
+static std::vector<char const*> const s_queryBenchmarkNames = {
+    "Raycast/RaycastVsTiles",
+    "Raycast/HasLineOfSight",
+    "Raycast/HasLineOfSightByPvs",
+    "DistanceField/PopulateDistanceField",
+    "DistanceField/PopulateDistanceFieldForEntity",
+    "DistanceField/PopulateDistanceFieldForLandBased",
+    "DistanceField/PopulateDistanceFieldForAmphibian",
+    "DistanceField/PopulateDistanceFieldToPosition",
+    "Pathfinding/GenerateEntityPathToGoal",
+    "Pathfinding/RollRandomTraversableTileCoords",
+};
+static std::vector<char const*> const s_collisionBenchmarkNames = {
+    "Collision/PushEntitiesOutOfEachOther",
+    "Collision/CheckEntityVsEntityCollision",
+    "Collision/PushEntitiesOutOfWalls",
+};
+static std::vector<char const*> const s_generationBenchmarkNames = {
+    "Generation/GenerateAllTiles",
+};
+
+//----------------------------------------------------------------------------------------------------
+MapBenchmark::MapBenchmark(BenchmarkRunner& runner)
+    : m_runner(runner)
+{
+}
+
+//----------------------------------------------------------------------------------------------------
+MapBenchmark::~MapBenchmark()
+{
+    for (MapDefinition const* mapDef : m_syntheticMapDefs)
+    {
+        delete mapDef;
+    }
+
+    m_syntheticMapDefs.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+void MapBenchmark::RunAll()
+{
+    std::vector<MapDefinition const*> mapDefs(MapDefinition::s_mapDefinitions.begin(), MapDefinition::s_mapDefinitions.end());
+
+    for (IntVec2 const& dimensions : {IntVec2(64, 64), IntVec2(128, 128), IntVec2(256, 256)})
+    {
+        mapDefs.push_back(CreateSyntheticMapDefinition(dimensions));
+    }
+
+    // Building a map spawns NPCs, floods its distance fields and draws its seed from g_theRNG, so a
+    // filtered run from the dev console only builds the maps it times
+    for (MapDefinition const* mapDef : mapDefs)
+    {
+        bool const isQuerySelected      = IsAnySelected(s_queryBenchmarkNames, mapDef->GetName());
+        bool const isGenerationSelected = IsAnySelected(s_generationBenchmarkNames, mapDef->GetName());
+
+        if (!isQuerySelected && !isGenerationSelected) continue;
+
+        Map* map = new Map(*mapDef);
+
+        if (isQuerySelected) RunQueryBenchmarks(*map, mapDef->GetName());
+        if (isGenerationSelected) RunGenerationBenchmarks(*map, mapDef->GetName());
+
+        delete map;
+    }
+
+    MapDefinition const* collisionMapDef = m_syntheticMapDefs.front();
+
+    for (int const numAgents : {100, 400, 1600})
+    {
+        RunCollisionBenchmarks(*collisionMapDef, numAgents);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+void MapBenchmark::RunQueryBenchmarks(Map& map, String const& mapName)
+{
+    IntVec2 const              dimensions  = map.GetMapDimension();
+    int const                  numEntities = GetNumEntities(map);
+    std::vector<IntVec2> const traversable = GetTraversableTileCoords(map);
+
+    if (traversable.size() < 2) return;
+
+    std::vector<IntVec2> startCoords(NUM_QUERY_INPUTS);
+    std::vector<IntVec2> goalCoords(NUM_QUERY_INPUTS);
+    std::vector<Ray2>    rays;
+
+    rays.reserve(NUM_QUERY_INPUTS);
+
+    for (int inputIndex = 0; inputIndex < NUM_QUERY_INPUTS; ++inputIndex)
+    {
+        startCoords[inputIndex] = traversable[g_theRNG->RollRandomIntInRange(0, static_cast<int>(traversable.size()) - 1)];
+        goalCoords[inputIndex]  = traversable[g_theRNG->RollRandomIntInRange(0, static_cast<int>(traversable.size()) - 1)];
+
+        Vec2 const  start   = map.GetWorldPosFromTileCoords(startCoords[inputIndex]);
+        float const degrees = g_theRNG->RollRandomFloatInRange(0.f, 360.f);
+
+        rays.emplace_back(start, Vec2(CosDegrees(degrees), SinDegrees(degrees)), 8.f);
+    }
+
+    TileDistanceField field(dimensions);
+    PathCorridor*     corridor   = map.AcquirePathCorridor();
+    int               inputIndex = 0;
+
+    auto const nextInput = [&inputIndex]
+    {
+        inputIndex = (inputIndex + 1) % NUM_QUERY_INPUTS;
+        return inputIndex;
+    };
+
+    m_runner.Run("Raycast/RaycastVsTiles/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        s_resultSink = s_resultSink + (map.RaycastVsTiles(rays[nextInput()]).m_didImpact ? 1 : 0);
+    });
+
+    m_runner.Run("Raycast/HasLineOfSight/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        int const index = nextInput();
+        s_resultSink    = s_resultSink + (map.HasLineOfSight(map.GetWorldPosFromTileCoords(startCoords[index]), map.GetWorldPosFromTileCoords(goalCoords[index]), 10.f) ? 1 : 0);
+    });
+
+    // The game ships with mapPvsEnabled off, so the visible set is built here to time the queries it answers
+    if (!map.m_potentiallyVisibleSet.IsBuilt() && m_runner.IsSelected("Raycast/HasLineOfSightByPvs/" + mapName)) map.BuildPotentiallyVisibleSet();
+
+    if (map.m_potentiallyVisibleSet.IsBuilt())
+    {
+        m_runner.Run("Raycast/HasLineOfSightByPvs/" + mapName, mapName, dimensions, numEntities, [&]
+        {
+            int const index = nextInput();
+            s_resultSink    = s_resultSink + (map.HasLineOfSight(map.GetWorldPosFromTileCoords(startCoords[index]), map.GetWorldPosFromTileCoords(goalCoords[index]), 10.f) ? 1 : 0);
+        });
+    }
+
+    m_runner.Run("DistanceField/PopulateDistanceField/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        map.PopulateDistanceField(field, startCoords[nextInput()]);
+    });
+
+    m_runner.Run("DistanceField/PopulateDistanceFieldForEntity/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        map.PopulateDistanceFieldForEntity(field, startCoords[nextInput()]);
+    });
+
+    m_runner.Run("DistanceField/PopulateDistanceFieldForLandBased/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        map.PopulateDistanceFieldForLandBased(field);
+    });
+
+    m_runner.Run("DistanceField/PopulateDistanceFieldForAmphibian/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        map.PopulateDistanceFieldForAmphibian(field);
+    });
+
+    m_runner.Run("DistanceField/PopulateDistanceFieldToPosition/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        map.PopulateDistanceFieldToPosition(field, goalCoords[nextInput()]);
+    });
+
+    m_runner.Run("Pathfinding/GenerateEntityPathToGoal/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        int const index = nextInput();
+        map.GenerateEntityPathToGoal(field, map.GetWorldPosFromTileCoords(startCoords[index]), map.GetWorldPosFromTileCoords(goalCoords[index]), *corridor);
+        s_resultSink = s_resultSink + corridor->GetNumPoints();
+    });
+
+    m_runner.Run("Pathfinding/RollRandomTraversableTileCoords/" + mapName, mapName, dimensions, numEntities, [&]
+    {
+        s_resultSink = s_resultSink + map.RollRandomTraversableTileCoords(startCoords[nextInput()]).x;
+    });
+}
+
+//----------------------------------------------------------------------------------------------------
+// Agents are Leos scattered over open tiles, plus a quarter as many bullets. Every spawned entity is
+// evil, so overlaps are found and tested but never deal damage or play sounds; the passes cost the
+// same either way.
+//
+void MapBenchmark::RunCollisionBenchmarks(MapDefinition const& mapDef, int const numAgents)
+{
+    String const mapName = Stringf("%s_n%d", mapDef.GetName().c_str(), numAgents);
+
+    if (!IsAnySelected(s_collisionBenchmarkNames, mapName)) return;
+
+    Map*                       map         = new Map(mapDef);
+    std::vector<IntVec2> const traversable = GetTraversableTileCoords(*map);
+
+    for (int agentIndex = 0; agentIndex < numAgents + numAgents / 4 && !traversable.empty(); ++agentIndex)
+    {
+        IntVec2 const    coords   = traversable[g_theRNG->RollRandomIntInRange(0, static_cast<int>(traversable.size()) - 1)];
+        Vec2 const       position = map->GetWorldPosFromTileCoords(coords) + Vec2(g_theRNG->RollRandomFloatInRange(-0.3f, 0.3f), g_theRNG->RollRandomFloatInRange(-0.3f, 0.3f));
+        EntityType const type     = agentIndex < numAgents ? ENTITY_TYPE_LEO : ENTITY_TYPE_BULLET;
+
+        map->SpawnNewEntity(type, ENTITY_FACTION_EVIL, position, g_theRNG->RollRandomFloatInRange(0.f, 360.f));
+    }
+
+    IntVec2 const dimensions  = map->GetMapDimension();
+    int const     numEntities = GetNumEntities(*map);
+
+    m_runner.Run("Collision/PushEntitiesOutOfEachOther/" + mapName, mapName, dimensions, numEntities, [map]
+    {
+        map->PushEntitiesOutOfEachOther(map->m_allEntities, map->m_allEntities);
+    });
+
+    m_runner.Run("Collision/CheckEntityVsEntityCollision/" + mapName, mapName, dimensions, numEntities, [map]
+    {
+        map->CheckEntityVsEntityCollision(map->m_entitiesByType[ENTITY_TYPE_BULLET], map->m_allEntities);
+    });
+
+    m_runner.Run("Collision/PushEntitiesOutOfWalls/" + mapName, mapName, dimensions, numEntities, [map]
+    {
+        map->PushEntitiesOutOfWalls();
+    });
+
+    delete map;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Regenerating rewrites the tiles under the map's entities and distance fields, so this runs last.
+//
+void MapBenchmark::RunGenerationBenchmarks(Map& map, String const& mapName)
+{
+    m_runner.Run("Generation/GenerateAllTiles/" + mapName, mapName, map.GetMapDimension(), GetNumEntities(map), [&map]
+    {
+        map.GenerateAllTiles();
+    });
+}
+
+//----------------------------------------------------------------------------------------------------
+// Worm counts scale with area from Map02's density; spawn rates stay low so NPC placement, which is
+// quadratic in the entity count, does not dominate setup on the largest maps.
+//
+MapDefinition const* MapBenchmark::CreateSyntheticMapDefinition(IntVec2 const& dimensions)
+{
+    float const  areaScale = static_cast<float>(dimensions.x * dimensions.y) / 1000.f;
+    String const xml       = Stringf("<MapDefinition name=\"Synthetic%03dx%03d\" index=\"%d\" "
+                                     "worm01TileName=\"Grass\" worm01Num=\"%d\" worm01Length=\"50\" "
+                                     "worm02TileName=\"Sparkle_01\" worm02Num=\"%d\" worm02Length=\"30\" "
+                                     "worm03TileName=\"Water\" worm03Num=\"%d\" worm03Length=\"30\" "
+                                     "scorpioSpawnPercentage=\"0.02\" leoSpawnPercentage=\"0.02\" ariesSpawnPercentage=\"0.02\" "
+                                     "dimensions=\"%d,%d\"/>",
+                                     dimensions.x,
+                                     dimensions.y,
+                                     100 + static_cast<int>(m_syntheticMapDefs.size()),
+                                     static_cast<int>(30.f * areaScale),
+                                     static_cast<int>(15.f * areaScale),
+                                     static_cast<int>(15.f * areaScale),
+                                     dimensions.x,
+                                     dimensions.y);
+
+    XmlDocument mapDefXml;
+
+    if (mapDefXml.Parse(xml.c_str()) != XmlResult::XML_SUCCESS)
+    {
+        ERROR_AND_DIE("MapBenchmark: synthetic map definition did not parse")
+    }
+
+    MapDefinition* mapDef = new MapDefinition(*mapDefXml.RootElement());
+    m_syntheticMapDefs.push_back(mapDef);
+
+    return mapDef;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool MapBenchmark::IsAnySelected(std::vector<char const*> const& benchmarkNames, String const& mapName) const
+{
+    for (char const* benchmarkName : benchmarkNames)
+    {
+        if (m_runner.IsSelected(String(benchmarkName) + "/" + mapName)) return true;
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------
+std::vector<IntVec2> MapBenchmark::GetTraversableTileCoords(Map const& map) const
+{
+    std::vector<IntVec2> traversable;
+    IntVec2 const        dimensions = map.GetMapDimension();
+
+    for (int tileY = 0; tileY < dimensions.y; ++tileY)
+    {
+        for (int tileX = 0; tileX < dimensions.x; ++tileX)
+        {
+            IntVec2 const coords(tileX, tileY);
+
+            if (!map.IsTileSolid(coords) && !map.IsTileWater(coords)) traversable.push_back(coords);
+        }
+    }
+
+    return traversable;
+}
+
+//----------------------------------------------------------------------------------------------------
+int MapBenchmark::GetNumEntities(Map const& map) const
+{
+    return static_cast<int>(map.m_allEntities.size());
+}
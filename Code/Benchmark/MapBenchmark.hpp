@@ -0,0 +1,42 @@
+//----------------------------------------------------------------------------------------------------
+// MapBenchmark.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <vector>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class BenchmarkRunner;
+class Map;
+struct MapDefinition;
+
+//----------------------------------------------------------------------------------------------------
+// Times the Map hot paths (raycasts, line of sight, distance fields, pathing, map generation and the
+// collision passes) on every map in MapDefinitions.xml plus larger synthetic maps. A friend of Map,
+// so private phases are timed on their own.
+//
+class MapBenchmark
+{
+public:
+    explicit MapBenchmark(BenchmarkRunner& runner);
+    ~MapBenchmark();
+
+    void RunAll();
+
+private:
+    void RunQueryBenchmarks(Map& map, String const& mapName);
+    void RunCollisionBenchmarks(MapDefinition const& mapDef, int numAgents);
+    void RunGenerationBenchmarks(Map& map, String const& mapName);
+
+    MapDefinition const* CreateSyntheticMapDefinition(IntVec2 const& dimensions);
+    bool                 IsAnySelected(std::vector<char const*> const& benchmarkNames, String const& mapName) const;
+    std::vector<IntVec2> GetTraversableTileCoords(Map const& map) const;
+    int                  GetNumEntities(Map const& map) const;
+
+    BenchmarkRunner&            m_runner;
+    std::vector<MapDefinition*> m_syntheticMapDefs;
+};
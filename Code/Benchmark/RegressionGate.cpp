@@ -0,0 +1,250 @@
+//----------------------------------------------------------------------------------------------------
+// RegressionGate.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Benchmark/RegressionGate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Returns false for a metric name the results do not carry.
+//
+static bool GetMetricValue(BenchmarkResult const& result, String const& metric, double& outValue)
+{
+    if (metric == "nsPerOp") outValue = result.m_nanosecondsPerOp;
+    else if (metric == "p50Ns") outValue = result.m_p50Nanoseconds;
+    else if (metric == "p99Ns") outValue = result.m_p99Nanoseconds;
+    else if (metric == "maxNs") outValue = result.m_maxNanoseconds;
+    else if (metric == "allocsPerOp") outValue = result.m_allocationsPerOp;
+    else if (metric == "bytesPerOp") outValue = result.m_bytesPerOp;
+    else
+    {
+        for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+        {
+            if (metric != Stringf("%sPerOp", GetHardwareCounterName(static_cast<HardwareCounter>(counterIndex)))) continue;
+
+            outValue = result.m_countersPerOp[counterIndex];
+            return true;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+static double GetMedian(std::vector<double>& values)
+{
+    if (values.empty()) return 0.0;
+
+    std::sort(values.begin(), values.end());
+
+    size_t const middle = values.size() / 2;
+
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5;
+}
+
+//----------------------------------------------------------------------------------------------------
+static BenchmarkResult const* FindResultByName(std::vector<BenchmarkResult> const& results, String const& name)
+{
+    for (BenchmarkResult const& result : results)
+    {
+        if (result.m_name == name) return &result;
+    }
+
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool RegressionGate::LoadConfig(String const& configPath)
+{
+    XmlDocument configXml;
+
+    if (configXml.LoadFile(configPath.c_str()) != XmlResult::XML_SUCCESS)
+    {
+        printf("RegressionGate: could not load %s\n", configPath.c_str());
+        return false;
+    }
+
+    XmlElement const* root = configXml.FirstChildElement("BenchmarkGate");
+
+    if (!root)
+    {
+        printf("RegressionGate: %s has no <BenchmarkGate> root\n", configPath.c_str());
+        return false;
+    }
+
+    m_numRepeats = std::max(1, ParseXmlAttribute(*root, "repeats", m_numRepeats));
+    m_thresholds.clear();
+    m_gatedGroups.clear();
+
+    for (XmlElement const* element = root->FirstChildElement("Threshold"); element != nullptr; element = element->NextSiblingElement("Threshold"))
+    {
+        RegressionThreshold threshold;
+
+        threshold.m_metric             = ParseXmlAttribute(*element, "metric", "nsPerOp");
+        threshold.m_maxIncreasePercent = ParseXmlAttribute(*element, "maxIncreasePercent", threshold.m_maxIncreasePercent);
+        threshold.m_minIncrease        = ParseXmlAttribute(*element, "minIncrease", threshold.m_minIncrease);
+
+        double unusedValue = 0.0;
+
+        if (!GetMetricValue(BenchmarkResult(), threshold.m_metric, unusedValue))
+        {
+            printf("RegressionGate: unknown metric \"%s\" in %s\n", threshold.m_metric.c_str(), configPath.c_str());
+            return false;
+        }
+
+        m_thresholds.push_back(threshold);
+    }
+
+    for (XmlElement const* element = root->FirstChildElement("GatedGroup"); element != nullptr; element = element->NextSiblingElement("GatedGroup"))
+    {
+        m_gatedGroups.push_back(ParseXmlAttribute(*element, "prefix", ""));
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Prints one line per regression, improvement past the same limits, and benchmark that exists on only
+// one side. Returns how many regressions fall in a gated group; a gated benchmark that no longer
+// reports a result counts as one, so losing a measurement can never pass the gate.
+//
+int RegressionGate::Compare(std::vector<BenchmarkResult> const& baseline, std::vector<BenchmarkResult> const& current) const
+{
+    int numGatedRegressions = 0;
+
+    for (BenchmarkResult const& baselineResult : baseline)
+    {
+        BenchmarkResult const* currentResult = FindResultByName(current, baselineResult.m_name);
+
+        bool const isGated = IsGated(baselineResult.m_name);
+
+        if (!currentResult)
+        {
+            printf("  MISSING     %s (in the baseline, not in this run)\n", baselineResult.m_name.c_str());
+
+            if (isGated) ++numGatedRegressions;
+
+            continue;
+        }
+
+        for (RegressionThreshold const& threshold : m_thresholds)
+        {
+            double baselineValue = 0.0;
+            double currentValue  = 0.0;
+
+            GetMetricValue(baselineResult, threshold.m_metric, baselineValue);
+            GetMetricValue(*currentResult, threshold.m_metric, currentValue);
+
+            // Hardware counters read -1 on runs that did not read them
+            if (baselineValue < 0.0 || currentValue < 0.0) continue;
+
+            double const increase        = currentValue - baselineValue;
+            double const percentIncrease = baselineValue > 0.0 ? increase * 100.0 / baselineValue : (increase > 0.0 ? 100.0 : 0.0);
+            bool const   isPastMinimum   = std::abs(increase) > static_cast<double>(threshold.m_minIncrease);
+
+            if (!isPastMinimum || std::abs(percentIncrease) <= static_cast<double>(threshold.m_maxIncreasePercent)) continue;
+
+            char const* verdict = increase < 0.0 ? "IMPROVED   " : isGated ? "REGRESSION " : "SLOWER     ";
+
+            printf("  %s %s %s: %.3f -> %.3f (%+.1f%%, limit %.1f%%)\n",
+                   verdict,
+                   baselineResult.m_name.c_str(),
+                   threshold.m_metric.c_str(),
+                   baselineValue,
+                   currentValue,
+                   percentIncrease,
+                   threshold.m_maxIncreasePercent);
+
+            if (increase > 0.0 && isGated) ++numGatedRegressions;
+        }
+    }
+
+    for (BenchmarkResult const& currentResult : current)
+    {
+        if (!FindResultByName(baseline, currentResult.m_name))
+        {
+            printf("  NEW         %s (not in the baseline)\n", currentResult.m_name.c_str());
+        }
+    }
+
+    return numGatedRegressions;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Every metric is the median of that metric across runs, taken on its own. Benchmarks are matched by
+// name and kept in the first run's order.
+//
+STATIC std::vector<BenchmarkResult> RegressionGate::GetMedianResults(std::vector<std::vector<BenchmarkResult>> const& runs)
+{
+    std::vector<BenchmarkResult> medians;
+
+    if (runs.empty()) return medians;
+
+    for (BenchmarkResult const& firstResult : runs.front())
+    {
+        std::vector<BenchmarkResult const*> samples;
+
+        for (std::vector<BenchmarkResult> const& run : runs)
+        {
+            if (BenchmarkResult const* result = FindResultByName(run, firstResult.m_name)) samples.push_back(result);
+        }
+
+        auto const medianOf = [&samples](double BenchmarkResult::* field)
+        {
+            std::vector<double> values;
+
+            for (BenchmarkResult const* sample : samples)
+            {
+                values.push_back(sample->*field);
+            }
+
+            return GetMedian(values);
+        };
+
+        BenchmarkResult median = firstResult;
+
+        median.m_nanosecondsPerOp = medianOf(&BenchmarkResult::m_nanosecondsPerOp);
+        median.m_opsPerSecond     = medianOf(&BenchmarkResult::m_opsPerSecond);
+        median.m_allocationsPerOp = medianOf(&BenchmarkResult::m_allocationsPerOp);
+        median.m_bytesPerOp       = medianOf(&BenchmarkResult::m_bytesPerOp);
+        median.m_p50Nanoseconds   = medianOf(&BenchmarkResult::m_p50Nanoseconds);
+        median.m_p99Nanoseconds   = medianOf(&BenchmarkResult::m_p99Nanoseconds);
+        median.m_maxNanoseconds   = medianOf(&BenchmarkResult::m_maxNanoseconds);
+
+        for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+        {
+            std::vector<double> values;
+
+            for (BenchmarkResult const* sample : samples)
+            {
+                values.push_back(sample->m_countersPerOp[counterIndex]);
+            }
+
+            median.m_countersPerOp[counterIndex] = GetMedian(values);
+        }
+
+        medians.push_back(median);
+    }
+
+    return medians;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool RegressionGate::IsGated(String const& name) const
+{
+    for (String const& prefix : m_gatedGroups)
+    {
+        if (name.compare(0, prefix.size(), prefix) == 0) return true;
+    }
+
+    return false;
+}
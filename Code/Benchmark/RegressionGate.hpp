@@ -0,0 +1,42 @@
+//----------------------------------------------------------------------------------------------------
+// RegressionGate.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <vector>
+
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// A metric regresses when it grows by more than m_maxIncreasePercent of the baseline AND by more than
+// m_minIncrease in absolute terms, so near-zero baselines do not trip on noise.
+//
+struct RegressionThreshold
+{
+    String m_metric;                           // A BenchmarkResult JSON key: nsPerOp, p99Ns, allocsPerOp...
+    float  m_maxIncreasePercent = 10.f;
+    float  m_minIncrease        = 0.f;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Compares the median of repeated benchmark runs against a stored baseline, per the thresholds and
+// gated groups in BenchmarkGate.xml. Benchmarks outside the gated groups are reported but never fail.
+//
+class RegressionGate
+{
+public:
+    bool LoadConfig(String const& configPath);
+    int  GetNumRepeats() const { return m_numRepeats; }
+    int  Compare(std::vector<BenchmarkResult> const& baseline, std::vector<BenchmarkResult> const& current) const;
+
+    static std::vector<BenchmarkResult> GetMedianResults(std::vector<std::vector<BenchmarkResult>> const& runs);
+
+private:
+    bool IsGated(String const& name) const;
+
+    int                              m_numRepeats = 5;
+    std::vector<RegressionThreshold> m_thresholds;
+    std::vector<String>              m_gatedGroups;     // Name prefixes, e.g. "Simulation/"
+};
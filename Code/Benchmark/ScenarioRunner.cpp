@@ -0,0 +1,378 @@
+//----------------------------------------------------------------------------------------------------
+// ScenarioRunner.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Benchmark/ScenarioRunner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Game/Entity.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/MapDefinition.hpp"
+
+//----------------------------------------------------------------------------------------------------
+BenchmarkScenario::BenchmarkScenario(XmlElement const& scenarioElement)
+{
+    m_name              = ParseXmlAttribute(scenarioElement, "name", "Unnamed");
+    m_mapDefName        = ParseXmlAttribute(scenarioElement, "mapDefinition", "Map01");
+    m_seed              = ParseXmlAttribute(scenarioElement, "seed", m_seed);
+    m_scorpioCount      = ParseXmlAttribute(scenarioElement, "scorpioCount", m_scorpioCount);
+    m_leoCount          = ParseXmlAttribute(scenarioElement, "leoCount", m_leoCount);
+    m_ariesCount        = ParseXmlAttribute(scenarioElement, "ariesCount", m_ariesCount);
+    m_capricornCount    = ParseXmlAttribute(scenarioElement, "capricornCount", m_capricornCount);
+    m_bulletsPerSecond  = ParseXmlAttribute(scenarioElement, "bulletsPerSecond", m_bulletsPerSecond);
+    m_durationSeconds   = ParseXmlAttribute(scenarioElement, "durationSeconds", m_durationSeconds);
+    m_fixedDeltaSeconds = ParseXmlAttribute(scenarioElement, "fixedDeltaSeconds", m_fixedDeltaSeconds);
+}
+
+//----------------------------------------------------------------------------------------------------
+ScenarioRunner::ScenarioRunner(BenchmarkRunner& runner)
+    : m_runner(runner),
+      m_counters(runner.GetCounters())
+{
+}
+
+//----------------------------------------------------------------------------------------------------
+ScenarioRunner::~ScenarioRunner()
+{
+    for (MapDefinition const* mapDef : m_scenarioMapDefs)
+    {
+        delete mapDef;
+    }
+
+    m_scenarioMapDefs.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+// Returns false when the scenarios file is missing or malformed.
+//
+bool ScenarioRunner::RunAll(String const& scenariosPath)
+{
+    XmlDocument scenariosXml;
+
+    if (scenariosXml.LoadFile(scenariosPath.c_str()) != XmlResult::XML_SUCCESS)
+    {
+        printf("ScenarioRunner: could not load %s\n", scenariosPath.c_str());
+        return false;
+    }
+
+    XmlElement const* root = scenariosXml.FirstChildElement("BenchmarkScenarios");
+
+    if (!root)
+    {
+        printf("ScenarioRunner: %s has no <BenchmarkScenarios> root\n", scenariosPath.c_str());
+        return false;
+    }
+
+    for (XmlElement const* element = root->FirstChildElement("MapDefinition"); element != nullptr; element = element->NextSiblingElement("MapDefinition"))
+    {
+        m_scenarioMapDefs.push_back(new MapDefinition(*element));
+    }
+
+    for (XmlElement const* element = root->FirstChildElement("BenchmarkScenario"); element != nullptr; element = element->NextSiblingElement("BenchmarkScenario"))
+    {
+        RunScenario(BenchmarkScenario(*element));
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void ScenarioRunner::OnMapUpdatePhaseBegin(MapUpdatePhase const phase)
+{
+    UNUSED(phase)
+
+    if (m_counters) m_counters->Read(m_phaseStartCounters);
+
+    m_phaseStartTime = std::chrono::steady_clock::now();
+}
+
+//----------------------------------------------------------------------------------------------------
+void ScenarioRunner::OnMapUpdatePhaseEnd(MapUpdatePhase const phase)
+{
+    m_phaseNanoseconds[phase] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_phaseStartTime).count();
+
+    if (!m_counters) return;
+
+    HardwareCounterSample phaseEndCounters;
+    m_counters->Read(phaseEndCounters);
+    m_phaseCounterTotals[phase].AddDifference(m_phaseStartCounters, phaseEndCounters);
+}
+
+//----------------------------------------------------------------------------------------------------
+void ScenarioRunner::OnMapPathRequestBegin()
+{
+    if (m_counters) m_counters->Read(m_pathRequestStartCounters);
+
+    m_pathRequestStartTime = std::chrono::steady_clock::now();
+}
+
+//----------------------------------------------------------------------------------------------------
+void ScenarioRunner::OnMapPathRequestEnd()
+{
+    m_pathRequestNanoseconds.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_pathRequestStartTime).count());
+
+    if (!m_counters) return;
+
+    HardwareCounterSample pathRequestEndCounters;
+    m_counters->Read(pathRequestEndCounters);
+    m_pathRequestCounterTotals.AddDifference(m_pathRequestStartCounters, pathRequestEndCounters);
+}
+
+//----------------------------------------------------------------------------------------------------
+// The seed goes to the C runtime generator that g_theRNG draws from, before the map is built. The map
+// seeds its own RandomStream from it, so tile generation, spawn placement and every AI decision replay
+// identically run to run.
+//
+void ScenarioRunner::RunScenario(BenchmarkScenario const& scenario)
+{
+    String const tickName      = "Simulation/Tick/" + scenario.m_name;
+    bool         isAnySelected = m_runner.IsSelected(tickName);
+
+    isAnySelected = isAnySelected || m_runner.IsSelected("Simulation/PathRequests/" + scenario.m_name);
+
+    for (int phaseIndex = 0; phaseIndex < NUM_MAP_UPDATE_PHASES; ++phaseIndex)
+    {
+        isAnySelected = isAnySelected || m_runner.IsSelected(Stringf("Simulation/%s/%s", GetMapUpdatePhaseName(static_cast<MapUpdatePhase>(phaseIndex)), scenario.m_name.c_str()));
+    }
+
+    if (!isAnySelected) return;
+
+    MapDefinition const* mapDef = FindMapDefinition(scenario.m_mapDefName);
+
+    if (!mapDef)
+    {
+        printf("ScenarioRunner: scenario %s names unknown map definition %s, skipped\n", scenario.m_name.c_str(), scenario.m_mapDefName.c_str());
+        return;
+    }
+
+    std::srand(static_cast<unsigned int>(scenario.m_seed));
+
+    Map* map = new Map(*mapDef);
+
+    SpawnScenarioAgents(*map, scenario);
+
+    int const             numTicks = std::max(1, static_cast<int>(std::lround(scenario.m_durationSeconds / scenario.m_fixedDeltaSeconds)));
+    std::vector<int64_t>  tickNanoseconds;
+    std::vector<int64_t>  phaseNanoseconds[NUM_MAP_UPDATE_PHASES];
+    int64_t               numAllocations    = 0;
+    int64_t               numBytes          = 0;
+    float                 bulletAccumulator = 0.f;
+    HardwareCounterSample tickCounterTotals;
+
+    tickNanoseconds.reserve(numTicks);
+    m_pathRequestNanoseconds.clear();
+    m_pathRequestCounterTotals = HardwareCounterSample();
+
+    for (HardwareCounterSample& phaseCounterTotals : m_phaseCounterTotals)
+    {
+        phaseCounterTotals = HardwareCounterSample();
+    }
+
+    for (std::vector<int64_t>& phaseSamples : phaseNanoseconds)
+    {
+        phaseSamples.reserve(numTicks);
+    }
+
+    for (int tickIndex = 0; tickIndex < numTicks; ++tickIndex)
+    {
+        bulletAccumulator += scenario.m_bulletsPerSecond * scenario.m_fixedDeltaSeconds;
+
+        int const numBullets = static_cast<int>(bulletAccumulator);
+
+        bulletAccumulator -= static_cast<float>(numBullets);
+        SpawnScenarioBullets(*map, numBullets);
+
+        int64_t const         allocationsBefore = BenchmarkRunner::GetNumAllocations();
+        int64_t const         bytesBefore       = BenchmarkRunner::GetNumAllocatedBytes();
+        HardwareCounterSample tickStartCounters;
+        HardwareCounterSample tickEndCounters;
+
+        if (m_counters) m_counters->Read(tickStartCounters);
+
+        std::chrono::steady_clock::time_point const tickStart = std::chrono::steady_clock::now();
+
+        map->UpdateSimulation(scenario.m_fixedDeltaSeconds, this);
+
+        tickNanoseconds.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tickStart).count());
+
+        if (m_counters)
+        {
+            m_counters->Read(tickEndCounters);
+            tickCounterTotals.AddDifference(tickStartCounters, tickEndCounters);
+        }
+
+        numAllocations += BenchmarkRunner::GetNumAllocations() - allocationsBefore;
+        numBytes       += BenchmarkRunner::GetNumAllocatedBytes() - bytesBefore;
+
+        for (int phaseIndex = 0; phaseIndex < NUM_MAP_UPDATE_PHASES; ++phaseIndex)
+        {
+            phaseNanoseconds[phaseIndex].push_back(m_phaseNanoseconds[phaseIndex]);
+        }
+    }
+
+    AddDistributionResult(tickName, scenario, *map, tickNanoseconds, numAllocations, numBytes, tickCounterTotals);
+
+    for (int phaseIndex = 0; phaseIndex < NUM_MAP_UPDATE_PHASES; ++phaseIndex)
+    {
+        String const phaseName = Stringf("Simulation/%s/%s", GetMapUpdatePhaseName(static_cast<MapUpdatePhase>(phaseIndex)), scenario.m_name.c_str());
+
+        AddDistributionResult(phaseName, scenario, *map, phaseNanoseconds[phaseIndex], 0, 0, m_phaseCounterTotals[phaseIndex]);
+    }
+
+    AddDistributionResult("Simulation/PathRequests/" + scenario.m_name, scenario, *map, m_pathRequestNanoseconds, 0, 0, m_pathRequestCounterTotals);
+
+    delete map;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The map's own NPCs are cleared so the scenario's counts are exact. Agents go on shuffled dry tiles,
+// one per tile; Scorpios are turrets that must sit on a tile center.
+//
+void ScenarioRunner::SpawnScenarioAgents(Map& map, BenchmarkScenario const& scenario)
+{
+    for (Entity* entity : map.m_allEntities)
+    {
+        if (entity) entity->m_isGarbage = true;
+    }
+
+    map.DeleteGarbageEntities();
+
+    m_landTileCoords.clear();
+
+    IntVec2 const dimensions = map.GetMapDimension();
+
+    for (int tileY = 0; tileY < dimensions.y; ++tileY)
+    {
+        for (int tileX = 0; tileX < dimensions.x; ++tileX)
+        {
+            IntVec2 const coords(tileX, tileY);
+
+            if (!map.IsTileSolid(coords) && !map.IsTileWater(coords)) m_landTileCoords.push_back(coords);
+        }
+    }
+
+    if (m_landTileCoords.empty()) return;
+
+    std::vector<IntVec2> spawnCoords = m_landTileCoords;
+
+    for (int coordsIndex = static_cast<int>(spawnCoords.size()) - 1; coordsIndex > 0; --coordsIndex)
+    {
+        std::swap(spawnCoords[coordsIndex], spawnCoords[g_theRNG->RollRandomIntInRange(0, coordsIndex)]);
+    }
+
+    std::pair<EntityType, int> const agentCounts[] =
+    {
+        {ENTITY_TYPE_SCORPIO, scenario.m_scorpioCount},
+        {ENTITY_TYPE_LEO, scenario.m_leoCount},
+        {ENTITY_TYPE_ARIES, scenario.m_ariesCount},
+        {ENTITY_TYPE_CAPRICORN, scenario.m_capricornCount}
+    };
+
+    size_t spawnIndex = 0;
+
+    for (std::pair<EntityType, int> const& agentCount : agentCounts)
+    {
+        for (int agentIndex = 0; agentIndex < agentCount.second; ++agentIndex)
+        {
+            if (spawnIndex == spawnCoords.size())
+            {
+                printf("ScenarioRunner: %s asks for %d agents but %s has %d dry tiles; the rest are not spawned\n",
+                       scenario.m_name.c_str(),
+                       scenario.GetNumAgents(),
+                       scenario.m_mapDefName.c_str(),
+                       static_cast<int>(spawnCoords.size()));
+                return;
+            }
+
+            map.SpawnNewEntity(agentCount.first, ENTITY_FACTION_EVIL, map.GetWorldPosFromTileCoords(spawnCoords[spawnIndex]), g_theRNG->RollRandomFloatInRange(0.f, 360.f));
+            ++spawnIndex;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Friendly bullets fired in random directions from random dry tiles, standing in for a player's fire.
+//
+void ScenarioRunner::SpawnScenarioBullets(Map& map, int const numBullets) const
+{
+    if (m_landTileCoords.empty()) return;
+
+    for (int bulletIndex = 0; bulletIndex < numBullets; ++bulletIndex)
+    {
+        IntVec2 const coords = m_landTileCoords[g_theRNG->RollRandomIntInRange(0, static_cast<int>(m_landTileCoords.size()) - 1)];
+
+        map.SpawnNewEntity(ENTITY_TYPE_BULLET, ENTITY_FACTION_GOOD, map.GetWorldPosFromTileCoords(coords), g_theRNG->RollRandomFloatInRange(0.f, 360.f));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Percentiles are nearest-rank over every tick. Entity counts are taken at the end of the run, after
+// the bullet spam and the deaths it causes have settled into a steady population.
+//
+void ScenarioRunner::AddDistributionResult(String const&                name,
+                                           BenchmarkScenario const&     scenario,
+                                           Map const&                   map,
+                                           std::vector<int64_t>&        nanoseconds,
+                                           int64_t const                numAllocations,
+                                           int64_t const                numBytes,
+                                           HardwareCounterSample const& counterTotals)
+{
+    if (!m_runner.IsSelected(name) || nanoseconds.empty()) return;
+
+    std::sort(nanoseconds.begin(), nanoseconds.end());
+
+    double totalNanoseconds = 0.0;
+
+    for (int64_t const sample : nanoseconds)
+    {
+        totalNanoseconds += static_cast<double>(sample);
+    }
+
+    size_t const numSamples = nanoseconds.size();
+    auto const   percentile = [&nanoseconds, numSamples](double const fraction)
+    {
+        size_t const rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(numSamples)));
+        return static_cast<double>(nanoseconds[std::min(numSamples, std::max<size_t>(rank, 1)) - 1]);
+    };
+
+    BenchmarkResult result;
+
+    result.m_name             = name;
+    result.m_mapName          = scenario.m_mapDefName;
+    result.m_mapDimensions    = map.GetMapDimension();
+    result.m_numEntities      = static_cast<int>(map.m_allEntities.size());
+    result.m_numIterations    = static_cast<int64_t>(numSamples);
+    result.m_nanosecondsPerOp = totalNanoseconds / static_cast<double>(numSamples);
+    result.m_opsPerSecond     = totalNanoseconds > 0.0 ? static_cast<double>(numSamples) * 1e9 / totalNanoseconds : 0.0;
+    result.m_allocationsPerOp = static_cast<double>(numAllocations) / static_cast<double>(numSamples);
+    result.m_bytesPerOp       = static_cast<double>(numBytes) / static_cast<double>(numSamples);
+    result.m_p50Nanoseconds   = percentile(0.50);
+    result.m_p99Nanoseconds   = percentile(0.99);
+    result.m_maxNanoseconds   = static_cast<double>(nanoseconds.back());
+
+    if (m_counters) result.SetCountersPerOp(counterTotals, static_cast<int64_t>(numSamples));
+
+    m_runner.AddResult(result);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Definitions in the scenarios file win over the game's own, so an arena can shadow a real map.
+//
+MapDefinition const* ScenarioRunner::FindMapDefinition(String const& name) const
+{
+    for (MapDefinition const* mapDef : m_scenarioMapDefs)
+    {
+        if (mapDef->GetName() == name) return mapDef;
+    }
+
+    return MapDefinition::GetTileDefByName(name);
+}
@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------------------------------------
+// ScenarioRunner.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Game/HardwareCounters.hpp"
+#include "Game/Map.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class BenchmarkRunner;
+struct MapDefinition;
+
+//----------------------------------------------------------------------------------------------------
+// One <BenchmarkScenario> from BenchmarkScenarios.xml: a map, a seed and a fixed workload.
+//
+struct BenchmarkScenario
+{
+    explicit BenchmarkScenario(XmlElement const& scenarioElement);
+
+    int GetNumAgents() const { return m_scorpioCount + m_leoCount + m_ariesCount + m_capricornCount; }
+
+    String m_name;
+    String m_mapDefName;
+    int    m_seed              = 0;
+    int    m_scorpioCount      = 0;
+    int    m_leoCount          = 0;
+    int    m_ariesCount        = 0;
+    int    m_capricornCount    = 0;
+    float  m_bulletsPerSecond  = 0.f;
+    float  m_durationSeconds   = 10.f;
+    float  m_fixedDeltaSeconds = 1.f / 60.f;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Drives Map::UpdateSimulation headlessly at each scenario's fixed dt for its simulated duration
+// and reports ticks per wall-clock second, p50/p99/max tick time, and the same distribution for
+// every phase of the tick and for path requests: each tick's delivery and dispatch when the
+// PathService answers them on the worker pool, or every request on its own when they are answered
+// inline. Spawning the scenario's bullets happens between ticks and is not timed. When the runner
+// reads hardware counters, each of those results carries them too; reading them costs a syscall at
+// every phase and path request, which the times then include.
+//
+class ScenarioRunner : public MapUpdatePhaseListener
+{
+public:
+    explicit ScenarioRunner(BenchmarkRunner& runner);
+    ~ScenarioRunner() override;
+
+    bool RunAll(String const& scenariosPath);
+
+    void OnMapUpdatePhaseBegin(MapUpdatePhase phase) override;
+    void OnMapUpdatePhaseEnd(MapUpdatePhase phase) override;
+    void OnMapPathRequestBegin() override;
+    void OnMapPathRequestEnd() override;
+
+private:
+    void RunScenario(BenchmarkScenario const& scenario);
+    void SpawnScenarioAgents(Map& map, BenchmarkScenario const& scenario);
+    void SpawnScenarioBullets(Map& map, int numBullets) const;
+    void AddDistributionResult(String const& name, BenchmarkScenario const& scenario, Map const& map, std::vector<int64_t>& nanoseconds, int64_t numAllocations, int64_t numBytes, HardwareCounterSample const& counterTotals);
+
+    MapDefinition const* FindMapDefinition(String const& name) const;
+
+    BenchmarkRunner&                      m_runner;
+    std::vector<MapDefinition*>           m_scenarioMapDefs;     // <MapDefinition>s from the scenarios file
+    std::vector<IntVec2>                  m_landTileCoords;      // Of the map being run, for spawning
+    std::chrono::steady_clock::time_point m_phaseStartTime;
+    int64_t                               m_phaseNanoseconds[NUM_MAP_UPDATE_PHASES] = {};
+    std::chrono::steady_clock::time_point m_pathRequestStartTime;
+    std::vector<int64_t>                  m_pathRequestNanoseconds;                     // Every request this scenario
+
+    HardwareCounterGroup const* m_counters = nullptr;                                  // Null unless the runner reads them
+    HardwareCounterSample       m_phaseStartCounters;
+    HardwareCounterSample       m_phaseCounterTotals[NUM_MAP_UPDATE_PHASES];
+    HardwareCounterSample       m_pathRequestStartCounters;
+    HardwareCounterSample       m_pathRequestCounterTotals;
+};
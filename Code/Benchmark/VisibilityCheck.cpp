@@ -0,0 +1,248 @@
+//----------------------------------------------------------------------------------------------------
+// VisibilityCheck.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Benchmark/VisibilityCheck.hpp"
+
+#include <climits>
+#include <cstdio>
+#include <vector>
+
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/PotentiallyVisibleSet.hpp"
+#include "Game/TileMasks.hpp"
+#include "Game/TileVisibility.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Small enough that every mask here is clustered at least once.
+//
+static constexpr int CLUSTERED_BUDGET_BYTES = 1024;
+
+//----------------------------------------------------------------------------------------------------
+// The table answers off-center pairs away from a visibility edge without a raycast, and those answers
+// are not exact (see Map::IsNearVisibilityEdge), so off-center pairs fail only past this share.
+//
+static constexpr int   NUM_OFF_CENTER_PAIRS             = 10000;
+static constexpr float MAX_OFF_CENTER_MISMATCH_FRACTION = 0.005f;
+
+//----------------------------------------------------------------------------------------------------
+bool VisibilityCheck::RunAll()
+{
+    bool isPassed = true;
+
+    for (MapDefinition const* mapDef : MapDefinition::s_mapDefinitions)
+    {
+        Map*       map = new Map(*mapDef);
+        TileBitmap transparent;
+
+        // The game ships with mapPvsEnabled off; the map's own set is what HasLineOfSight reads
+        if (!map->m_potentiallyVisibleSet.IsBuilt()) map->BuildPotentiallyVisibleSet();
+
+        map->BuildTraversabilityMask(transparent, TILE_FLAG_SOLID, TILE_FLAG_WATER, false);
+
+        PotentiallyVisibleSet exactSet;
+        PotentiallyVisibleSet clusteredSet;
+
+        exactSet.Build(transparent, INT_MAX);
+        clusteredSet.Build(transparent, CLUSTERED_BUDGET_BYTES);
+
+        isPassed = CheckSetAgainstFieldOfView(transparent, exactSet, mapDef->GetName().c_str()) && isPassed;
+        isPassed = CheckSetAgainstFieldOfView(transparent, clusteredSet, mapDef->GetName().c_str()) && isPassed;
+        isPassed = CheckLineOfSight(*map, mapDef->GetName().c_str()) && isPassed;
+        isPassed = CheckOffCenterLineOfSight(*map, mapDef->GetName().c_str()) && isPassed;
+
+        delete map;
+    }
+
+    // One word and a bit per tile row, so a row's padding and its second word are both covered
+    TileBitmap randomMask(IntVec2(100, 37));
+
+    for (int y = 0; y < 37; ++y)
+    {
+        for (int x = 0; x < 100; ++x)
+        {
+            if (g_theRNG->RollRandomFloatZeroToOne() >= 0.2f) randomMask.Set(IntVec2(x, y));
+        }
+    }
+
+    PotentiallyVisibleSet exactSet;
+    PotentiallyVisibleSet clusteredSet;
+
+    exactSet.Build(randomMask, INT_MAX);
+    clusteredSet.Build(randomMask, CLUSTERED_BUDGET_BYTES);
+
+    isPassed = CheckSetAgainstFieldOfView(randomMask, exactSet, "Random100x37") && isPassed;
+    isPassed = CheckSetAgainstFieldOfView(randomMask, clusteredSet, "Random100x37") && isPassed;
+
+    printf("%s: visibility check, %d pairs, %d mismatches; %d off-center pairs, %d differ from RaycastVsTiles\n",
+           isPassed ? "PASSED" : "FAILED",
+           m_numPairs,
+           m_numMismatches,
+           m_numOffCenterPairs,
+           m_numOffCenterMismatches);
+
+    return isPassed;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Every pair of tiles: an opaque tile sees nothing, and a transparent one sees what its shadowcast
+// reaches. A clustered set answers for a whole cluster, so it only has to hold every shadowcast bit.
+//
+bool VisibilityCheck::CheckSetAgainstFieldOfView(TileBitmap const& transparent, PotentiallyVisibleSet const& set, char const* name)
+{
+    IntVec2 const dimensions    = transparent.GetDimensions();
+    int const     radius        = dimensions.x + dimensions.y;
+    bool const    isExact       = set.GetClusterSize() == 1;
+    int           numMismatches = 0;
+    TileBitmap    visible(dimensions);
+
+    for (int fromY = 0; fromY < dimensions.y; ++fromY)
+    {
+        for (int fromX = 0; fromX < dimensions.x; ++fromX)
+        {
+            IntVec2 const fromCoords = IntVec2(fromX, fromY);
+
+            if (transparent.IsSet(fromCoords)) ComputeFieldOfView(transparent, fromCoords, radius, visible);
+            else visible.ClearAll();
+
+            for (int toY = 0; toY < dimensions.y; ++toY)
+            {
+                for (int toX = 0; toX < dimensions.x; ++toX)
+                {
+                    IntVec2 const toCoords  = IntVec2(toX, toY);
+                    bool const    isVisible = visible.IsSet(toCoords);
+                    bool const    isInSet   = set.IsPotentiallyVisible(fromCoords, toCoords);
+
+                    ++m_numPairs;
+
+                    if (isVisible == isInSet || (!isExact && isInSet)) continue;
+
+                    if (numMismatches < 8) printf("  %s cluster %d: (%d,%d) -> (%d,%d) shadowcast %d, set %d\n", name, set.GetClusterSize(), fromX, fromY, toX, toY, isVisible, isInSet);
+
+                    ++numMismatches;
+                }
+            }
+        }
+    }
+
+    m_numMismatches += numMismatches;
+
+    return numMismatches == 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Only meaningful when the map's own set is unclustered; a clustered "maybe" falls back to a raycast,
+// which can differ from the shadowcast on a line that grazes a wall corner.
+//
+bool VisibilityCheck::CheckLineOfSight(Map const& map, char const* name)
+{
+    if (!map.m_potentiallyVisibleSet.IsBuilt() || map.m_potentiallyVisibleSet.GetClusterSize() != 1) return true;
+
+    TileBitmap transparent;
+
+    map.BuildTraversabilityMask(transparent, TILE_FLAG_SOLID, TILE_FLAG_WATER, false);
+
+    IntVec2 const dimensions    = transparent.GetDimensions();
+    int const     radius        = dimensions.x + dimensions.y;
+    float const   sightRange    = static_cast<float>(radius);
+    int           numMismatches = 0;
+    TileBitmap    visible(dimensions);
+
+    for (int fromY = 0; fromY < dimensions.y; ++fromY)
+    {
+        for (int fromX = 0; fromX < dimensions.x; ++fromX)
+        {
+            IntVec2 const fromCoords = IntVec2(fromX, fromY);
+
+            if (!transparent.IsSet(fromCoords)) continue;
+
+            ComputeFieldOfView(transparent, fromCoords, radius, visible);
+
+            for (int toY = 0; toY < dimensions.y; ++toY)
+            {
+                for (int toX = 0; toX < dimensions.x; ++toX)
+                {
+                    IntVec2 const toCoords  = IntVec2(toX, toY);
+                    bool const    isVisible = visible.IsSet(toCoords);
+                    bool const    hasSight  = map.HasLineOfSight(map.GetWorldPosFromTileCoords(fromCoords), map.GetWorldPosFromTileCoords(toCoords), sightRange);
+
+                    ++m_numPairs;
+
+                    if (isVisible == hasSight) continue;
+
+                    if (numMismatches < 8) printf("  %s HasLineOfSight: (%d,%d) -> (%d,%d) shadowcast %d, HasLineOfSight %d\n", name, fromX, fromY, toX, toY, isVisible, hasSight);
+
+                    ++numMismatches;
+                }
+            }
+        }
+    }
+
+    m_numMismatches += numMismatches;
+
+    return numMismatches == 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Random points anywhere inside two transparent tiles, against a raycast between the same points.
+//
+bool VisibilityCheck::CheckOffCenterLineOfSight(Map const& map, char const* name)
+{
+    if (!map.m_potentiallyVisibleSet.IsBuilt()) return true;
+
+    TileBitmap transparent;
+
+    map.BuildTraversabilityMask(transparent, TILE_FLAG_SOLID, TILE_FLAG_WATER, false);
+
+    std::vector<IntVec2> transparentCoords;
+    IntVec2 const        dimensions = transparent.GetDimensions();
+
+    for (int y = 0; y < dimensions.y; ++y)
+    {
+        for (int x = 0; x < dimensions.x; ++x)
+        {
+            if (transparent.IsSet(IntVec2(x, y))) transparentCoords.emplace_back(x, y);
+        }
+    }
+
+    if (transparentCoords.size() < 2) return true;
+
+    float const sightRange    = static_cast<float>(dimensions.x + dimensions.y);
+    int         numMismatches = 0;
+
+    auto const rollPointInTile = [&transparentCoords]
+    {
+        IntVec2 const coords = transparentCoords[g_theRNG->RollRandomIntInRange(0, static_cast<int>(transparentCoords.size()) - 1)];
+
+        return Vec2(coords) + Vec2(g_theRNG->RollRandomFloatInRange(0.01f, 0.99f), g_theRNG->RollRandomFloatInRange(0.01f, 0.99f));
+    };
+
+    for (int pairIndex = 0; pairIndex < NUM_OFF_CENTER_PAIRS; ++pairIndex)
+    {
+        Vec2 const start = rollPointInTile();
+        Vec2 const end   = rollPointInTile();
+
+        if (start == end) continue;
+
+        Ray2 const ray         = Ray2(start, (end - start).GetNormalized(), GetDistance2D(start, end));
+        bool const hasRaySight = !map.RaycastVsTiles(ray).m_didImpact;
+        bool const hasSight    = map.HasLineOfSight(start, end, sightRange);
+
+        ++m_numOffCenterPairs;
+
+        if (hasSight == hasRaySight) continue;
+
+        if (numMismatches < 8) printf("  %s off-center: (%.2f,%.2f) -> (%.2f,%.2f) raycast %d, HasLineOfSight %d\n", name, start.x, start.y, end.x, end.y, hasRaySight, hasSight);
+
+        ++numMismatches;
+    }
+
+    m_numOffCenterMismatches += numMismatches;
+
+    return static_cast<float>(numMismatches) <= MAX_OFF_CENTER_MISMATCH_FRACTION * static_cast<float>(NUM_OFF_CENTER_PAIRS);
+}
@@ -0,0 +1,34 @@
+//----------------------------------------------------------------------------------------------------
+// VisibilityCheck.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+
+//----------------------------------------------------------------------------------------------------
+class Map;
+class PotentiallyVisibleSet;
+class TileBitmap;
+
+//----------------------------------------------------------------------------------------------------
+// Checks the visible set against direct shadowcasting on every map in MapDefinitions.xml plus a random
+// mask whose width is not a multiple of 64. An unclustered build must match ComputeFieldOfView bit for
+// bit, a clustered one may only add bits, and Map::HasLineOfSight between two tile centers must give
+// the shadowcast's answer. Between random off-center points it is compared with RaycastVsTiles, and a
+// small share of those may differ. A friend of Map, so it reads the map's own set. Prints mismatches.
+//
+class VisibilityCheck
+{
+public:
+    bool RunAll();
+
+private:
+    bool CheckSetAgainstFieldOfView(TileBitmap const& transparent, PotentiallyVisibleSet const& set, char const* name);
+    bool CheckLineOfSight(Map const& map, char const* name);
+    bool CheckOffCenterLineOfSight(Map const& map, char const* name);
+
+    int m_numPairs               = 0;
+    int m_numMismatches          = 0;
+    int m_numOffCenterPairs      = 0;
+    int m_numOffCenterMismatches = 0;
+};
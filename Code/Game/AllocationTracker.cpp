@@ -0,0 +1,543 @@
+//----------------------------------------------------------------------------------------------------
+// AllocationTracker.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "Dbghelp.lib")
+#elif defined(__linux__)
+#include <execinfo.h>
+#endif
+
+//----------------------------------------------------------------------------------------------------
+// Call sites are keyed on this many return addresses, which is usually enough to get past the
+// tracker, std::allocator and container internals to the game code that asked. How many of them are
+// plumbing depends on inlining, so they are skipped when the site is described, not when captured.
+//
+static constexpr int NUM_CALL_SITE_FRAMES = 12;
+static constexpr int MAX_CALL_SITES       = 16384;     // Power of two; site 0 collects what does not fit
+static constexpr int MAX_ZONES            = 512;       // Power of two; zone 0 is "outside every zone"
+
+//----------------------------------------------------------------------------------------------------
+struct AllocationCallSite
+{
+    void*    m_frames[NUM_CALL_SITE_FRAMES] = {};
+    uint32_t m_hash                         = 0;
+    bool     m_isUsed                       = false;
+    int64_t  m_numAllocations               = 0;
+    int64_t  m_numBytes                     = 0;
+    int64_t  m_numLiveAllocations           = 0;
+    int64_t  m_numLiveBytes                 = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+struct AllocationZone
+{
+    char const* m_name           = nullptr;
+    int64_t     m_numAllocations = 0;
+    int64_t     m_numBytes       = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Sits right in front of every block handed out. 16 bytes keeps the default new alignment.
+//
+struct AllocationHeader
+{
+    uint64_t m_numBytes;
+    uint32_t m_siteIndex;
+    uint16_t m_zoneIndex;
+    uint16_t m_headerBytes;                    // Distance back from the block to what malloc returned
+};
+
+static_assert(sizeof(AllocationHeader) == 16, "AllocationHeader must keep blocks 16-byte aligned");
+
+//----------------------------------------------------------------------------------------------------
+// Everything below is zero-initialized before any constructor runs, so allocations made during static
+// initialization are tracked too. The tables never allocate; the lock is a spin flag for the same
+// reason.
+//
+static AllocationCallSite   s_callSites[MAX_CALL_SITES];
+static AllocationZone       s_zones[MAX_ZONES];
+static std::atomic_flag     s_tablesLock = ATOMIC_FLAG_INIT;
+static std::atomic<int64_t> s_totalNumAllocations{0};
+static std::atomic<int64_t> s_totalNumBytes{0};
+static std::atomic<int64_t> s_liveBytes{0};
+static std::atomic<int64_t> s_frameNumAllocations{0};
+static std::atomic<int64_t> s_frameNumBytes{0};
+static std::atomic<int64_t> s_frameNumFrees{0};
+static std::atomic<int64_t> s_framePeakLiveBytes{0};
+static AllocationFrameStats s_lastFrameStats;                       // Main thread only
+
+static thread_local char const* t_currentZone     = nullptr;
+static thread_local bool        t_isInsideTracker = false;          // Set while capturing a stack, which may allocate
+
+//----------------------------------------------------------------------------------------------------
+class AllocationTablesLock
+{
+public:
+    AllocationTablesLock()
+    {
+        while (s_tablesLock.test_and_set(std::memory_order_acquire))
+        {
+        }
+    }
+
+    ~AllocationTablesLock() { s_tablesLock.clear(std::memory_order_release); }
+};
+
+//----------------------------------------------------------------------------------------------------
+static int CaptureCallSiteFrames(void* outFrames[NUM_CALL_SITE_FRAMES])
+{
+#if defined(_WIN32)
+    return static_cast<int>(RtlCaptureStackBackTrace(1, NUM_CALL_SITE_FRAMES, outFrames, nullptr));
+#elif defined(__linux__)
+    void* frames[NUM_CALL_SITE_FRAMES + 1];
+    int   numFrames = backtrace(frames, NUM_CALL_SITE_FRAMES + 1) - 1;
+
+    numFrames = std::max(numFrames, 0);
+    std::memcpy(outFrames, frames + 1, sizeof(void*) * static_cast<size_t>(numFrames));
+
+    return numFrames;
+#else
+    outFrames[0] = __builtin_return_address(0);
+    return 1;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+// Call with the tables locked. Returns 0 once the table is full.
+//
+static uint32_t FindOrAddCallSite(void* const frames[NUM_CALL_SITE_FRAMES])
+{
+    uint32_t hash = 2166136261u;
+
+    for (int frameIndex = 0; frameIndex < NUM_CALL_SITE_FRAMES; ++frameIndex)
+    {
+        hash = (hash ^ static_cast<uint32_t>(reinterpret_cast<uintptr_t>(frames[frameIndex]) >> 4)) * 16777619u;
+    }
+
+    for (uint32_t probe = 0; probe < MAX_CALL_SITES; ++probe)
+    {
+        uint32_t const      siteIndex = (hash + probe) & (MAX_CALL_SITES - 1);
+        AllocationCallSite& site      = s_callSites[siteIndex];
+
+        if (siteIndex == 0) continue;
+
+        if (!site.m_isUsed)
+        {
+            site.m_isUsed = true;
+            site.m_hash   = hash;
+            std::memcpy(site.m_frames, frames, sizeof(site.m_frames));
+            return siteIndex;
+        }
+
+        if (site.m_hash == hash && std::memcmp(site.m_frames, frames, sizeof(site.m_frames)) == 0) return siteIndex;
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Call with the tables locked. Zone names are string literals, so the pointer is the key.
+//
+static uint16_t FindOrAddZone(char const* zoneName)
+{
+    if (!zoneName) return 0;
+
+    uint32_t const hash = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(zoneName) >> 3) * 2654435761u;
+
+    for (uint32_t probe = 0; probe < MAX_ZONES; ++probe)
+    {
+        uint32_t const  zoneIndex = (hash + probe) & (MAX_ZONES - 1);
+        AllocationZone& zone      = s_zones[zoneIndex];
+
+        if (zoneIndex == 0) continue;
+
+        if (!zone.m_name) zone.m_name = zoneName;
+        if (zone.m_name == zoneName) return static_cast<uint16_t>(zoneIndex);
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void RecordAllocation(AllocationHeader& header, size_t const numBytes)
+{
+    int64_t const signedNumBytes = static_cast<int64_t>(numBytes);
+
+    s_totalNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_totalNumBytes.fetch_add(signedNumBytes, std::memory_order_relaxed);
+    s_frameNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_frameNumBytes.fetch_add(signedNumBytes, std::memory_order_relaxed);
+
+    int64_t const liveBytes = s_liveBytes.fetch_add(signedNumBytes, std::memory_order_relaxed) + signedNumBytes;
+    int64_t       peak      = s_framePeakLiveBytes.load(std::memory_order_relaxed);
+
+    while (liveBytes > peak && !s_framePeakLiveBytes.compare_exchange_weak(peak, liveBytes, std::memory_order_relaxed))
+    {
+    }
+
+    // Allocations made while capturing a stack are charged to site 0 rather than captured again
+    void*      frames[NUM_CALL_SITE_FRAMES] = {};
+    bool const isCapturingStack             = !t_isInsideTracker;
+
+    if (isCapturingStack)
+    {
+        t_isInsideTracker = true;
+        CaptureCallSiteFrames(frames);
+        t_isInsideTracker = false;
+    }
+
+    AllocationTablesLock const lock;
+
+    header.m_numBytes  = numBytes;
+    header.m_siteIndex = isCapturingStack ? FindOrAddCallSite(frames) : 0;
+    header.m_zoneIndex = FindOrAddZone(t_currentZone);
+
+    AllocationCallSite& site = s_callSites[header.m_siteIndex];
+    AllocationZone&     zone = s_zones[header.m_zoneIndex];
+
+    site.m_numAllocations     += 1;
+    site.m_numBytes           += signedNumBytes;
+    site.m_numLiveAllocations += 1;
+    site.m_numLiveBytes       += signedNumBytes;
+    zone.m_numAllocations     += 1;
+    zone.m_numBytes           += signedNumBytes;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void RecordFree(AllocationHeader const& header)
+{
+    int64_t const signedNumBytes = static_cast<int64_t>(header.m_numBytes);
+
+    s_liveBytes.fetch_sub(signedNumBytes, std::memory_order_relaxed);
+    s_frameNumFrees.fetch_add(1, std::memory_order_relaxed);
+
+    AllocationTablesLock const lock;
+    AllocationCallSite&        site = s_callSites[header.m_siteIndex];
+
+    site.m_numLiveAllocations -= 1;
+    site.m_numLiveBytes       -= signedNumBytes;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Blocks aligned past 16 bytes get a header slot as wide as their alignment, so the block itself
+// stays aligned; the header always sits in the last 16 bytes of that slot.
+//
+static void* AllocateTracked(size_t const numBytes, size_t const alignment)
+{
+    size_t const headerBytes = std::max(alignment, sizeof(AllocationHeader));
+    size_t const totalBytes  = headerBytes + numBytes;
+    void*        memory;
+
+    if (alignment <= sizeof(AllocationHeader))
+    {
+        memory = std::malloc(totalBytes);
+    }
+    else
+    {
+#if defined(_MSC_VER)
+        memory = _aligned_malloc(totalBytes, alignment);
+#else
+        memory = std::aligned_alloc(alignment, (totalBytes + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    if (!memory) throw std::bad_alloc();
+
+    unsigned char*    block  = static_cast<unsigned char*>(memory) + headerBytes;
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(block) - 1;
+
+    header->m_headerBytes = static_cast<uint16_t>(headerBytes);
+    RecordAllocation(*header, numBytes);
+
+    return block;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void FreeTracked(void* block, bool const isOverAligned)
+{
+    if (!block) return;
+
+    AllocationHeader const* header = static_cast<AllocationHeader const*>(block) - 1;
+    void*                   memory = static_cast<unsigned char*>(block) - header->m_headerBytes;
+
+    RecordFree(*header);
+
+    if (!isOverAligned)
+    {
+        std::free(memory);
+        return;
+    }
+
+#if defined(_MSC_VER)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+// operator new(size, align_val_t) is only called for alignments past the default, so the aligned
+// deletes always pair with the aligned path above.
+//
+void* operator new(size_t const numBytes) { return AllocateTracked(numBytes, 0); }
+void* operator new[](size_t const numBytes) { return AllocateTracked(numBytes, 0); }
+void* operator new(size_t const numBytes, std::align_val_t const alignment) { return AllocateTracked(numBytes, static_cast<size_t>(alignment)); }
+void* operator new[](size_t const numBytes, std::align_val_t const alignment) { return AllocateTracked(numBytes, static_cast<size_t>(alignment)); }
+void  operator delete(void* block) noexcept { FreeTracked(block, false); }
+void  operator delete[](void* block) noexcept { FreeTracked(block, false); }
+void  operator delete(void* block, size_t) noexcept { FreeTracked(block, false); }
+void  operator delete[](void* block, size_t) noexcept { FreeTracked(block, false); }
+void  operator delete(void* block, std::align_val_t const alignment) noexcept { FreeTracked(block, static_cast<size_t>(alignment) > sizeof(AllocationHeader)); }
+void  operator delete[](void* block, std::align_val_t const alignment) noexcept { FreeTracked(block, static_cast<size_t>(alignment) > sizeof(AllocationHeader)); }
+void  operator delete(void* block, size_t, std::align_val_t const alignment) noexcept { FreeTracked(block, static_cast<size_t>(alignment) > sizeof(AllocationHeader)); }
+void  operator delete[](void* block, size_t, std::align_val_t const alignment) noexcept { FreeTracked(block, static_cast<size_t>(alignment) > sizeof(AllocationHeader)); }
+
+//----------------------------------------------------------------------------------------------------
+static bool IsAllocatorPlumbing(String const& frameName)
+{
+    for (char const* plumbing : {"std::", "operator new", "AllocateTracked", "RecordAllocation", "CaptureCallSiteFrames", "_ZNSt", "_Znw"})
+    {
+        if (frameName.find(plumbing) != String::npos) return true;
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The innermost frame that is not allocator plumbing, as "Function (File.cpp:Line)".
+//
+static String DescribeCallSite(AllocationCallSite const& site)
+{
+#if defined(_WIN32)
+    static bool s_areSymbolsLoaded = false;
+
+    HANDLE const process = GetCurrentProcess();
+
+    if (!s_areSymbolsLoaded)
+    {
+        SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+        s_areSymbolsLoaded = SymInitialize(process, nullptr, TRUE) == TRUE;
+    }
+
+    String fallback;
+
+    for (void* frame : site.m_frames)
+    {
+        if (!frame) break;
+
+        alignas(SYMBOL_INFO) char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME] = {};
+        SYMBOL_INFO*              symbol                                            = reinterpret_cast<SYMBOL_INFO*>(symbolBuffer);
+
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen   = MAX_SYM_NAME;
+
+        DWORD64 const address = reinterpret_cast<DWORD64>(frame);
+
+        if (!s_areSymbolsLoaded || !SymFromAddr(process, address, nullptr, symbol)) continue;
+
+        IMAGEHLP_LINE64 line         = {};
+        DWORD           displacement = 0;
+
+        line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+
+        String const description = SymGetLineFromAddr64(process, address, &displacement, &line)
+                                       ? Stringf("%s (%s:%lu)", symbol->Name, line.FileName, line.LineNumber)
+                                       : String(symbol->Name);
+
+        if (fallback.empty()) fallback = description;
+
+        if (!IsAllocatorPlumbing(symbol->Name)) return description;
+    }
+
+    return fallback.empty() ? Stringf("%p", site.m_frames[0]) : fallback;
+#elif defined(__linux__)
+    int numFrames = 0;
+
+    while (numFrames < NUM_CALL_SITE_FRAMES && site.m_frames[numFrames])
+    {
+        ++numFrames;
+    }
+
+    char** symbols = numFrames > 0 ? backtrace_symbols(site.m_frames, numFrames) : nullptr;
+
+    if (!symbols) return Stringf("%p", site.m_frames[0]);
+
+    String description = symbols[0];
+
+    for (int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+    {
+        if (!IsAllocatorPlumbing(symbols[frameIndex]))
+        {
+            description = symbols[frameIndex];
+            break;
+        }
+    }
+
+    std::free(symbols);
+
+    return description;
+#else
+    return Stringf("%p", site.m_frames[0]);
+#endif
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------
+// Call once per frame on the main thread. The next frame's peak starts from the live heap as it is now.
+//
+STATIC void AllocationTracker::EndFrame()
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    int64_t const liveBytes = s_liveBytes.load(std::memory_order_relaxed);
+
+    s_lastFrameStats.m_numAllocations = s_frameNumAllocations.exchange(0, std::memory_order_relaxed);
+    s_lastFrameStats.m_numBytes       = s_frameNumBytes.exchange(0, std::memory_order_relaxed);
+    s_lastFrameStats.m_numFrees       = s_frameNumFrees.exchange(0, std::memory_order_relaxed);
+    s_lastFrameStats.m_peakLiveBytes  = std::max(s_framePeakLiveBytes.exchange(liveBytes, std::memory_order_relaxed), liveBytes);
+    s_lastFrameStats.m_liveBytes      = liveBytes;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC AllocationFrameStats AllocationTracker::GetLastFrameStats()
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    return s_lastFrameStats;
+#else
+    return AllocationFrameStats();
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int64_t AllocationTracker::GetTotalNumAllocations()
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    return s_totalNumAllocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int64_t AllocationTracker::GetTotalNumAllocatedBytes()
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    return s_totalNumBytes.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+// Makes zoneName the calling thread's current zone and returns the one it replaces, for the caller
+// to restore. ProfileScope does this for every PROFILE_SCOPE.
+//
+STATIC char const* AllocationTracker::SetCurrentZone(char const* zoneName)
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    char const* previousZone = t_currentZone;
+
+    t_currentZone = zoneName;
+
+    return previousZone;
+#else
+    UNUSED(zoneName)
+
+    return nullptr;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+// Prints the last frame's totals, the zones that allocated most, and the top numCallSites call sites
+// ordered by sortKey: "bytes" (all-time bytes), "count" (all-time allocations) or "live" (bytes still
+// held, which is where leaks show up).
+//
+STATIC void AllocationTracker::ReportToDevConsole(int const numCallSites, String const& sortKey)
+{
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    // Copied out before sorting; the copies are allocated before the lock is taken
+    std::vector<AllocationCallSite> sites(MAX_CALL_SITES);
+    std::vector<AllocationZone>     zones(MAX_ZONES);
+
+    {
+        AllocationTablesLock const lock;
+
+        std::copy(s_callSites, s_callSites + MAX_CALL_SITES, sites.begin());
+        std::copy(s_zones, s_zones + MAX_ZONES, zones.begin());
+    }
+
+    zones[0].m_name = "(no zone)";
+
+    AllocationFrameStats const& frame = s_lastFrameStats;
+
+    g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("Last frame: %lld allocations, %lld bytes, %lld frees, peak %lld live bytes, %lld live at end",
+                                                   static_cast<long long>(frame.m_numAllocations),
+                                                   static_cast<long long>(frame.m_numBytes),
+                                                   static_cast<long long>(frame.m_numFrees),
+                                                   static_cast<long long>(frame.m_peakLiveBytes),
+                                                   static_cast<long long>(frame.m_liveBytes)));
+
+    zones.erase(std::remove_if(zones.begin(), zones.end(), [](AllocationZone const& zone) { return zone.m_numAllocations == 0; }), zones.end());
+    std::sort(zones.begin(), zones.end(), [](AllocationZone const& a, AllocationZone const& b) { return a.m_numBytes > b.m_numBytes; });
+
+    g_theDevConsole->AddLine(Rgba8::WHITE, "Zones by bytes allocated (all time):");
+
+    for (size_t zoneIndex = 0; zoneIndex < zones.size() && zoneIndex < 8; ++zoneIndex)
+    {
+        g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("  %12lld bytes %9lld allocs  %s",
+                                                       static_cast<long long>(zones[zoneIndex].m_numBytes),
+                                                       static_cast<long long>(zones[zoneIndex].m_numAllocations),
+                                                       zones[zoneIndex].m_name));
+    }
+
+    auto const getSortValue = [&sortKey](AllocationCallSite const& site)
+    {
+        if (sortKey == "count") return site.m_numAllocations;
+        if (sortKey == "live") return site.m_numLiveBytes;
+        return site.m_numBytes;
+    };
+
+    sites.erase(std::remove_if(sites.begin(), sites.end(), [](AllocationCallSite const& site) { return site.m_numAllocations == 0; }), sites.end());
+    std::sort(sites.begin(), sites.end(), [&getSortValue](AllocationCallSite const& a, AllocationCallSite const& b) { return getSortValue(a) > getSortValue(b); });
+
+    g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("Top %d of %d call sites by %s:", std::min(numCallSites, static_cast<int>(sites.size())), static_cast<int>(sites.size()), sortKey.c_str()));
+
+    for (int siteIndex = 0; siteIndex < numCallSites && siteIndex < static_cast<int>(sites.size()); ++siteIndex)
+    {
+        AllocationCallSite const& site = sites[siteIndex];
+
+        g_theDevConsole->AddLine(site.m_numLiveAllocations > 0 ? Rgba8::YELLOW : Rgba8::WHITE,
+                                 Stringf("  %12lld bytes %9lld allocs %9lld live (%lld bytes)  %s",
+                                         static_cast<long long>(site.m_numBytes),
+                                         static_cast<long long>(site.m_numAllocations),
+                                         static_cast<long long>(site.m_numLiveAllocations),
+                                         static_cast<long long>(site.m_numLiveBytes),
+                                         site.m_isUsed ? DescribeCallSite(site).c_str() : "(untracked or table full)"));
+    }
+#else
+    UNUSED(numCallSites)
+    UNUSED(sortKey)
+
+    g_theDevConsole->AddLine(Rgba8::RED, "AllocationTracker: compiled out (GAME_ENABLE_ALLOCATION_TRACKING is not defined)");
+#endif
+}
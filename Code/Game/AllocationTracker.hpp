@@ -0,0 +1,38 @@
+//----------------------------------------------------------------------------------------------------
+// AllocationTracker.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/GameBuildPreferences.hpp"
+
+//----------------------------------------------------------------------------------------------------
+struct AllocationFrameStats
+{
+    int64_t m_numAllocations = 0;
+    int64_t m_numBytes       = 0;
+    int64_t m_numFrees       = 0;
+    int64_t m_peakLiveBytes  = 0;              // Highest live heap seen during the frame
+    int64_t m_liveBytes      = 0;              // Live heap when the frame ended
+};
+
+//----------------------------------------------------------------------------------------------------
+// Heap instrumentation. With GAME_ENABLE_ALLOCATION_TRACKING defined, the global operator new and
+// delete are replaced: every allocation is charged to the frame, to the innermost PROFILE_SCOPE zone
+// on its thread, and to its call site (a short stack trace), and frees are matched back so sites
+// that keep memory alive show up as leaks. Without it everything here is inert and reports zeros.
+//
+class AllocationTracker
+{
+public:
+    static void                 EndFrame();
+    static AllocationFrameStats GetLastFrameStats();
+    static int64_t              GetTotalNumAllocations();
+    static int64_t              GetTotalNumAllocatedBytes();
+    static char const*          SetCurrentZone(char const* zoneName);
+
+    static void ReportToDevConsole(int numCallSites, String const& sortKey);
+};
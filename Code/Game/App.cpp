@@ -5,6 +5,9 @@
 //-----------------------------------------------------------------------------------------------
 #include "Game/App.hpp"
 
+#include <algorithm>
+#include <thread>
+
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/DevConsole.hpp"
@@ -17,17 +20,27 @@
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Window.hpp"
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Benchmark/MapBenchmark.hpp"
+#include "Game/AllocationTracker.hpp"
+#include "Game/AssetPreloader.hpp"
+#include "Game/DefinitionCache.hpp"
 #include "Game/Game.hpp"
+#include "Game/GameAudioSystem.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Log.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/WorkerPool.hpp"
 
 //-----------------------------------------------------------------------------------------------
 App*                   g_theApp        = nullptr; // Created and owned by Main_Windows.cpp
-AudioSystem*           g_theAudio      = nullptr; // Created and owned by the App
+GameAudioSystem*       g_theAudio      = nullptr; // Created and owned by the App
 BitmapFont*            g_theBitmapFont = nullptr; // Created and owned by the App
 Game*                  g_theGame       = nullptr; // Created and owned by the App
 Renderer*              g_theRenderer   = nullptr; // Created and owned by the App
 RandomNumberGenerator* g_theRNG        = nullptr; // Created and owned by the App
 Window*                g_theWindow     = nullptr; // Created and owned by the App
+WorkerPool*            g_theWorkerPool = nullptr; // Created and owned by the App
 
 //----------------------------------------------------------------------------------------------------
 STATIC bool App::m_isQuitting = false;
@@ -37,11 +50,36 @@ void App::Startup()
 {
     LoadGameConfig("Data/GameConfig.xml");
 
+    Log::Startup(g_gameConfigBlackboard.GetValue("logFilePath", ""));
+    Profiler::Startup();
+
+    // The calling thread also runs work while it waits, so one core is left for it
+    int workerThreadCount = g_gameConfigBlackboard.GetValue("workerThreadCount", -1);
+
+    if (workerThreadCount < 0)
+    {
+        workerThreadCount = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+    }
+
+    g_theWorkerPool = new WorkerPool(workerThreadCount);
+
+    // Textures are decoded and sounds read on the workers while the Engine subsystems below start up
+    AssetPreloader assetPreloader;
+    assetPreloader.LoadManifest("Data/Definitions/AssetManifest.xml");
+    assetPreloader.BeginLoads(*g_theWorkerPool);
+
     // Create All Engine Subsystems
     EventSystemConfig eventSystemConfig;
     g_theEventSystem = new EventSystem(eventSystemConfig);
     g_theEventSystem->SubscribeEventCallbackFunction("OnCloseButtonClicked", OnCloseButtonClicked);
     g_theEventSystem->SubscribeEventCallbackFunction("quit", OnCloseButtonClicked);
+    g_theEventSystem->SubscribeEventCallbackFunction("perf.capture", OnPerfCapture);
+    g_theEventSystem->SubscribeEventCallbackFunction("mem.report", OnMemReport);
+    g_theEventSystem->SubscribeEventCallbackFunction("perf.stats", OnPerfStats);
+    g_theEventSystem->SubscribeEventCallbackFunction("sim.spawn", OnSimSpawn);
+    g_theEventSystem->SubscribeEventCallbackFunction("sim.timescale", OnSimTimeScale);
+    g_theEventSystem->SubscribeEventCallbackFunction("sim.step", OnSimStep);
+    g_theEventSystem->SubscribeEventCallbackFunction("bench.run", OnBenchRun);
 
     InputSystemConfig inputConfig;
     g_theInput = new InputSystem(inputConfig);
@@ -84,7 +122,7 @@ void App::Startup()
     g_theDevConsole                    = new DevConsole(devConsoleConfig);
 
     AudioSystemConfig audioConfig;
-    g_theAudio = new AudioSystem(audioConfig);
+    g_theAudio = new GameAudioSystem(audioConfig);
 
     g_theEventSystem->Startup();
     g_theInput->Startup();
@@ -95,7 +133,10 @@ void App::Startup()
 
     g_theBitmapFont = g_theRenderer->CreateOrGetBitmapFontFromFile("Data/Fonts/SquirrelFixedFont"); // DO NOT SPECIFY FILE .EXTENSION!!  (Important later on.)
     g_theRNG        = new RandomNumberGenerator();
-    g_theGame       = new Game();
+
+    assetPreloader.FinishAndCreate();
+
+    g_theGame = new Game();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -106,6 +147,12 @@ void App::Shutdown()
     delete g_theGame;
     g_theGame = nullptr;
 
+    delete g_theWorkerPool;
+    g_theWorkerPool = nullptr;
+
+    Profiler::Shutdown();
+    Log::Shutdown();
+
     delete g_theRNG;
     g_theRNG = nullptr;
 
@@ -144,6 +191,8 @@ void App::Shutdown()
 //
 void App::RunFrame()
 {
+    PROFILE_SCOPE("App::RunFrame");
+
     float const currentTime  = static_cast<float>(GetCurrentTimeSeconds());
     float const deltaSeconds = currentTime - m_timeLastFrameStart;
     m_timeLastFrameStart     = currentTime;
@@ -164,6 +213,8 @@ void App::RunMainLoop()
     {
         // Sleep(16); // Temporary code to "slow down" our app to ~60Hz until we have proper frame timing in
         RunFrame();
+        Profiler::EndFrame();
+        AllocationTracker::EndFrame();
     }
 }
 
@@ -177,6 +228,139 @@ STATIC bool App::OnCloseButtonClicked(EventArgs& args)
     return true;
 }
 
+//----------------------------------------------------------------------------------------------------
+// perf.capture frames=N file=Path.json
+//
+STATIC bool App::OnPerfCapture(EventArgs& args)
+{
+    int const    numFrames = args.GetValue("frames", 60);
+    String const filePath  = args.GetValue("file", "ProfileCapture.json");
+
+    Profiler::RequestCapture(numFrames, filePath);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// mem.report top=N sort=bytes|count|live
+//
+STATIC bool App::OnMemReport(EventArgs& args)
+{
+    int const    numCallSites = args.GetValue("top", 10);
+    String const sortKey      = args.GetValue("sort", "bytes");
+
+    AllocationTracker::ReportToDevConsole(numCallSites, sortKey);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// perf.stats
+//
+STATIC bool App::OnPerfStats(EventArgs& args)
+{
+    UNUSED(args)
+
+    g_theGame->ReportPerformanceStats();
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// sim.spawn type=Leo count=N
+//
+STATIC bool App::OnSimSpawn(EventArgs& args)
+{
+    String const     typeName = args.GetValue("type", "Leo");
+    int const        count    = args.GetValue("count", 10);
+    EntityType const type     = GetEntityTypeFromName(typeName);
+
+    if (type == ENTITY_TYPE_UNKNOWN || type == ENTITY_TYPE_PLAYER_TANK)
+    {
+        g_theDevConsole->AddLine(Rgba8::RED, Stringf("sim.spawn: cannot spawn \"%s\"; use Scorpio, Leo, Aries, Capricorn, Bullet, Explosion or Debris", typeName.c_str()));
+        return false;
+    }
+
+    int const numSpawned = g_theGame->SpawnEntities(type, count);
+
+    g_theDevConsole->AddLine(Rgba8::GREEN, Stringf("sim.spawn: %d of %d %s spawned", numSpawned, count, typeName.c_str()));
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// sim.timescale scale=X; without scale it prints the current one
+//
+STATIC bool App::OnSimTimeScale(EventArgs& args)
+{
+    float const timeScale = args.GetValue("scale", g_theGame->GetTimeScale());
+
+    if (timeScale < 0.f)
+    {
+        g_theDevConsole->AddLine(Rgba8::RED, "sim.timescale: scale must not be negative");
+        return false;
+    }
+
+    g_theGame->SetTimeScale(timeScale);
+    g_theDevConsole->AddLine(Rgba8::GREEN, Stringf("sim.timescale: %.2f", timeScale));
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// sim.step ticks=N dt=Seconds
+//
+STATIC bool App::OnSimStep(EventArgs& args)
+{
+    int const   numTicks          = args.GetValue("ticks", 600);
+    float const fixedDeltaSeconds = args.GetValue("dt", 1.f / 60.f);
+
+    if (numTicks <= 0 || fixedDeltaSeconds <= 0.f)
+    {
+        g_theDevConsole->AddLine(Rgba8::RED, "sim.step: ticks and dt must be positive");
+        return false;
+    }
+
+    g_theGame->StepSimulation(numTicks, fixedDeltaSeconds);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// bench.run name=Substring time=Seconds
+// Runs the Map micro benchmarks whose names contain Substring, on this thread, so the game stalls
+// until they finish. Allocation counts read zero unless GAME_ENABLE_ALLOCATION_TRACKING is on; only
+// the Benchmark executable replaces operator new to count them.
+//
+STATIC bool App::OnBenchRun(EventArgs& args)
+{
+    BenchmarkConfig config;
+
+    config.m_filter                 = args.GetValue("name", "");
+    config.m_minSecondsPerBenchmark = static_cast<double>(args.GetValue("time", 0.05f));
+    config.m_isPrintingResults      = false;
+
+    if (config.m_filter.empty())
+    {
+        g_theDevConsole->AddLine(Rgba8::RED, "bench.run: give name=Substring, e.g. name=Raycast or name=Pathfinding/GenerateEntityPathToGoal");
+        return false;
+    }
+
+    BenchmarkRunner runner(config);
+    MapBenchmark    mapBenchmark(runner);
+
+    mapBenchmark.RunAll();
+
+    for (BenchmarkResult const& result : runner.GetResults())
+    {
+        g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("%-64s %12.1f ns/op %10.3f allocs/op", result.m_name.c_str(), result.m_nanosecondsPerOp, result.m_allocationsPerOp));
+    }
+
+    g_theDevConsole->AddLine(Rgba8::GREEN, Stringf("bench.run: %d results for \"%s\"", static_cast<int>(runner.GetResults().size()), config.m_filter.c_str()));
+
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------
 STATIC void App::RequestQuit()
 {
@@ -186,6 +370,8 @@ STATIC void App::RequestQuit()
 //-----------------------------------------------------------------------------------------------
 void App::BeginFrame() const
 {
+    PROFILE_SCOPE("App::BeginFrame");
+
     g_theEventSystem->BeginFrame();
     g_theInput->BeginFrame();
     g_theWindow->BeginFrame();
@@ -200,6 +386,8 @@ void App::BeginFrame() const
 //-----------------------------------------------------------------------------------------------
 void App::Update(const float deltaSeconds)
 {
+    PROFILE_SCOPE("App::Update");
+
     Clock::TickSystemClock();
 
     if (g_theGame->IsMarkedForDelete()) DeleteAndCreateNewGame();
@@ -218,6 +406,8 @@ void App::Update(const float deltaSeconds)
 //
 void App::Render() const
 {
+    PROFILE_SCOPE("App::Render");
+
     g_theRenderer->ClearScreen(Rgba8::BLACK);
     g_theGame->Render();
 
@@ -229,6 +419,8 @@ void App::Render() const
 //-----------------------------------------------------------------------------------------------
 void App::EndFrame() const
 {
+    PROFILE_SCOPE("App::EndFrame");
+
     g_theEventSystem->EndFrame();
     g_theInput->EndFrame();
     g_theWindow->EndFrame();
@@ -283,8 +475,35 @@ void App::DeleteAndCreateNewGame()
 }
 
 //----------------------------------------------------------------------------------------------------
+// The root element's attributes are cached as key/value pairs in GameConfig.xml.cache, so a launch with
+// an unchanged config sets them straight from the cache without parsing the XML.
+//
 void App::LoadGameConfig(char const* gameConfigXmlFilePath)
 {
+    DefinitionCacheReader cacheReader;
+
+    if (cacheReader.Open(gameConfigXmlFilePath))
+    {
+        int const  numPairs = cacheReader.ReadInt();
+        StringList keysAndValues;
+
+        for (int pairIndex = 0; pairIndex < numPairs && !cacheReader.HasFailed(); ++pairIndex)
+        {
+            keysAndValues.push_back(cacheReader.ReadString());
+            keysAndValues.push_back(cacheReader.ReadString());
+        }
+
+        if (!cacheReader.HasFailed())
+        {
+            for (size_t keyIndex = 0; keyIndex + 1 < keysAndValues.size(); keyIndex += 2)
+            {
+                g_gameConfigBlackboard.SetValue(keysAndValues[keyIndex], keysAndValues[keyIndex + 1]);
+            }
+
+            return;
+        }
+    }
+
     XmlDocument     gameConfigXml;
     XmlResult const result = gameConfigXml.LoadFile(gameConfigXmlFilePath);
 
@@ -293,14 +512,32 @@ void App::LoadGameConfig(char const* gameConfigXmlFilePath)
         if (XmlElement const* rootElement = gameConfigXml.RootElement())
         {
             g_gameConfigBlackboard.PopulateFromXmlElementAttributes(*rootElement);
+
+            DefinitionCacheWriter cacheWriter(cacheReader.GetSourceHash());
+            int                   numPairs = 0;
+
+            for (XmlAttribute const* attribute = rootElement->FirstAttribute(); attribute != nullptr; attribute = attribute->Next())
+            {
+                ++numPairs;
+            }
+
+            cacheWriter.WriteInt(numPairs);
+
+            for (XmlAttribute const* attribute = rootElement->FirstAttribute(); attribute != nullptr; attribute = attribute->Next())
+            {
+                cacheWriter.WriteString(attribute->Name());
+                cacheWriter.WriteString(attribute->Value());
+            }
+
+            cacheWriter.Save(gameConfigXmlFilePath);
         }
         else
         {
-            printf("WARNING: game config from file \"%s\" was invalid (missing root element)\n", gameConfigXmlFilePath);
+            GAME_LOG(LOG_CATEGORY_APP, LOG_LEVEL_WARNING, "game config from file \"%s\" was invalid (missing root element)", gameConfigXmlFilePath);
         }
     }
     else
     {
-        printf("WARNING: failed to load game config from file \"%s\"\n", gameConfigXmlFilePath);
+        GAME_LOG(LOG_CATEGORY_APP, LOG_LEVEL_WARNING, "failed to load game config from file \"%s\"", gameConfigXmlFilePath);
     }
 }
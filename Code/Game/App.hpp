@@ -22,6 +22,13 @@ public:
     void RunMainLoop();
 
     static bool OnCloseButtonClicked(EventArgs& args);
+    static bool OnPerfCapture(EventArgs& args);
+    static bool OnMemReport(EventArgs& args);
+    static bool OnPerfStats(EventArgs& args);
+    static bool OnSimSpawn(EventArgs& args);
+    static bool OnSimTimeScale(EventArgs& args);
+    static bool OnSimStep(EventArgs& args);
+    static bool OnBenchRun(EventArgs& args);
     static void RequestQuit();
     static bool m_isQuitting;
 
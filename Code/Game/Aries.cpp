@@ -11,25 +11,13 @@
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
+#include "Game/PathArena.hpp"
 #include "Game/PlayerTank.hpp"
 
 //----------------------------------------------------------------------------------------------------
 Aries::Aries(Map* map, EntityType const type, EntityFaction const faction)
     : Entity(map, type, faction)
 {
-    m_physicsRadius      = g_gameConfigBlackboard.GetValue("ariesPhysicsRadius", 0.25f);
-    m_detectRange        = g_gameConfigBlackboard.GetValue("ariesDetectRange", 10.f);
-    m_moveSpeed          = g_gameConfigBlackboard.GetValue("ariesMoveSpeed", 0.5f);
-    m_rotateSpeed        = g_gameConfigBlackboard.GetValue("ariesRotateSpeed", 90.f);
-    m_health             = g_gameConfigBlackboard.GetValue("ariesInitHealth", 8);
-    m_isPushedByWalls    = g_gameConfigBlackboard.GetValue("ariesIsPushedByWalls", true);
-    m_isPushedByEntities = g_gameConfigBlackboard.GetValue("ariesIsPushedByEntities", true);
-    m_doesPushEntities   = g_gameConfigBlackboard.GetValue("ariesDoesPushEntities", true);
-    m_canSwim            = g_gameConfigBlackboard.GetValue("ariesCanSwim", false);
-
-    m_totalHealth = m_health;
-    
-    m_bodyTexture = g_theRenderer->CreateOrGetTextureFromFile(ARIES_BODY_IMG);
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -38,12 +26,14 @@ void Aries::Update(const float deltaSeconds)
     if (m_isDead)
         return;
 
-    if (g_theGame->GetPlayerTank()->m_isDead)
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
+
+    if (playerTank && playerTank->m_isDead)
         return;
 
     if (m_health <= 0)
     {
-        g_theAudio->StartSound(g_theGame->GetEnemyDiedSoundID());
+        m_map->PostSoundEvent(g_theGame->GetEnemyDiedSoundID(), m_position, SOUND_PRIORITY_HIGH);
         m_map->SpawnNewEntity(ENTITY_TYPE_EXPLOSION, ENTITY_FACTION_NEUTRAL, m_position, m_orientationDegrees);
         m_isGarbage = true;
         m_isDead    = true;
@@ -95,15 +85,18 @@ void Aries::DebugRender() const
                         Rgba8::GREY,
                         1.f);
 
-    DebugDrawLine(m_position,
-                  m_pathPoints.back(),
-                  0.05f,
-                  Rgba8::WHITE);
-
-    DebugDrawGlowCircle(m_pathPoints.back(),
-                        0.1f,
-                        Rgba8::WHITE,
-                        1.f);
+    if (m_path && !m_path->IsEmpty())
+    {
+        DebugDrawLine(m_position,
+                      m_path->Back(),
+                      0.05f,
+                      Rgba8::WHITE);
+
+        DebugDrawGlowCircle(m_path->Back(),
+                            0.1f,
+                            Rgba8::WHITE,
+                            1.f);
+    }
 
 
     DebugDrawLine(m_position,
@@ -117,10 +110,7 @@ void Aries::UpdateBody(const float deltaSeconds)
 {
     m_timeSinceLastRoll += deltaSeconds;
 
-    PlayerTank const* playerTank = g_theGame->GetPlayerTank();
-
-    if (!playerTank)
-        return;
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
 
     Vec2 const  dispToTarget    = m_goalPosition - m_position;
     Vec2 const  fwdNormal       = Vec2::MakeFromPolarDegrees(m_orientationDegrees);
@@ -142,7 +132,7 @@ void Aries::UpdateBody(const float deltaSeconds)
     }
 
     // TurnToward if entity sees target
-    if (m_map->HasLineOfSight(m_position, playerTank->m_position, m_detectRange))
+    if (playerTank && m_map->HasLineOfSightToPlayer(m_position, m_detectRange))
     {
         m_hasTarget = true;
 
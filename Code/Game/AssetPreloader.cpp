@@ -0,0 +1,159 @@
+//----------------------------------------------------------------------------------------------------
+// AssetPreloader.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/AssetPreloader.hpp"
+
+#include <chrono>
+#include <fstream>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Game/GameAudioSystem.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Log.hpp"
+#include "Game/Profiler.hpp"
+
+//----------------------------------------------------------------------------------------------------
+static int64_t GetSteadyTicks()
+{
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+//----------------------------------------------------------------------------------------------------
+static double GetMillisecondsSince(int64_t const startTicks)
+{
+    using Period = std::chrono::steady_clock::period;
+
+    return static_cast<double>(GetSteadyTicks() - startTicks) * 1000.0 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+}
+
+//----------------------------------------------------------------------------------------------------
+// -1 when the file cannot be opened, so a missing asset is reported instead of failing inside a decoder.
+//
+static int64_t GetFileSize(String const& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+    if (!file) return -1;
+
+    return static_cast<int64_t>(file.tellg());
+}
+
+//----------------------------------------------------------------------------------------------------
+bool AssetPreloader::LoadManifest(String const& manifestPath)
+{
+    XmlDocument manifestXml;
+
+    if (manifestXml.LoadFile(manifestPath.c_str()) != XmlResult::XML_SUCCESS)
+    {
+        GAME_LOG(LOG_CATEGORY_ASSETS, LOG_LEVEL_WARNING, "failed to load asset manifest from file \"%s\"", manifestPath);
+        return false;
+    }
+
+    XmlElement const* root = manifestXml.FirstChildElement("AssetManifest");
+
+    if (!root) return false;
+
+    for (XmlElement const* element = root->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+    {
+        AssetManifestEntry entry;
+        String const       elementName = element->Name();
+
+        if (elementName == "Texture") entry.m_type = ASSET_TYPE_TEXTURE;
+        else if (elementName == "Sound") entry.m_type = ASSET_TYPE_SOUND;
+        else continue;
+
+        entry.m_path = ParseXmlAttribute(*element, "path", "");
+
+        if (!entry.m_path.empty()) m_entries.push_back(std::move(entry));
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Each task index writes only its own entry, so the entries need no lock.
+//
+void AssetPreloader::BeginLoads(WorkerPool& workerPool)
+{
+    m_workerPool     = &workerPool;
+    m_loadStartTicks = GetSteadyTicks();
+    m_loadTask       = workerPool.Submit([this](int const entryIndex)
+    {
+        LoadEntry(m_entries[entryIndex]);
+    }, static_cast<int>(m_entries.size()));
+}
+
+//----------------------------------------------------------------------------------------------------
+// Runs on a worker: everything up to, but not including, creating the Renderer or FMOD object.
+//
+STATIC void AssetPreloader::LoadEntry(AssetManifestEntry& entry)
+{
+    PROFILE_SCOPE("AssetPreloader::LoadEntry");
+
+    entry.m_numBytes = GetFileSize(entry.m_path);
+
+    if (entry.m_numBytes < 0) return;
+
+    if (entry.m_type == ASSET_TYPE_TEXTURE)
+    {
+        entry.m_image = std::make_unique<Image>(entry.m_path.c_str());
+        return;
+    }
+
+    std::ifstream file(entry.m_path, std::ios::in | std::ios::binary);
+
+    entry.m_fileBytes.resize(static_cast<size_t>(entry.m_numBytes));
+    file.read(reinterpret_cast<char*>(entry.m_fileBytes.data()), static_cast<std::streamsize>(entry.m_fileBytes.size()));
+
+    if (!file) entry.m_numBytes = -1;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Files that could not be read are left for their owner to load (and report) as before.
+//
+void AssetPreloader::FinishAndCreate()
+{
+    if (m_workerPool) m_workerPool->Wait(m_loadTask);
+
+    double const  loadMilliseconds            = GetMillisecondsSince(m_loadStartTicks);
+    int64_t const createStartTicks            = GetSteadyTicks();
+    int64_t       numBytesRead                = 0;
+    int           numCreated[NUM_ASSET_TYPES] = {};
+
+    for (AssetManifestEntry& entry : m_entries)
+    {
+        if (entry.m_numBytes < 0)
+        {
+            GAME_LOG(LOG_CATEGORY_ASSETS, LOG_LEVEL_WARNING, "asset manifest entry \"%s\" could not be read", entry.m_path);
+            continue;
+        }
+
+        numBytesRead += entry.m_numBytes;
+
+        // A texture an earlier startup step already loaded from the same file is kept
+        if (entry.m_type == ASSET_TYPE_TEXTURE && !g_theRenderer->GetTextureForFileName(entry.m_path.c_str())) g_theRenderer->CreateTextureFromImage(*entry.m_image);
+        else if (entry.m_type == ASSET_TYPE_SOUND) g_theAudio->CreateOrGetSoundFromMemory(entry.m_path, entry.m_fileBytes);
+
+        entry.m_image.reset();
+        entry.m_fileBytes.clear();
+        entry.m_fileBytes.shrink_to_fit();
+
+        ++numCreated[entry.m_type];
+    }
+
+    GAME_LOG(LOG_CATEGORY_ASSETS,
+             LOG_LEVEL_INFO,
+             "( App ) Preloaded %d textures and %d sounds: %.1f MB decoded and read in %.1f ms, created in %.1f ms",
+             numCreated[ASSET_TYPE_TEXTURE],
+             numCreated[ASSET_TYPE_SOUND],
+             static_cast<double>(numBytesRead) / (1024.0 * 1024.0),
+             loadMilliseconds,
+             GetMillisecondsSince(createStartTicks));
+
+    m_loadTask.reset();
+    m_workerPool = nullptr;
+}
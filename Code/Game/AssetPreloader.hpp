@@ -0,0 +1,55 @@
+//----------------------------------------------------------------------------------------------------
+// AssetPreloader.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/WorkerPool.hpp"
+
+//----------------------------------------------------------------------------------------------------
+enum AssetType : int
+{
+    ASSET_TYPE_TEXTURE,
+    ASSET_TYPE_SOUND,
+    NUM_ASSET_TYPES
+};
+
+//----------------------------------------------------------------------------------------------------
+struct AssetManifestEntry
+{
+    AssetType              m_type     = ASSET_TYPE_TEXTURE;
+    String                 m_path;
+    int64_t                m_numBytes = -1;     // -1 until loaded; stays -1 if the file could not be opened
+    std::unique_ptr<Image> m_image;             // Textures: decoded pixels, released once the texture exists
+    std::vector<uint8_t>   m_fileBytes;         // Sounds: the file as read, released once the sound exists
+};
+
+//----------------------------------------------------------------------------------------------------
+// Loads everything in Data/Definitions/AssetManifest.xml during App::Startup so that no texture or
+// sound is first created inside a gameplay frame. BeginLoads() queues one WorkerPool task per file,
+// and while the window, renderer and audio system start up the workers decode each texture into an
+// Image and read each sound's bytes into memory. FinishAndCreate() is the barrier: it waits for the
+// workers, then does only what has to happen on the main thread, creating a GPU texture from each
+// Image and an FMOD sound from each buffer. Sounds stay compressed, so nothing is decoded there either.
+//
+class AssetPreloader
+{
+public:
+    bool LoadManifest(String const& manifestPath);
+    void BeginLoads(WorkerPool& workerPool);
+    void FinishAndCreate();
+
+private:
+    static void LoadEntry(AssetManifestEntry& entry);
+
+    std::vector<AssetManifestEntry> m_entries;
+    WorkerPool*                     m_workerPool = nullptr;
+    WorkerTaskHandle                m_loadTask;
+    int64_t                         m_loadStartTicks = 0;
+};
@@ -22,6 +22,4 @@ public:
 private:
     void UpdateBody(float deltaSeconds);
     void RenderBody() const;
-    
-    Texture* m_BodyTexture = nullptr;
 };
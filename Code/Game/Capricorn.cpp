@@ -5,35 +5,27 @@
 //----------------------------------------------------------------------------------------------------
 #include "Game/Capricorn.hpp"
 
-#include "Engine/Core/HeatMaps.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Game/EntityDefinition.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
+#include "Game/PathArena.hpp"
 #include "Game/PlayerTank.hpp"
+#include "Game/TileDistanceField.hpp"
 
 //----------------------------------------------------------------------------------------------------
 Capricorn::Capricorn(Map* map, EntityType const type, EntityFaction const faction)
     : Entity(map, type, faction)
 {
-    m_physicsRadius      = g_gameConfigBlackboard.GetValue("leoPhysicsRadius", 0.25f);
-    m_detectRange        = g_gameConfigBlackboard.GetValue("leoDetectRange", 10.f);
-    m_moveSpeed          = g_gameConfigBlackboard.GetValue("leoMoveSpeed", 0.5f);
-    m_rotateSpeed        = g_gameConfigBlackboard.GetValue("leoRotateSpeed", 90.f);
-    m_health             = g_gameConfigBlackboard.GetValue("leoInitHealth", 3);
-    m_isPushedByWalls    = g_gameConfigBlackboard.GetValue("leoIsPushedByWalls", true);
-    m_isPushedByEntities = g_gameConfigBlackboard.GetValue("leoIsPushedByEntities", true);
-    m_doesPushEntities   = g_gameConfigBlackboard.GetValue("leoDoesPushEntities", true);
-    m_canSwim            = g_gameConfigBlackboard.GetValue("leoCanSwim", false);
-
-    m_bodyTexture = g_theRenderer->CreateOrGetTextureFromFile(LEO_BODY_IMG);
 }
 
 void Capricorn::DebugRenderTileIndex() const
 {
+    if (!m_distanceField) return;
 
     IntVec2 dimensions = m_map->GetMapDimension();
 
@@ -41,7 +33,7 @@ void Capricorn::DebugRenderTileIndex() const
     {
         for (int tileX = 0; tileX < dimensions.x; ++tileX)
         {
-            float const value = m_heatMap->GetValueAtCoords(tileX, tileY);
+            uint16_t const value = m_distanceField->GetValueAtCoords(tileX, tileY);
 
             VertexList_PCU textVerts;
             g_theBitmapFont->AddVertsForText2D(textVerts, std::to_string(static_cast<int>(value)),Vec2((float) tileX, (float) tileY), 0.2f,  Rgba8::BLACK);
@@ -57,12 +49,14 @@ void Capricorn::Update(float const deltaSeconds)
     if (m_isDead)
         return;
 
-    if (g_theGame->GetPlayerTank()->m_isDead)
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
+
+    if (playerTank && playerTank->m_isDead)
         return;
 
     if (m_health <= 0)
     {
-        g_theAudio->StartSound(g_theGame->GetEnemyDiedSoundID());
+        m_map->PostSoundEvent(g_theGame->GetEnemyDiedSoundID(), m_position, SOUND_PRIORITY_HIGH);
         m_isGarbage = true;
         m_isDead    = true;
     }
@@ -113,15 +107,18 @@ void Capricorn::DebugRender() const
                         Rgba8::GREY,
                         1.f);
 
-    DebugDrawLine(m_position,
-                  m_pathPoints.back(),
-                  0.05f,
-                  Rgba8::WHITE);
-
-    DebugDrawGlowCircle(m_pathPoints.back(),
-                        0.1f,
-                        Rgba8::WHITE,
-                        1.f);
+    if (m_path && !m_path->IsEmpty())
+    {
+        DebugDrawLine(m_position,
+                      m_path->Back(),
+                      0.05f,
+                      Rgba8::WHITE);
+
+        DebugDrawGlowCircle(m_path->Back(),
+                            0.1f,
+                            Rgba8::WHITE,
+                            1.f);
+    }
 
     DebugDrawLine(m_position,
                   m_position + fwdNormal,
@@ -136,10 +133,7 @@ void Capricorn::UpdateBody(float const deltaSeconds)
 
     UpdateShootCoolDown(deltaSeconds);
 
-    PlayerTank const* playerTank = g_theGame->GetPlayerTank();
-
-    if (!playerTank)
-        return;
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
 
     Vec2 const  dispToTarget    = m_goalPosition - m_position;
     Vec2 const  fwdNormal       = Vec2::MakeFromPolarDegrees(m_orientationDegrees);
@@ -155,17 +149,17 @@ void Capricorn::UpdateBody(float const deltaSeconds)
                    deltaSeconds,
                    m_rotateSpeed);
 
-        if (degreesToTarget < m_shootDegreesThreshold &&
+        if (degreesToTarget < m_definition->GetShootDegreesThreshold() &&
             m_shootCoolDown <= 0.0f)
         {
             m_map->SpawnNewEntity(ENTITY_TYPE_BULLET, ENTITY_FACTION_EVIL, m_position, m_orientationDegrees);
-            m_shootCoolDown = g_gameConfigBlackboard.GetValue("leoShootCoolDown", 1.f);
-            g_theAudio->StartSound(g_theGame->GetEnemyShootSoundID());
+            m_shootCoolDown = m_definition->GetShootCoolDown();
+            m_map->PostSoundEvent(g_theGame->GetEnemyShootSoundID(), m_position, SOUND_PRIORITY_NORMAL);
         }
     }
 
     // TurnToward if entity sees target
-    if (m_map->HasLineOfSight(m_position, playerTank->m_position, m_detectRange))
+    if (playerTank && m_map->HasLineOfSightToPlayer(m_position, m_detectRange))
     {
         m_hasTarget = true;
 
@@ -17,25 +17,6 @@
 Debris::Debris(Map* map, EntityType const type, EntityFaction const faction)
     : Entity(map, type, faction)
 {
-    m_isPushedByWalls    = g_gameConfigBlackboard.GetValue("bulletIsPushedByWalls", true);
-    m_isPushedByEntities = g_gameConfigBlackboard.GetValue("bulletIsPushedByEntities", true);
-    m_doesPushEntities   = g_gameConfigBlackboard.GetValue("bulletDoesPushEntities", true);
-
-    if (faction == ENTITY_FACTION_GOOD)
-    {
-        m_BodyTexture = g_theRenderer->CreateOrGetTextureFromFile(BULLET_GOOD_IMG);
-        m_health      = g_gameConfigBlackboard.GetValue("bulletGoodInitHealth", 3);
-        m_moveSpeed   = g_gameConfigBlackboard.GetValue("bulletGoodMoveSpeed", 5.f);
-    }
-    if (faction == ENTITY_FACTION_EVIL)
-    {
-        m_BodyTexture = g_theRenderer->CreateOrGetTextureFromFile(BULLET_EVIL_IMG);
-        m_health      = g_gameConfigBlackboard.GetValue("bulletEvilInitHealth", 1);
-        m_moveSpeed   = g_gameConfigBlackboard.GetValue("bulletEvilMoveSpeed", 3.f);
-    }
-
-    m_bodyBounds    = AABB2(Vec2(-0.1f, -0.05f), Vec2(0.1f, 0.05f));
-    m_physicsRadius = GetDistance2D(m_bodyBounds.m_mins, m_bodyBounds.m_maxs) * 0.5f;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -110,6 +91,6 @@ void Debris::RenderBody() const
     TransformVertexArrayXY3D(static_cast<int>(bodyVerts.size()), bodyVerts.data(),
                              1.f, m_orientationDegrees, m_position);
 
-    g_theRenderer->BindTexture(m_BodyTexture);
+    g_theRenderer->BindTexture(m_bodyTexture);
     g_theRenderer->DrawVertexArray(static_cast<int>(bodyVerts.size()), bodyVerts.data());
 }
@@ -0,0 +1,250 @@
+//----------------------------------------------------------------------------------------------------
+// DefinitionCache.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/DefinitionCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+//----------------------------------------------------------------------------------------------------
+static uint32_t constexpr DEFINITION_CACHE_MAGIC = 0x46434444;     // "DDCF" read as little-endian bytes
+
+//----------------------------------------------------------------------------------------------------
+struct DefinitionCacheHeader
+{
+    uint32_t m_magic       = DEFINITION_CACHE_MAGIC;
+    uint32_t m_version     = DEFINITION_CACHE_VERSION;
+    uint64_t m_payloadSize = 0;
+    uint64_t m_sourceHash  = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+static uint64_t HashBytesFNV1a(std::vector<uint8_t> const& bytes)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (uint8_t const byte : bytes)
+    {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------------------
+String GetDefinitionCachePath(String const& sourcePath)
+{
+    return sourcePath + ".cache";
+}
+
+//----------------------------------------------------------------------------------------------------
+// A missing source leaves the hash at zero and never matches, so the caller's XML load reports it.
+//
+bool DefinitionCacheReader::Open(String const& sourcePath)
+{
+    m_payload.clear();
+    m_readOffset = 0;
+    m_sourceHash = 0;
+    m_hasFailed  = true;
+
+    std::ifstream sourceFile(sourcePath, std::ios::in | std::ios::binary);
+
+    if (!sourceFile) return false;
+
+    std::vector<uint8_t> const sourceBytes((std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+    m_sourceHash = HashBytesFNV1a(sourceBytes);
+
+    std::ifstream cacheFile(GetDefinitionCachePath(sourcePath), std::ios::in | std::ios::binary);
+
+    if (!cacheFile) return false;
+
+    DefinitionCacheHeader header;
+    cacheFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!cacheFile ||
+        header.m_magic != DEFINITION_CACHE_MAGIC ||
+        header.m_version != DEFINITION_CACHE_VERSION ||
+        header.m_sourceHash != m_sourceHash)
+    {
+        return false;
+    }
+
+    // A damaged header must not make us allocate more than the file could possibly hold
+    std::streamoff const payloadStart = cacheFile.tellg();
+    cacheFile.seekg(0, std::ios::end);
+    std::streamoff const payloadBytesOnDisk = cacheFile.tellg() - payloadStart;
+    cacheFile.seekg(payloadStart);
+
+    if (!cacheFile || payloadBytesOnDisk < 0 || header.m_payloadSize != static_cast<uint64_t>(payloadBytesOnDisk)) return false;
+
+    m_payload.resize(static_cast<size_t>(header.m_payloadSize));
+    cacheFile.read(reinterpret_cast<char*>(m_payload.data()), static_cast<std::streamsize>(m_payload.size()));
+
+    if (!cacheFile) return false;
+
+    m_hasFailed = false;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool DefinitionCacheReader::ReadBytes(void* outData, size_t const numBytes)
+{
+    if (m_hasFailed || m_readOffset + numBytes > m_payload.size())
+    {
+        m_hasFailed = true;
+        std::memset(outData, 0, numBytes);
+        return false;
+    }
+
+    std::memcpy(outData, m_payload.data() + m_readOffset, numBytes);
+    m_readOffset += numBytes;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+int DefinitionCacheReader::ReadInt()
+{
+    int32_t value = 0;
+    ReadBytes(&value, sizeof(value));
+    return value;
+}
+
+//----------------------------------------------------------------------------------------------------
+float DefinitionCacheReader::ReadFloat()
+{
+    float value = 0.f;
+    ReadBytes(&value, sizeof(value));
+    return value;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool DefinitionCacheReader::ReadBool()
+{
+    uint8_t value = 0;
+    ReadBytes(&value, sizeof(value));
+    return value != 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+String DefinitionCacheReader::ReadString()
+{
+    int const length = ReadInt();
+
+    if (length < 0 || m_readOffset + static_cast<size_t>(length) > m_payload.size())
+    {
+        m_hasFailed = true;
+        return String();
+    }
+
+    String value(reinterpret_cast<char const*>(m_payload.data() + m_readOffset), static_cast<size_t>(length));
+    m_readOffset += static_cast<size_t>(length);
+    return value;
+}
+
+//----------------------------------------------------------------------------------------------------
+IntVec2 DefinitionCacheReader::ReadIntVec2()
+{
+    int const x = ReadInt();
+    int const y = ReadInt();
+    return IntVec2(x, y);
+}
+
+//----------------------------------------------------------------------------------------------------
+Vec2 DefinitionCacheReader::ReadVec2()
+{
+    float const x = ReadFloat();
+    float const y = ReadFloat();
+    return Vec2(x, y);
+}
+
+//----------------------------------------------------------------------------------------------------
+Rgba8 DefinitionCacheReader::ReadRgba8()
+{
+    uint8_t rgba[4] = {};
+    ReadBytes(rgba, sizeof(rgba));
+    return Rgba8(rgba[0], rgba[1], rgba[2], rgba[3]);
+}
+
+//----------------------------------------------------------------------------------------------------
+DefinitionCacheWriter::DefinitionCacheWriter(uint64_t const sourceHash)
+    : m_sourceHash(sourceHash)
+{
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteBytes(void const* data, size_t const numBytes)
+{
+    uint8_t const* bytes = static_cast<uint8_t const*>(data);
+    m_payload.insert(m_payload.end(), bytes, bytes + numBytes);
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteInt(int const value)
+{
+    int32_t const value32 = value;
+    WriteBytes(&value32, sizeof(value32));
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteFloat(float const value)
+{
+    WriteBytes(&value, sizeof(value));
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteBool(bool const value)
+{
+    uint8_t const value8 = value ? 1 : 0;
+    WriteBytes(&value8, sizeof(value8));
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteString(String const& value)
+{
+    WriteInt(static_cast<int>(value.size()));
+    WriteBytes(value.data(), value.size());
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteIntVec2(IntVec2 const& value)
+{
+    WriteInt(value.x);
+    WriteInt(value.y);
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteVec2(Vec2 const& value)
+{
+    WriteFloat(value.x);
+    WriteFloat(value.y);
+}
+
+//----------------------------------------------------------------------------------------------------
+void DefinitionCacheWriter::WriteRgba8(Rgba8 const& value)
+{
+    uint8_t const rgba[4] = {value.r, value.g, value.b, value.a};
+    WriteBytes(rgba, sizeof(rgba));
+}
+
+//----------------------------------------------------------------------------------------------------
+// A read-only data folder only costs the cache; the definitions already loaded from XML are kept.
+//
+bool DefinitionCacheWriter::Save(String const& sourcePath) const
+{
+    std::ofstream cacheFile(GetDefinitionCachePath(sourcePath), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!cacheFile) return false;
+
+    DefinitionCacheHeader header;
+    header.m_payloadSize = m_payload.size();
+    header.m_sourceHash  = m_sourceHash;
+
+    cacheFile.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    cacheFile.write(reinterpret_cast<char const*>(m_payload.data()), static_cast<std::streamsize>(m_payload.size()));
+
+    return static_cast<bool>(cacheFile);
+}
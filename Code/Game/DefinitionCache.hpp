@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------------------------------
+// DefinitionCache.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Parsed definitions are cached next to their XML source as "<source>.cache": a header (magic, format
+// version, payload size, FNV-1a hash of the source file's bytes) followed by whatever the definition
+// wrote. A cache is only used when its hash matches the XML on disk, so editing the XML invalidates it.
+// Bump DEFINITION_CACHE_VERSION whenever any definition changes what it writes.
+//
+uint32_t constexpr DEFINITION_CACHE_VERSION = 1;
+
+String GetDefinitionCachePath(String const& sourcePath);
+
+//----------------------------------------------------------------------------------------------------
+// Open() reads and hashes the XML source, then loads the cache if it matches. Reads past the end of the
+// payload return zeros and set HasFailed(), so a loader can discard what it built and parse the XML.
+//
+class DefinitionCacheReader
+{
+public:
+    bool     Open(String const& sourcePath);
+    bool     HasFailed() const { return m_hasFailed; }
+    uint64_t GetSourceHash() const { return m_sourceHash; }
+
+    int     ReadInt();
+    float   ReadFloat();
+    bool    ReadBool();
+    String  ReadString();
+    IntVec2 ReadIntVec2();
+    Vec2    ReadVec2();
+    Rgba8   ReadRgba8();
+
+private:
+    bool ReadBytes(void* outData, size_t numBytes);
+
+    std::vector<uint8_t> m_payload;
+    size_t               m_readOffset = 0;
+    uint64_t             m_sourceHash = 0;
+    bool                 m_hasFailed  = false;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Takes the source hash from the reader that missed, so the XML is only read from disk once.
+//
+class DefinitionCacheWriter
+{
+public:
+    explicit DefinitionCacheWriter(uint64_t sourceHash);
+
+    void WriteInt(int value);
+    void WriteFloat(float value);
+    void WriteBool(bool value);
+    void WriteString(String const& value);
+    void WriteIntVec2(IntVec2 const& value);
+    void WriteVec2(Vec2 const& value);
+    void WriteRgba8(Rgba8 const& value);
+    bool Save(String const& sourcePath) const;
+
+private:
+    void WriteBytes(void const* data, size_t numBytes);
+
+    std::vector<uint8_t> m_payload;
+    uint64_t             m_sourceHash = 0;
+};
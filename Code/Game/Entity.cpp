@@ -5,24 +5,112 @@
 //----------------------------------------------------------------------------------------------------
 #include "Game/Entity.hpp"
 
-#include "Engine/Core/HeatMaps.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Game/EntityDefinition.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
+#include "Game/PathArena.hpp"
 #include "Game/PlayerTank.hpp"
+#include "Game/TileDistanceField.hpp"
+
+//----------------------------------------------------------------------------------------------------
+char const* GetEntityTypeName(EntityType const type)
+{
+    switch (type)
+    {
+    case ENTITY_TYPE_PLAYER_TANK: return "PlayerTank";
+    case ENTITY_TYPE_SCORPIO: return "Scorpio";
+    case ENTITY_TYPE_LEO: return "Leo";
+    case ENTITY_TYPE_ARIES: return "Aries";
+    case ENTITY_TYPE_CAPRICORN: return "Capricorn";
+    case ENTITY_TYPE_BULLET: return "Bullet";
+    case ENTITY_TYPE_EXPLOSION: return "Explosion";
+    case ENTITY_TYPE_DEBRIS: return "Debris";
+    case ENTITY_TYPE_UNKNOWN:
+    case NUM_ENTITY_TYPES: break;
+    }
+
+    return "Unknown";
+}
+
+//----------------------------------------------------------------------------------------------------
+// Returns ENTITY_TYPE_UNKNOWN for a name GetEntityTypeName never returns.
+//
+EntityType GetEntityTypeFromName(String const& name)
+{
+    for (int typeIndex = 0; typeIndex < NUM_ENTITY_TYPES; ++typeIndex)
+    {
+        if (name == GetEntityTypeName(static_cast<EntityType>(typeIndex))) return static_cast<EntityType>(typeIndex);
+    }
+
+    return ENTITY_TYPE_UNKNOWN;
+}
+
+//----------------------------------------------------------------------------------------------------
+char const* GetEntityFactionName(EntityFaction const faction)
+{
+    switch (faction)
+    {
+    case ENTITY_FACTION_GOOD: return "Good";
+    case ENTITY_FACTION_NEUTRAL: return "Neutral";
+    case ENTITY_FACTION_EVIL: return "Evil";
+    case ENTITY_FACTION_UNKNOWN:
+    case NUM_ENTITY_FACTIONS: break;
+    }
+
+    return "Unknown";
+}
+
+//----------------------------------------------------------------------------------------------------
+char const* GetAILodTierName(AILodTier const tier)
+{
+    switch (tier)
+    {
+    case AI_LOD_TIER_NEAR: return "near";
+    case AI_LOD_TIER_MID: return "mid";
+    case AI_LOD_TIER_FAR: return "far";
+    case NUM_AI_LOD_TIERS: break;
+    }
+
+    return "unknown";
+}
 
 //----------------------------------------------------------------------------------------------------
 Entity::Entity(Map* map, EntityType const type, EntityFaction const faction)
     : m_map(map),
       m_type(type),
-      m_faction(faction)
+      m_faction(faction),
+      m_definition(EntityDefinition::GetEntityDef(type, faction))
 {
+    // Subclasses read their textures and stats from the definition, so an entity without one cannot spawn
+    if (m_definition == nullptr)
+    {
+        ERROR_AND_DIE(Stringf("EntityDefinitions.xml has no definition for type \"%s\" and faction \"%s\"", GetEntityTypeName(type), GetEntityFactionName(faction)))
+    }
 
-    IntVec2 mapDimension = m_map->GetMapDimension();
-    m_pathPoints.reserve(mapDimension.x*mapDimension.y);
+    m_physicsRadius      = m_definition->GetPhysicsRadius();
+    m_detectRange        = m_definition->GetDetectRange();
+    m_moveSpeed          = m_definition->GetMoveSpeed();
+    m_rotateSpeed        = m_definition->GetRotateSpeed();
+    m_health             = m_definition->GetInitHealth();
+    m_totalHealth        = m_health;
+    m_isPushedByWalls    = m_definition->IsPushedByWalls();
+    m_isPushedByEntities = m_definition->IsPushedByEntities();
+    m_doesPushEntities   = m_definition->DoesPushEntities();
+    m_canSwim            = m_definition->CanSwim();
+    m_bodyBounds         = m_definition->GetBodyBounds();
+    m_bodyTexture        = m_definition->GetBodyTexture();
+}
+
+//----------------------------------------------------------------------------------------------------
+Entity::~Entity()
+{
+    delete m_distanceField;
+    m_distanceField = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -74,7 +162,7 @@ void Entity::WanderAround(float const deltaSeconds,
 
     if (m_timeSinceLastRoll >= 1.0f)
     {
-        m_targetOrientationDegrees = static_cast<float>(g_theRNG->RollRandomIntInRange(0, 360));
+        m_targetOrientationDegrees = static_cast<float>(m_map->GetRandom().RollRandomIntInRange(0, 360));
         m_timeSinceLastRoll        = 0.f;
     }
 
@@ -90,15 +178,24 @@ void Entity::WanderAround(float const deltaSeconds,
 //----------------------------------------------------------------------------------------------------
 void Entity::UpdateBehavior(float const deltaSeconds, bool const isChasing)
 {
-    PlayerTank const* playerTank = g_theGame->GetPlayerTank();
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
 
-    // Update or initialize the heat map and target position
-    if (!m_heatMap ||
-        (isChasing && m_goalPosition != playerTank->m_position))
+    if (!m_path)
     {
-        // Create a new heat map with high initial values
-        m_heatMap = new TileHeatMap(m_map->GetMapDimension(), 999.f);
+        m_path = m_map->AcquirePathCorridor();
+    }
+
+    bool const isFirstPath = m_distanceField == nullptr;
 
+    if (isFirstPath)
+    {
+        m_distanceField = new TileDistanceField(m_map->GetMapDimension());
+    }
+
+    // Update or initialize the target position
+    if (isFirstPath ||
+        (isChasing && m_goalPosition != playerTank->m_position))
+    {
         if (isChasing)
         {
             // Chasing mode: Set the target to the player's current position
@@ -107,58 +204,60 @@ void Entity::UpdateBehavior(float const deltaSeconds, bool const isChasing)
             // Play discover sound if not already played
             if (!m_hasPlayedDiscoverSound)
             {
-                g_theAudio->StartSound(g_theGame->GetEnemyDiscoverSoundID());
+                m_map->PostSoundEvent(g_theGame->GetEnemyDiscoverSoundID(), m_position, SOUND_PRIORITY_NORMAL);
                 m_hasPlayedDiscoverSound = true;
             }
         }
         else
         {
             // Wandering mode: Set a random traversable tile as the target
-            IntVec2 const randomCoords = m_map->RollRandomTraversableTileCoords(*m_heatMap, IntVec2(m_position));
+            IntVec2 const randomCoords = m_map->RollRandomTraversableTileCoords(IntVec2(m_position));
             m_goalPosition             = m_map->GetWorldPosFromTileCoords(randomCoords);
 
             // Reset discover sound flag when switching to wandering mode
             m_hasPlayedDiscoverSound = false;
         }
 
-        // Generate heat maps and distance fields for pathfinding
-        m_pathPoints = m_map->GenerateEntityPathToGoal(*m_heatMap, m_position, m_goalPosition);
+        // Queue the path; the current one is followed until the Map delivers the new one
+        m_map->RequestPath(*this, m_goalPosition, isChasing);
     }
 
-    // If path is empty, regenerate path
-    if (m_pathPoints.empty())
+    // Nothing to follow until the queued path arrives
+    if (m_path->IsEmpty())
     {
-        m_pathPoints = m_map->GenerateEntityPathToGoal(*m_heatMap, m_position, m_goalPosition);
+        if (!m_isPathPending) m_map->RequestPath(*this, m_goalPosition, isChasing);
+        return;
     }
 
     // Path navigation logic
-    if (m_pathPoints.size() >= 2)
+    if (m_path->GetNumPoints() >= 2)
     {
-        Vec2 nextNextPosition = m_pathPoints[m_pathPoints.size() - 2];
+        Vec2 const nextNextPosition = m_path->GetPoint(m_path->GetNumPoints() - 2);
         if (!m_map->RaycastHitsImpassable(m_position, nextNextPosition))
         {
-            m_pathPoints.pop_back();
+            m_path->PopBack();
         }
     }
 
     // Remove current target if reached
-    if (IsPointInsideDisc2D(m_pathPoints.back(), m_position, m_physicsRadius))
+    if (IsPointInsideDisc2D(m_path->Back(), m_position, m_physicsRadius))
     {
-        m_pathPoints.pop_back();
+        m_path->PopBack();
     }
 
-    // If path is empty, choose a new target
-    if (m_pathPoints.empty())
+    // If path is empty, choose a new target and wait for its path
+    if (m_path->IsEmpty())
     {
-        IntVec2 randomCoords     = m_map->RollRandomTraversableTileCoords(*m_heatMap, IntVec2(m_position));
+        IntVec2 randomCoords     = m_map->RollRandomTraversableTileCoords(IntVec2(m_position));
         m_goalPosition           = m_map->GetWorldPosFromTileCoords(randomCoords);
-        m_pathPoints             = m_map->GenerateEntityPathToGoal(*m_heatMap, m_position, m_goalPosition);
+        m_map->RequestPath(*this, m_goalPosition, false);
         m_hasTarget              = false;
         m_hasPlayedDiscoverSound = false; // Reset sound flag
+        return;
     }
 
     // Set target to the last point in the path
-    Vec2 nextPosition = m_pathPoints.back();
+    Vec2 nextPosition = m_path->Back();
     Vec2 dispToTarget = nextPosition - m_position;
 
     // Rotate and move
@@ -167,6 +266,31 @@ void Entity::UpdateBehavior(float const deltaSeconds, bool const isChasing)
     MoveToward(m_position, nextPosition, m_moveSpeed, deltaSeconds);
 }
 
+//----------------------------------------------------------------------------------------------------
+// What a mid or far enemy does on the ticks it skips its full Update: the "Rotate and move" tail of
+// UpdateBehavior along the path its last full Update planned, with no sight checks, smoothing
+// raycasts or re-planning. With no path left it stands still until the Map wakes it.
+//
+void Entity::FollowCachedPath(float const deltaSeconds)
+{
+    m_timeSinceLastRoll += deltaSeconds;
+
+    if (!m_path || m_path->IsEmpty()) return;
+
+    if (IsPointInsideDisc2D(m_path->Back(), m_position, m_physicsRadius))
+    {
+        m_path->PopBack();
+
+        if (m_path->IsEmpty()) return;
+    }
+
+    Vec2 const nextPosition = m_path->Back();
+    Vec2 const dispToTarget = nextPosition - m_position;
+
+    m_targetOrientationDegrees = Atan2Degrees(dispToTarget.y, dispToTarget.x);
+    TurnToward(m_orientationDegrees, m_targetOrientationDegrees, deltaSeconds, m_rotateSpeed);
+    MoveToward(m_position, nextPosition, m_moveSpeed, deltaSeconds);
+}
 
 void Entity::RenderHealthBar() const
 {
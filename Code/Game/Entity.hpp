@@ -6,6 +6,7 @@
 #pragma once
 #include <vector>
 
+#include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Vec2.hpp"
 
@@ -13,7 +14,9 @@
 class Map;
 class Entity;
 class Texture;
-class TileHeatMap;
+struct EntityDefinition;
+class TileDistanceField;
+struct PathCorridor;
 typedef std::vector<Entity*> EntityList;
 
 //----------------------------------------------------------------------------------------------------
@@ -24,12 +27,30 @@ enum EntityType: int
     ENTITY_TYPE_SCORPIO,
     ENTITY_TYPE_LEO,
     ENTITY_TYPE_ARIES,
+    ENTITY_TYPE_CAPRICORN,
     ENTITY_TYPE_BULLET,
     ENTITY_TYPE_EXPLOSION,
     ENTITY_TYPE_DEBRIS,
     NUM_ENTITY_TYPES
 };
 
+char const* GetEntityTypeName(EntityType type);
+EntityType  GetEntityTypeFromName(String const& name);
+
+//----------------------------------------------------------------------------------------------------
+// How much thinking an enemy gets this tick, chosen by the Map from its distance to the player and
+// whether the camera can see it.
+//
+enum AILodTier : int
+{
+    AI_LOD_TIER_NEAR,       // Full Update every tick
+    AI_LOD_TIER_MID,        // Full Update every few ticks, cached path followed in between
+    AI_LOD_TIER_FAR,        // Cached path only; wakes to re-plan when the path runs out
+    NUM_AI_LOD_TIERS
+};
+
+char const* GetAILodTierName(AILodTier tier);
+
 //----------------------------------------------------------------------------------------------------
 enum EntityFaction: int
 {
@@ -40,6 +61,8 @@ enum EntityFaction: int
     NUM_ENTITY_FACTIONS
 };
 
+char const* GetEntityFactionName(EntityFaction faction);
+
 //-----------------------------------------------------------------------------------------------
 class Entity
 {
@@ -47,7 +70,7 @@ class Entity
 
 public:
     Entity(Map* map, EntityType type, EntityFaction faction);
-    virtual ~Entity() = default; //add an addition secrete pointer to the class
+    virtual ~Entity(); //add an addition secrete pointer to the class
 
     virtual void Update(float deltaSeconds) = 0;
     virtual void Render() const = 0;
@@ -56,6 +79,7 @@ public:
     void         MoveToward(Vec2& currentPosition, Vec2 const& targetPosition, float moveSpeed, float deltaSeconds);
     void         WanderAround(float deltaSeconds, float moveSpeed, float rotateSpeed);
     void         UpdateBehavior(float deltaSeconds, bool isChasing);
+    void         FollowCachedPath(float deltaSeconds);
     void         RenderHealthBar() const;
 
 // TODO: MAKE THIS
@@ -64,13 +88,15 @@ public:
     Map*              m_map                     = nullptr;
     EntityType        m_type                    = ENTITY_TYPE_UNKNOWN;
     EntityFaction     m_faction                 = ENTITY_FACTION_UNKNOWN;
+    EntityDefinition const* m_definition        = nullptr; // Shared, read-only stats from EntityDefinitions.xml
     Vec2              m_position                = Vec2::ZERO;
     Vec2              m_velocity                = Vec2::ZERO;
     // Vec2              m_targetLastKnownPosition = Vec2::ZERO;
     // Vec2              m_nextWayPosition         = Vec2::ZERO;
     Vec2              m_goalPosition            = Vec2::ZERO;
-    std::vector<Vec2> m_pathPoints;
-    TileHeatMap*      m_heatMap = nullptr;
+    PathCorridor*      m_path          = nullptr; // Only agents acquire one, from the map's PathArena
+    TileDistanceField* m_distanceField = nullptr; // Reused for every re-path
+    AILodTier          m_aiLodTier     = AI_LOD_TIER_NEAR; // Written by the Map before each Update
     AABB2             m_bodyBounds = AABB2::NEG_HALF_TO_HALF;
     Texture const*    m_bodyTexture              = nullptr;
     float             m_moveSpeed                = 0.f;
@@ -91,4 +117,5 @@ public:
     bool              m_hasTarget                = false;
     bool              m_isChasing                = false;
     bool              m_hasPlayedDiscoverSound   = false;
+    bool              m_isPathPending            = false; // Queued in the map's PathRequestScheduler
 };
@@ -0,0 +1,249 @@
+//----------------------------------------------------------------------------------------------------
+// EntityDefinition.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/EntityDefinition.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
+#include "Game/DefinitionCache.hpp"
+#include "Game/GameCommon.hpp"
+
+//----------------------------------------------------------------------------------------------------
+std::vector<EntityDefinition*> EntityDefinition::s_entityDefinitions;
+EntityDefinition const*        EntityDefinition::s_entityDefsByTypeAndFaction[NUM_ENTITY_TYPES][NUM_ENTITY_FACTIONS] = {};
+
+//----------------------------------------------------------------------------------------------------
+static EntityFaction GetEntityFactionFromName(String const& name)
+{
+    for (int factionIndex = 0; factionIndex < NUM_ENTITY_FACTIONS; ++factionIndex)
+    {
+        if (name == GetEntityFactionName(static_cast<EntityFaction>(factionIndex))) return static_cast<EntityFaction>(factionIndex);
+    }
+
+    return ENTITY_FACTION_UNKNOWN;
+}
+
+//----------------------------------------------------------------------------------------------------
+// physicsRadius defaults to half the body's diagonal, which is what bullets have always used.
+//
+EntityDefinition::EntityDefinition(XmlElement const& entityDefElement)
+{
+    m_type                  = GetEntityTypeFromName(ParseXmlAttribute(entityDefElement, "type", "Unknown"));
+    m_faction               = GetEntityFactionFromName(ParseXmlAttribute(entityDefElement, "faction", ""));
+    m_bodyBounds.m_mins     = ParseXmlAttribute(entityDefElement, "bodyBoundsMins", m_bodyBounds.m_mins);
+    m_bodyBounds.m_maxs     = ParseXmlAttribute(entityDefElement, "bodyBoundsMaxs", m_bodyBounds.m_maxs);
+    m_physicsRadius         = ParseXmlAttribute(entityDefElement, "physicsRadius", GetDistance2D(m_bodyBounds.m_mins, m_bodyBounds.m_maxs) * 0.5f);
+    m_detectRange           = ParseXmlAttribute(entityDefElement, "detectRange", 0.f);
+    m_moveSpeed             = ParseXmlAttribute(entityDefElement, "moveSpeed", 0.f);
+    m_rotateSpeed           = ParseXmlAttribute(entityDefElement, "rotateSpeed", 0.f);
+    m_turretRotateSpeed     = ParseXmlAttribute(entityDefElement, "turretRotateSpeed", 0.f);
+    m_shootCoolDown         = ParseXmlAttribute(entityDefElement, "shootCoolDown", 0.f);
+    m_shootDegreesThreshold = ParseXmlAttribute(entityDefElement, "shootDegreesThreshold", 0.f);
+    m_initHealth            = ParseXmlAttribute(entityDefElement, "initHealth", 0);
+    m_isPushedByWalls       = ParseXmlAttribute(entityDefElement, "isPushedByWalls", false);
+    m_isPushedByEntities    = ParseXmlAttribute(entityDefElement, "isPushedByEntities", false);
+    m_doesPushEntities      = ParseXmlAttribute(entityDefElement, "doesPushEntities", false);
+    m_canSwim               = ParseXmlAttribute(entityDefElement, "canSwim", false);
+
+    m_bodyImage             = ParseXmlAttribute(entityDefElement, "bodyImage", "");
+    m_turretImage           = ParseXmlAttribute(entityDefElement, "turretImage", "");
+    m_spriteSheetImage      = ParseXmlAttribute(entityDefElement, "spriteSheetImage", "");
+    m_spriteSheetLayout     = ParseXmlAttribute(entityDefElement, "spriteSheetLayout", m_spriteSheetLayout);
+
+    CreateTextures();
+}
+
+//----------------------------------------------------------------------------------------------------
+EntityDefinition::EntityDefinition(DefinitionCacheReader& cacheReader)
+{
+    m_type                  = static_cast<EntityType>(cacheReader.ReadInt());
+    m_faction               = static_cast<EntityFaction>(cacheReader.ReadInt());
+    m_bodyBounds.m_mins     = cacheReader.ReadVec2();
+    m_bodyBounds.m_maxs     = cacheReader.ReadVec2();
+    m_physicsRadius         = cacheReader.ReadFloat();
+    m_detectRange           = cacheReader.ReadFloat();
+    m_moveSpeed             = cacheReader.ReadFloat();
+    m_rotateSpeed           = cacheReader.ReadFloat();
+    m_turretRotateSpeed     = cacheReader.ReadFloat();
+    m_shootCoolDown         = cacheReader.ReadFloat();
+    m_shootDegreesThreshold = cacheReader.ReadFloat();
+    m_initHealth            = cacheReader.ReadInt();
+    m_isPushedByWalls       = cacheReader.ReadBool();
+    m_isPushedByEntities    = cacheReader.ReadBool();
+    m_doesPushEntities      = cacheReader.ReadBool();
+    m_canSwim               = cacheReader.ReadBool();
+    m_bodyImage             = cacheReader.ReadString();
+    m_turretImage           = cacheReader.ReadString();
+    m_spriteSheetImage      = cacheReader.ReadString();
+    m_spriteSheetLayout     = cacheReader.ReadIntVec2();
+
+    if (!cacheReader.HasFailed() && HasValidTypeAndFaction()) CreateTextures();
+}
+
+//----------------------------------------------------------------------------------------------------
+EntityDefinition::~EntityDefinition()
+{
+    delete m_spriteSheet;
+    m_spriteSheet = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+void EntityDefinition::WriteToCache(DefinitionCacheWriter& cacheWriter) const
+{
+    cacheWriter.WriteInt(m_type);
+    cacheWriter.WriteInt(m_faction);
+    cacheWriter.WriteVec2(m_bodyBounds.m_mins);
+    cacheWriter.WriteVec2(m_bodyBounds.m_maxs);
+    cacheWriter.WriteFloat(m_physicsRadius);
+    cacheWriter.WriteFloat(m_detectRange);
+    cacheWriter.WriteFloat(m_moveSpeed);
+    cacheWriter.WriteFloat(m_rotateSpeed);
+    cacheWriter.WriteFloat(m_turretRotateSpeed);
+    cacheWriter.WriteFloat(m_shootCoolDown);
+    cacheWriter.WriteFloat(m_shootDegreesThreshold);
+    cacheWriter.WriteInt(m_initHealth);
+    cacheWriter.WriteBool(m_isPushedByWalls);
+    cacheWriter.WriteBool(m_isPushedByEntities);
+    cacheWriter.WriteBool(m_doesPushEntities);
+    cacheWriter.WriteBool(m_canSwim);
+    cacheWriter.WriteString(m_bodyImage);
+    cacheWriter.WriteString(m_turretImage);
+    cacheWriter.WriteString(m_spriteSheetImage);
+    cacheWriter.WriteIntVec2(m_spriteSheetLayout);
+}
+
+//----------------------------------------------------------------------------------------------------
+void EntityDefinition::CreateTextures()
+{
+    if (!m_bodyImage.empty()) m_bodyTexture = g_theRenderer->CreateOrGetTextureFromFile(m_bodyImage.c_str());
+    if (!m_turretImage.empty()) m_turretTexture = g_theRenderer->CreateOrGetTextureFromFile(m_turretImage.c_str());
+
+    if (!m_spriteSheetImage.empty())
+    {
+        Texture const* const spriteSheetTexture = g_theRenderer->CreateOrGetTextureFromFile(m_spriteSheetImage.c_str());
+        m_spriteSheet                           = new SpriteSheet(*spriteSheetTexture, m_spriteSheetLayout);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Whether the row can index s_entityDefsByTypeAndFaction; a faction of ENTITY_FACTION_UNKNOWN fills gaps.
+//
+bool EntityDefinition::HasValidTypeAndFaction() const
+{
+    return m_type >= 0 && m_type < NUM_ENTITY_TYPES && m_faction >= ENTITY_FACTION_UNKNOWN && m_faction < NUM_ENTITY_FACTIONS;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Loads once per process; a new Game reuses the table. Rows with a faction are placed first, so a
+// faction-less row for the same type only fills the gaps.
+//
+STATIC void EntityDefinition::InitializeEntityDefs()
+{
+    if (!s_entityDefinitions.empty())
+        return;
+
+    String const          sourcePath = "Data/Definitions/EntityDefinitions.xml";
+    DefinitionCacheReader cacheReader;
+    bool                  isLoadedFromCache = false;
+
+    if (cacheReader.Open(sourcePath))
+    {
+        std::vector<EntityDefinition*> cachedEntityDefs;
+        int const                      numEntityDefs = cacheReader.ReadInt();
+        bool                           hasInvalidRow = false;
+
+        // A row that could not index the table makes the whole cache a miss, even if it was the last one
+        for (int entityDefIndex = 0; entityDefIndex < numEntityDefs && !cacheReader.HasFailed(); ++entityDefIndex)
+        {
+            EntityDefinition* entityDef = new EntityDefinition(cacheReader);
+
+            if (!entityDef->HasValidTypeAndFaction())
+            {
+                delete entityDef;
+                hasInvalidRow = true;
+                break;
+            }
+
+            cachedEntityDefs.push_back(entityDef);
+        }
+
+        isLoadedFromCache = !hasInvalidRow && !cacheReader.HasFailed() && static_cast<int>(cachedEntityDefs.size()) == numEntityDefs;
+
+        for (EntityDefinition* entityDef : cachedEntityDefs)
+        {
+            if (isLoadedFromCache) s_entityDefinitions.push_back(entityDef);
+            else delete entityDef;
+        }
+    }
+
+    if (!isLoadedFromCache)
+    {
+        XmlDocument entityDefXml;
+
+        // Every entity's stats and textures come from this file, so there is nothing to fall back on
+        if (entityDefXml.LoadFile(sourcePath.c_str()) != XmlResult::XML_SUCCESS)
+        {
+            ERROR_AND_DIE(Stringf("Could not load or parse \"%s\"", sourcePath.c_str()))
+        }
+
+        XmlElement* root = entityDefXml.FirstChildElement("EntityDefinitions");
+
+        if (root == nullptr)
+        {
+            ERROR_AND_DIE(Stringf("\"%s\" has no <EntityDefinitions> root", sourcePath.c_str()))
+        }
+
+        for (XmlElement* element = root->FirstChildElement("EntityDefinition"); element != nullptr; element = element->NextSiblingElement("EntityDefinition"))
+        {
+            EntityDefinition* entityDef = new EntityDefinition(*element);
+
+            if (entityDef->m_type == ENTITY_TYPE_UNKNOWN)
+            {
+                ERROR_AND_DIE(Stringf("EntityDefinitions.xml: unknown entity type \"%s\"", ParseXmlAttribute(*element, "type", "").c_str()))
+            }
+
+            s_entityDefinitions.push_back(entityDef);
+        }
+
+        DefinitionCacheWriter cacheWriter(cacheReader.GetSourceHash());
+        cacheWriter.WriteInt(static_cast<int>(s_entityDefinitions.size()));
+
+        for (EntityDefinition const* entityDef : s_entityDefinitions)
+        {
+            entityDef->WriteToCache(cacheWriter);
+        }
+
+        cacheWriter.Save(sourcePath);
+    }
+
+    for (EntityDefinition const* entityDef : s_entityDefinitions)
+    {
+        if (entityDef->m_faction == ENTITY_FACTION_UNKNOWN) continue;
+
+        s_entityDefsByTypeAndFaction[entityDef->m_type][entityDef->m_faction] = entityDef;
+    }
+
+    for (EntityDefinition const* entityDef : s_entityDefinitions)
+    {
+        if (entityDef->m_faction != ENTITY_FACTION_UNKNOWN) continue;
+
+        for (EntityDefinition const*& slot : s_entityDefsByTypeAndFaction[entityDef->m_type])
+        {
+            if (slot == nullptr) slot = entityDef;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Returns nullptr for a (type, faction) pair no row covers.
+//
+STATIC EntityDefinition const* EntityDefinition::GetEntityDef(EntityType const type, EntityFaction const faction)
+{
+    if (type < 0 || type >= NUM_ENTITY_TYPES || faction < 0 || faction >= NUM_ENTITY_FACTIONS) return nullptr;
+
+    return s_entityDefsByTypeAndFaction[type][faction];
+}
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------------------------------
+// EntityDefinition.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Game/Entity.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class DefinitionCacheReader;
+class DefinitionCacheWriter;
+class SpriteSheet;
+class Texture;
+
+//----------------------------------------------------------------------------------------------------
+// One row of Data/Definitions/EntityDefinitions.xml, parsed once at startup with its textures already
+// resolved. Rows are looked up by (type, faction) through a flat table, so spawning and shooting never
+// hash a string. A row without a faction attribute covers every faction no other row claims.
+//
+struct EntityDefinition
+{
+    explicit EntityDefinition(XmlElement const& entityDefElement);
+    explicit EntityDefinition(DefinitionCacheReader& cacheReader);
+    ~EntityDefinition();
+
+    void WriteToCache(DefinitionCacheWriter& cacheWriter) const;
+
+    static void                           InitializeEntityDefs();
+    static EntityDefinition const*        GetEntityDef(EntityType type, EntityFaction faction);
+    static std::vector<EntityDefinition*> s_entityDefinitions;
+
+    EntityType         GetType() const { return m_type; }
+    EntityFaction      GetFaction() const { return m_faction; }
+    float              GetPhysicsRadius() const { return m_physicsRadius; }
+    float              GetDetectRange() const { return m_detectRange; }
+    float              GetMoveSpeed() const { return m_moveSpeed; }
+    float              GetRotateSpeed() const { return m_rotateSpeed; }
+    float              GetTurretRotateSpeed() const { return m_turretRotateSpeed; }
+    float              GetShootCoolDown() const { return m_shootCoolDown; }
+    float              GetShootDegreesThreshold() const { return m_shootDegreesThreshold; }
+    int                GetInitHealth() const { return m_initHealth; }
+    bool               IsPushedByWalls() const { return m_isPushedByWalls; }
+    bool               IsPushedByEntities() const { return m_isPushedByEntities; }
+    bool               DoesPushEntities() const { return m_doesPushEntities; }
+    bool               CanSwim() const { return m_canSwim; }
+    AABB2 const&       GetBodyBounds() const { return m_bodyBounds; }
+    Texture*           GetBodyTexture() const { return m_bodyTexture; }
+    Texture*           GetTurretTexture() const { return m_turretTexture; }
+    SpriteSheet const* GetSpriteSheet() const { return m_spriteSheet; }
+
+private:
+    static EntityDefinition const* s_entityDefsByTypeAndFaction[NUM_ENTITY_TYPES][NUM_ENTITY_FACTIONS];
+
+    void CreateTextures();
+    bool HasValidTypeAndFaction() const;
+
+    EntityType    m_type                  = ENTITY_TYPE_UNKNOWN;
+    EntityFaction m_faction               = ENTITY_FACTION_UNKNOWN;
+    float         m_physicsRadius         = 0.f;
+    float         m_detectRange           = 0.f;
+    float         m_moveSpeed             = 0.f;
+    float         m_rotateSpeed           = 0.f;
+    float         m_turretRotateSpeed     = 0.f;
+    float         m_shootCoolDown         = 0.f;
+    float         m_shootDegreesThreshold = 0.f;
+    int           m_initHealth            = 0;
+    bool          m_isPushedByWalls       = false;
+    bool          m_isPushedByEntities    = false;
+    bool          m_doesPushEntities      = false;
+    bool          m_canSwim               = false;
+    AABB2         m_bodyBounds            = AABB2::NEG_HALF_TO_HALF;
+    String        m_bodyImage;
+    String        m_turretImage;
+    String        m_spriteSheetImage;
+    IntVec2       m_spriteSheetLayout     = IntVec2(1, 1);
+    Texture*      m_bodyTexture           = nullptr;
+    Texture*      m_turretTexture         = nullptr;
+    SpriteSheet*  m_spriteSheet           = nullptr;     // Only for animated entities, such as Explosion
+};
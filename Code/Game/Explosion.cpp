@@ -9,6 +9,7 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
+#include "Game/EntityDefinition.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
@@ -17,16 +18,6 @@
 Explosion::Explosion(Map* map, EntityType const type, EntityFaction const faction)
     : Entity(map, type, faction)
 {
-    m_isPushedByWalls    = g_gameConfigBlackboard.GetValue("explosionIsPushedByWalls", true);
-    m_isPushedByEntities = g_gameConfigBlackboard.GetValue("explosionIsPushedByEntities", true);
-    m_doesPushEntities   = g_gameConfigBlackboard.GetValue("explosionDoesPushEntities", true);
-
-    m_health                          = g_gameConfigBlackboard.GetValue("explosionInitHealth", 1);
-    Texture const* const tileTexture  = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/Explosion_5x5.png");
-    IntVec2 const        spriteCoords = IntVec2(5, 5);
-    m_spriteSheet                     = new SpriteSheet(*tileTexture, spriteCoords);
-
-    m_bodyBounds    = AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f));
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -73,7 +64,7 @@ void Explosion::RenderBody() const
 {
     VertexList_PCU vertexArray;
 
-    SpriteAnimDefinition const myAnim(*m_spriteSheet, 0, 24, 10.f, SpriteAnimPlaybackType::ONCE);
+    SpriteAnimDefinition const myAnim(*m_definition->GetSpriteSheet(), 0, 24, 10.f, SpriteAnimPlaybackType::ONCE);
 
     SpriteDefinition const& spriteDef = myAnim.GetSpriteDefAtTime(m_animationTime);
 
@@ -6,9 +6,6 @@
 #pragma once
 #include "Game/Entity.hpp"
 
-//----------------------------------------------------------------------------------------------------
-class SpriteSheet;
-
 //----------------------------------------------------------------------------------------------------
 class Explosion : public Entity
 {
@@ -21,6 +18,5 @@ public:
 private:
     void RenderBody() const;
 
-    SpriteSheet* m_spriteSheet   = nullptr;
-    float        m_animationTime = 0.f;
+    float m_animationTime = 0.f;
 };
@@ -5,11 +5,14 @@
 //----------------------------------------------------------------------------------------------------
 #include "Game/Game.hpp"
 
+#include <chrono>
+
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/HeatMaps.hpp"
 #include "Engine/Core/SimpleTriangleFont.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
@@ -18,7 +21,11 @@
 #include "Engine/Renderer/SpriteDefinition.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/EntityDefinition.hpp"
+#include "Game/Log.hpp"
 #include "Game/Map.hpp"
+#include "Game/MapScheduler.hpp"
+#include "Game/PerformanceHud.hpp"
 #include "Game/PlayerTank.hpp"
 
 
@@ -26,11 +33,15 @@
 Game::Game()
 {
     InitializeTiles();
+    InitializeEntities();
     InitializeMaps();
     InitializeAudio();
 
-    m_worldCamera  = new Camera();
-    m_screenCamera = new Camera();
+    m_worldCamera     = new Camera();
+    m_screenCamera    = new Camera();
+    m_performanceHud  = new PerformanceHud();
+    m_soundEventQueue = new SoundEventQueue();
+    m_mapScheduler    = new MapScheduler();
 
     Vec2 const  playerTankInitPosition           = g_gameConfigBlackboard.GetValue("playerTankInitPosition", Vec2(2.f, 2.f));
     float const playerTankInitOrientationDegrees = g_gameConfigBlackboard.GetValue("playerTankInitOrientationDegrees", 30.f);
@@ -56,6 +67,10 @@ Game::Game()
 //----------------------------------------------------------------------------------------------------
 Game::~Game()
 {
+    // Waits for any background ticks still running before the maps go away
+    delete m_mapScheduler;
+    m_mapScheduler = nullptr;
+
     delete m_currentMap;
     m_currentMap = nullptr;
 
@@ -64,6 +79,13 @@ Game::~Game()
     delete m_playerTank;
     m_playerTank = nullptr;
 
+    delete m_performanceHud;
+    m_performanceHud = nullptr;
+
+    m_soundEventQueue->StopAll();
+    delete m_soundEventQueue;
+    m_soundEventQueue = nullptr;
+
     delete m_screenCamera;
     m_screenCamera = nullptr;
 
@@ -79,11 +101,15 @@ Game::~Game()
 //-----------------------------------------------------------------------------------------------
 void Game::Update(float deltaSeconds)
 {
+    m_performanceHud->BeginFrame();
+
     // #TODO: Select keyboard or controller
     UpdateMarkForDelete();
     UpdateFromKeyBoard();
     UpdateFromController();
     UpdateCamera(deltaSeconds);
+    m_soundEventQueue->SetAudibleBounds(AABB2(m_worldCamera->GetOrthoBottomLeft(), m_worldCamera->GetOrthoTopRight()));
+    m_currentMap->SetAILodViewBounds(AABB2(m_worldCamera->GetOrthoBottomLeft(), m_worldCamera->GetOrthoTopRight()));
     UpdateAttractMode(deltaSeconds);
     AdjustForPauseAndTimeDistortion(deltaSeconds);
 
@@ -137,7 +163,15 @@ void Game::Update(float deltaSeconds)
 
 
     if (m_currentMap)
-        m_currentMap->Update(deltaSeconds);
+    {
+        // The other maps tick on the workers while the current one updates here
+        if (!m_isAttractMode) m_mapScheduler->BeginBackgroundTicks(m_maps, m_currentMap, deltaSeconds);
+
+        m_currentMap->Update(deltaSeconds, m_performanceHud);
+        m_mapScheduler->FinishBackgroundTicks();
+    }
+
+    m_soundEventQueue->Flush(GetCurrentTimeSeconds());
 
     if (g_theInput->WasKeyJustPressed(KEYCODE_TILDE))
     {
@@ -171,13 +205,98 @@ void Game::Render() const
 
     m_currentMap->RenderTileHeatMapText();
 
+    if (m_isPerformanceHudVisible)
+    {
+        float const screenSizeY = g_gameConfigBlackboard.GetValue("screenSizeY", 800.f);
+
+        m_performanceHud->Render(*m_currentMap, AABB2(Vec2(10.f, screenSizeY - 330.f), Vec2(570.f, screenSizeY - 30.f)));
+    }
+
     g_theRenderer->EndCamera(*m_screenCamera);
 }
 
+//----------------------------------------------------------------------------------------------------
+// Enemies join the evil faction, as SpawnNewNPCs does; bullets fly for the good one so they hurt
+// enemies rather than the player.
+//
+int Game::SpawnEntities(EntityType const type, int const count)
+{
+    EntityFaction const faction = type == ENTITY_TYPE_BULLET ? ENTITY_FACTION_GOOD : ENTITY_FACTION_EVIL;
+
+    return m_currentMap->SpawnEntitiesOnRandomTiles(type, faction, count);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Runs numTicks simulation steps back to back with no input or rendering in between and reports how
+// fast they went. The player's tank is simulated too, standing still.
+//
+void Game::StepSimulation(int const numTicks, float const fixedDeltaSeconds)
+{
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+
+    for (int tickIndex = 0; tickIndex < numTicks; ++tickIndex)
+    {
+        m_currentMap->UpdateSimulation(fixedDeltaSeconds, m_performanceHud);
+    }
+
+    double const seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int          numEntities = 0;
+
+    for (int typeIndex = 0; typeIndex < NUM_ENTITY_TYPES; ++typeIndex)
+    {
+        numEntities += m_currentMap->GetNumEntitiesOfType(static_cast<EntityType>(typeIndex));
+    }
+
+    g_theDevConsole->AddLine(Rgba8::GREEN,
+                             Stringf("sim.step: %d ticks of %.4f s in %.1f ms (%.0f ticks/s, %.3f ms/tick), %d entities",
+                                     numTicks,
+                                     fixedDeltaSeconds,
+                                     seconds * 1000.0,
+                                     seconds > 0.0 ? static_cast<double>(numTicks) / seconds : 0.0,
+                                     numTicks > 0 ? seconds * 1000.0 / static_cast<double>(numTicks) : 0.0,
+                                     numEntities));
+}
+
+//----------------------------------------------------------------------------------------------------
+void Game::ReportPerformanceStats() const
+{
+    g_theDevConsole->AddLine(Rgba8::GREEN, m_performanceHud->GetFrameTimeSummary());
+
+    for (String const& line : m_performanceHud->GetStatLines(*m_currentMap))
+    {
+        g_theDevConsole->AddLine(Rgba8::WHITE, line);
+    }
+
+    for (String const& line : m_mapScheduler->GetStatLines())
+    {
+        g_theDevConsole->AddLine(Rgba8::WHITE, line);
+    }
+
+    SoundEventFrameStats const& soundStats = m_soundEventQueue->GetLastFlushStats();
+
+    g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("Sounds %d posted  %d culled  %d merged  %d started  %d dropped  %d stolen  %d voices",
+                                                   soundStats.m_numPosted,
+                                                   soundStats.m_numCulled,
+                                                   soundStats.m_numMerged,
+                                                   soundStats.m_numStarted,
+                                                   soundStats.m_numDropped,
+                                                   soundStats.m_numStolen,
+                                                   soundStats.m_numActiveVoices));
+    g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("Time scale %.2f", m_timeScale));
+}
+
+//----------------------------------------------------------------------------------------------------
+// Gameplay sounds go through the queue so a burst of identical events costs one voice.
+//
+void Game::PostSoundEvent(SoundID const soundID, Vec2 const& position, SoundPriority const priority)
+{
+    m_soundEventQueue->Post(soundID, position, priority);
+}
+
 //----------------------------------------------------------------------------------------------------
 void Game::InitializeMaps()
 {
-    printf("( Game ) Start  | InitializeMaps\n");
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Start  | InitializeMaps");
 
     MapDefinition::InitializeMapDefs();
 
@@ -190,14 +309,14 @@ void Game::InitializeMaps()
 
     m_currentMap = m_maps[0];
 
-    printf("( Game ) Finish | InitializeMaps\n");
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Finish | InitializeMaps");
 }
 
 
 //----------------------------------------------------------------------------------------------------
 void Game::InitializeTiles()
 {
-    printf("( Game ) Start  | InitializeTiles\n");
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Start  | InitializeTiles");
 
     Texture const* const tileTexture  = g_theRenderer->CreateOrGetTextureFromFile(TILE_TEXTURE_IMG);
     IntVec2 const        spriteCoords = IntVec2(8, 8);
@@ -205,18 +324,29 @@ void Game::InitializeTiles()
 
     TileDefinition::InitializeTileDefs(*m_tileSpriteSheet);
 
-    printf("( Game ) Finish | InitializeTiles\n");
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Finish | InitializeTiles");
+}
+
+//----------------------------------------------------------------------------------------------------
+void Game::InitializeEntities()
+{
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Start  | InitializeEntities");
+
+    EntityDefinition::InitializeEntityDefs();
+
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Finish | InitializeEntities");
 }
 
 //----------------------------------------------------------------------------------------------------
 void Game::InitializeAudio()
 {
-    printf("( Game ) Start  | InitializeAudio\n");
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Start  | InitializeAudio");
 
-    m_attractModeBgm       = g_theAudio->CreateOrGetSound(g_gameConfigBlackboard.GetValue("attractModeBgm", "Data/Audios/AttractModeBgm.mp3"));
-    m_InGameBgm            = g_theAudio->CreateOrGetSound(IN_GAME_BGM);
-    m_gameWinBgm           = g_theAudio->CreateOrGetSound(GAME_WIN_BGM);
-    m_gameLoseBgm          = g_theAudio->CreateOrGetSound(GAME_LOSE_BGM);
+    // Music is streamed; only the short effects below are decoded into memory
+    m_attractModeBgm       = g_theAudio->CreateOrGetStreamingSound(g_gameConfigBlackboard.GetValue("attractModeBgm", "Data/Audios/AttractModeBgm.mp3"));
+    m_InGameBgm            = g_theAudio->CreateOrGetStreamingSound(IN_GAME_BGM);
+    m_gameWinBgm           = g_theAudio->CreateOrGetStreamingSound(GAME_WIN_BGM);
+    m_gameLoseBgm          = g_theAudio->CreateOrGetStreamingSound(GAME_LOSE_BGM);
     m_clickSound           = g_theAudio->CreateOrGetSound(CLICK_SOUND);
     m_pauseSound           = g_theAudio->CreateOrGetSound(PAUSE_SOUND);
     m_resumeSound          = g_theAudio->CreateOrGetSound(RESUME_SOUND);
@@ -229,7 +359,7 @@ void Game::InitializeAudio()
     m_bulletBounceSound    = g_theAudio->CreateOrGetSound(BULLET_BOUNCE_SOUND);
     m_enemyDiscoverSound   = g_theAudio->CreateOrGetSound(ENEMY_DISCOVER_SOUND);
 
-    printf("( Game ) Finish | InitializeAudio\n");
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "( Game ) Finish | InitializeAudio");
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -299,7 +429,7 @@ void Game::UpdateFromKeyBoard()
 
             if (g_theInput->WasKeyJustPressed(KEYCODE_N))
             {
-                m_playerTank->m_health = g_gameConfigBlackboard.GetValue("playerTankInitHealth", 100);
+                m_playerTank->m_health = m_playerTank->m_definition->GetInitHealth();
                 m_playerTank->m_isDead = false;
                 m_isGameLoseMode       = false;
                 m_isPaused             = false;
@@ -321,6 +451,11 @@ void Game::UpdateFromKeyBoard()
             m_isDebugCamera = !m_isDebugCamera;
         }
 
+        if (g_theInput->WasKeyJustPressed(KEYCODE_F7))
+        {
+            m_isPerformanceHudVisible = !m_isPerformanceHudVisible;
+        }
+
         if (g_theInput->WasKeyJustPressed(KEYCODE_F9))
         {
             if (m_currentMap->GetMapIndex() == 2)
@@ -458,7 +593,7 @@ void Game::UpdateFromController()
 
             if (controller.WasButtonJustPressed(XBOX_BUTTON_A))
             {
-                m_playerTank->m_health = g_gameConfigBlackboard.GetValue("playerTankInitHealth", 100);
+                m_playerTank->m_health = m_playerTank->m_definition->GetInitHealth();
                 m_playerTank->m_isDead = false;
                 m_isGameLoseMode       = false;
                 m_isPaused             = false;
@@ -681,6 +816,8 @@ void Game::AdjustForPauseAndTimeDistortion(float& deltaSeconds) const
 
     if (m_isFastMo)
         deltaSeconds *= 4.f;
+
+    deltaSeconds *= m_timeScale;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -4,14 +4,18 @@
 
 //-----------------------------------------------------------------------------------------------
 #pragma once
-#include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Math/Vec2.hpp"
+#include "Game/Entity.hpp"
+#include "Game/GameAudioSystem.hpp"
+#include "Game/SoundEventQueue.hpp"
 #include "Game/TileDefinition.hpp"
 
 class TileHeatMap;
 //-----------------------------------------------------------------------------------------------
 class Camera;
 class Map;
+class MapScheduler;
+class PerformanceHud;
 class PlayerTank;
 
 
@@ -34,15 +38,24 @@ public:
     SoundID            GetExitMapSoundID() const { return m_exitMapSound; }
     SoundID            GetBulletBounceSoundID() const { return m_bulletBounceSound; }
     SoundID            GetEnemyDiscoverSoundID() const { return m_enemyDiscoverSound; }
+    void               PostSoundEvent(SoundID soundID, Vec2 const& position, SoundPriority priority);
 
     bool IsAttractMode() const { return m_isAttractMode; }
     bool IsNoClip() const { return m_isNoClip; }
     bool IsDebugRendering() const { return m_isDebugRendering; }
     bool IsMarkedForDelete() const { return m_isMarkedForDelete; }
 
+    // Developer console hooks
+    float GetTimeScale() const { return m_timeScale; }
+    void  SetTimeScale(float const timeScale) { m_timeScale = timeScale; }
+    int   SpawnEntities(EntityType type, int count);
+    void  StepSimulation(int numTicks, float fixedDeltaSeconds);
+    void  ReportPerformanceStats() const;
+
 private:
     void InitializeMaps();
     void InitializeTiles();
+    void InitializeEntities();
     void InitializeAudio();
 
     void UpdateMarkForDelete();
@@ -63,6 +76,7 @@ private:
     bool    m_isGameLoseMode          = false;
     bool    m_isDebugRendering        = false;
     bool    m_isDebugCamera           = false;
+    bool    m_isPerformanceHudVisible = false;
     bool    m_isPaused                = false;
     bool    m_isSlowMo                = false;
     bool    m_isFastMo                = false;
@@ -72,6 +86,7 @@ private:
     float   m_glowIntensity           = 0.f;
     float   m_gameOverCountDown       = 3.f;
     float   m_updateMapCountDown      = 1.f;
+    float   m_timeScale               = 1.f;
     bool    m_glowIncreasing          = false;
     Vec2    m_baseCameraPos           = Vec2::ZERO;
 
@@ -79,6 +94,9 @@ private:
     Map*              m_currentMap      = nullptr;
     SpriteSheet*      m_tileSpriteSheet = nullptr;
     PlayerTank*       m_playerTank      = nullptr;
+    PerformanceHud*   m_performanceHud  = nullptr;
+    SoundEventQueue*  m_soundEventQueue = nullptr;
+    MapScheduler*     m_mapScheduler    = nullptr;
 
     SoundID         m_attractModeBgm       = 0;
     SoundPlaybackID m_attractModePlayback  = 0;
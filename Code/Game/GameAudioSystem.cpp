@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------------------------------
+// GameAudioSystem.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/GameAudioSystem.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Log.hpp"
+
+//----------------------------------------------------------------------------------------------------
+GameAudioSystem::GameAudioSystem(AudioSystemConfig const& config)
+    : AudioSystem(config)
+{
+}
+
+//----------------------------------------------------------------------------------------------------
+// Streams go into the same registry as samples, so AudioSystem::Shutdown releases them and a path that
+// was already created either way keeps its first SoundID.
+//
+SoundID GameAudioSystem::CreateOrGetStreamingSound(String const& soundFilePath)
+{
+    std::map<std::string, SoundID>::const_iterator const found = m_registeredSoundIDs.find(soundFilePath);
+
+    if (found != m_registeredSoundIDs.end()) return found->second;
+
+    FMOD::Sound* newSound = nullptr;
+    m_fmodSystem->createStream(soundFilePath.c_str(), FMOD_DEFAULT, nullptr, &newSound);
+
+    if (!newSound)
+    {
+        GAME_LOG(LOG_CATEGORY_AUDIO, LOG_LEVEL_WARNING, "failed to open streaming sound \"%s\"", soundFilePath);
+        return MISSING_SOUND_ID;
+    }
+
+    SoundID const newSoundID = m_registeredSounds.size();
+
+    m_registeredSoundIDs[soundFilePath] = newSoundID;
+    m_registeredSounds.push_back(newSound);
+
+    return newSoundID;
+}
+
+//----------------------------------------------------------------------------------------------------
+// FMOD copies the bytes during createSound, so the caller may free them afterwards.
+//
+SoundID GameAudioSystem::CreateOrGetSoundFromMemory(String const& soundFilePath, std::vector<uint8_t> const& fileBytes)
+{
+    std::map<std::string, SoundID>::const_iterator const found = m_registeredSoundIDs.find(soundFilePath);
+
+    if (found != m_registeredSoundIDs.end()) return found->second;
+
+    FMOD_CREATESOUNDEXINFO soundInfo = {};
+    soundInfo.cbsize                 = sizeof(soundInfo);
+    soundInfo.length                 = static_cast<unsigned int>(fileBytes.size());
+
+    FMOD::Sound* newSound = nullptr;
+    m_fmodSystem->createSound(reinterpret_cast<char const*>(fileBytes.data()), FMOD_OPENMEMORY | FMOD_CREATECOMPRESSEDSAMPLE, &soundInfo, &newSound);
+
+    if (!newSound)
+    {
+        GAME_LOG(LOG_CATEGORY_AUDIO, LOG_LEVEL_WARNING, "failed to create sound \"%s\" from memory", soundFilePath);
+        return MISSING_SOUND_ID;
+    }
+
+    SoundID const newSoundID = m_registeredSounds.size();
+
+    m_registeredSoundIDs[soundFilePath] = newSoundID;
+    m_registeredSounds.push_back(newSound);
+
+    return newSoundID;
+}
@@ -0,0 +1,32 @@
+//----------------------------------------------------------------------------------------------------
+// GameAudioSystem.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// The Engine's AudioSystem plus streaming sounds for music. CreateOrGetSound decodes a whole file into
+// memory up front. A streaming sound only opens the file, and FMOD's stream thread decodes it a small
+// buffer at a time while it plays. The result is an ordinary SoundID, so StartSound, StopSound and the
+// playback setters work as usual. A stream has a single playback, so starting it again restarts it.
+// Use it for long tracks and keep short effects as samples.
+//
+// CreateOrGetSoundFromMemory takes a file's bytes, already read by someone else (the AssetPreloader's
+// workers), and keeps them compressed, so creating it reads nothing and decodes nothing; FMOD's mixer
+// decodes each playing voice as it goes. It is registered under its file path, so a later
+// CreateOrGetSound for the same path returns it.
+//
+class GameAudioSystem : public AudioSystem
+{
+public:
+    explicit GameAudioSystem(AudioSystemConfig const& config);
+
+    SoundID CreateOrGetStreamingSound(String const& soundFilePath);
+    SoundID CreateOrGetSoundFromMemory(String const& soundFilePath, std::vector<uint8_t> const& fileBytes);
+};
@@ -0,0 +1,12 @@
+//----------------------------------------------------------------------------------------------------
+// GameBuildPreferences.hpp
+//
+// Defines build preferences for optional game-side instrumentation. Anything switched off here
+// compiles out entirely, so shipping builds pay nothing for it.
+//
+
+#define GAME_ENABLE_PROFILER				// (If uncommented) PROFILE_SCOPE zones are recorded and can be captured.
+//#define GAME_ENABLE_ALLOCATION_TRACKING	// (If uncommented) Global new/delete count every allocation per frame, zone and call site; see mem.report.
+#define GAME_ENABLE_LOGGING				// (If uncommented) GAME_LOG records are queued per thread and written out by a background thread.
+#define GAME_LOG_MIN_LEVEL 1			// GAME_LOG calls below this LogLevel compile out: 0 verbose, 1 info, 2 warning, 3 error.
+#define GAME_LOG_CATEGORY_MASK 0xFF		// GAME_LOG calls whose LogCategory bit is clear compile out.
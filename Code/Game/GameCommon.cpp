@@ -33,15 +33,7 @@ const char* ENEMY_DISCOVER_SOUND = "Data/Audios/EnemyDiscoverSound.mp3";
 //----------------------------------------------------------------------------------------------------
 //// Texture-related
 //
-const char* PLAYER_TANK_BODY_IMG   = "Data/Images/PlayerTankBody.png";
-const char* PLAYER_TANK_TURRET_IMG = "Data/Images/PlayerTankTurret.png";
-const char* SCORPIO_BODY_IMG       = "Data/Images/EnemyTankScorpioBody.png";
-const char* SCORPIO_TURRET_IMG     = "Data/Images/EnemyTankScorpioTurret.png";
-const char* LEO_BODY_IMG           = "Data/Images/EnemyTankLeoBody.png";
-const char* ARIES_BODY_IMG         = "Data/Images/EnemyTankAriesBody.png";
-const char* BULLET_GOOD_IMG        = "Data/Images/BulletGood.png";
-const char* BULLET_EVIL_IMG        = "Data/Images/BulletEvil.png";
-const char* TILE_TEXTURE_IMG       = "Data/Images/Terrain_8x8.png";
+const char* TILE_TEXTURE_IMG = "Data/Images/Terrain_8x8.png";
 
 //----------------------------------------------------------------------------------------------------
 void DebugDrawRing(Vec2 const& center, float const radius, float const thickness, Rgba8 const& color)
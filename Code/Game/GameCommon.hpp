@@ -9,23 +9,25 @@
 struct Vec2;
 struct Rgba8;
 class App;
-class AudioSystem;
 class BitmapFont;
 class Game;
+class GameAudioSystem;
 class InputSystem;
 class Renderer;
 class RandomNumberGenerator;
 class Window;
+class WorkerPool;
 
 // one-time declaration
 extern App*                   g_theApp;
-extern AudioSystem*           g_theAudio;
+extern GameAudioSystem*       g_theAudio;
 extern BitmapFont*            g_theBitmapFont;
 extern Game*                  g_theGame;
 extern InputSystem*           g_theInput;
 extern Renderer*              g_theRenderer;
 extern RandomNumberGenerator* g_theRNG;
 extern Window*                g_theWindow;
+extern WorkerPool*            g_theWorkerPool;
 
 void DebugDrawRing(Vec2 const& center, float radius, float thickness, Rgba8 const& color);
 void DebugDrawLine(Vec2 const& start, Vec2 const& end, float thickness, Rgba8 const& color);
@@ -55,12 +57,4 @@ extern const char* ENEMY_DISCOVER_SOUND;
 //-----------------------------------------------------------------------------------------------
 // Texture-related
 //
-extern const char* PLAYER_TANK_BODY_IMG;
-extern const char* PLAYER_TANK_TURRET_IMG;
-extern const char* SCORPIO_BODY_IMG;
-extern const char* SCORPIO_TURRET_IMG;
-extern const char* LEO_BODY_IMG;
-extern const char* ARIES_BODY_IMG;
-extern const char* BULLET_GOOD_IMG;
-extern const char* BULLET_EVIL_IMG;
 extern const char* TILE_TEXTURE_IMG;
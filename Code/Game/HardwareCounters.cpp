@@ -0,0 +1,178 @@
+//----------------------------------------------------------------------------------------------------
+// HardwareCounters.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/HardwareCounters.hpp"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------------------------
+char const* GetHardwareCounterName(HardwareCounter const counter)
+{
+    switch (counter)
+    {
+    case HARDWARE_COUNTER_CYCLES: return "cycles";
+    case HARDWARE_COUNTER_INSTRUCTIONS: return "instructions";
+    case HARDWARE_COUNTER_L1D_READ_MISSES: return "l1dMisses";
+    case HARDWARE_COUNTER_LLC_MISSES: return "llcMisses";
+    case HARDWARE_COUNTER_BRANCH_MISSES: return "branchMisses";
+    case NUM_HARDWARE_COUNTERS: break;
+    }
+
+    return "unknown";
+}
+
+//----------------------------------------------------------------------------------------------------
+// A counter missing from either end stays missing in the total.
+//
+void HardwareCounterSample::AddDifference(HardwareCounterSample const& start, HardwareCounterSample const& end)
+{
+    for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+    {
+        if (start.m_values[counterIndex] < 0 || end.m_values[counterIndex] < 0 || m_values[counterIndex] < 0)
+        {
+            m_values[counterIndex] = -1;
+            continue;
+        }
+
+        m_values[counterIndex] += end.m_values[counterIndex] - start.m_values[counterIndex];
+    }
+}
+
+#if defined(__linux__)
+
+//----------------------------------------------------------------------------------------------------
+// The layout of a PERF_FORMAT_GROUP read with both time fields, for up to every counter.
+//
+struct PerfGroupReadFormat
+{
+    uint64_t m_numValues;
+    uint64_t m_timeEnabled;
+    uint64_t m_timeRunning;
+    uint64_t m_values[NUM_HARDWARE_COUNTERS];
+};
+
+//----------------------------------------------------------------------------------------------------
+static int OpenPerfEvent(uint32_t const type, uint64_t const config, int const groupFileDescriptor)
+{
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+
+    attributes.size           = sizeof(attributes);
+    attributes.type           = type;
+    attributes.config         = config;
+    attributes.disabled       = groupFileDescriptor < 0 ? 1 : 0;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+    attributes.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFileDescriptor, 0));
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------
+// Cycles lead the group; without them nothing is opened. The others join if the PMU has them.
+//
+HardwareCounterGroup::HardwareCounterGroup()
+{
+#if defined(__linux__)
+    struct PerfEventConfig
+    {
+        uint32_t m_type;
+        uint64_t m_config;
+    };
+
+    PerfEventConfig const configs[NUM_HARDWARE_COUNTERS] =
+    {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+
+    for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+    {
+        int const leaderFileDescriptor = m_fileDescriptors[HARDWARE_COUNTER_CYCLES];
+        int const fileDescriptor       = OpenPerfEvent(configs[counterIndex].m_type, configs[counterIndex].m_config, leaderFileDescriptor);
+
+        if (fileDescriptor < 0)
+        {
+            if (counterIndex == HARDWARE_COUNTER_CYCLES)
+            {
+                m_unavailableReason = Stringf("perf_event_open(cycles) failed: %s", std::strerror(errno));
+                return;
+            }
+
+            continue;
+        }
+
+        m_fileDescriptors[counterIndex] = fileDescriptor;
+        m_readIndices[counterIndex]     = m_numOpenCounters;
+        ++m_numOpenCounters;
+    }
+
+    ioctl(m_fileDescriptors[HARDWARE_COUNTER_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_fileDescriptors[HARDWARE_COUNTER_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    m_unavailableReason = "hardware counters need perf_event_open (Linux only)";
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+HardwareCounterGroup::~HardwareCounterGroup()
+{
+#if defined(__linux__)
+    for (int& fileDescriptor : m_fileDescriptors)
+    {
+        if (fileDescriptor >= 0) close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+// When the kernel multiplexes more counters than the PMU has, each value is scaled up by the share of
+// time the group was actually on the PMU.
+//
+bool HardwareCounterGroup::Read(HardwareCounterSample& outSample) const
+{
+    for (int64_t& value : outSample.m_values)
+    {
+        value = -1;
+    }
+
+#if defined(__linux__)
+    if (!IsAvailable()) return false;
+
+    PerfGroupReadFormat groupRead;
+
+    if (read(m_fileDescriptors[HARDWARE_COUNTER_CYCLES], &groupRead, sizeof(groupRead)) <= 0) return false;
+
+    double const scale = groupRead.m_timeRunning > 0 && groupRead.m_timeRunning < groupRead.m_timeEnabled
+                             ? static_cast<double>(groupRead.m_timeEnabled) / static_cast<double>(groupRead.m_timeRunning)
+                             : 1.0;
+
+    for (int counterIndex = 0; counterIndex < NUM_HARDWARE_COUNTERS; ++counterIndex)
+    {
+        int const readIndex = m_readIndices[counterIndex];
+
+        if (readIndex < 0 || static_cast<uint64_t>(readIndex) >= groupRead.m_numValues) continue;
+
+        outSample.m_values[counterIndex] = static_cast<int64_t>(static_cast<double>(groupRead.m_values[readIndex]) * scale);
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
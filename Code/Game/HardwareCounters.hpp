@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------------------------------
+// HardwareCounters.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+
+#include "Engine/Core/StringUtils.hpp"
+
+//----------------------------------------------------------------------------------------------------
+enum HardwareCounter : int
+{
+    HARDWARE_COUNTER_CYCLES,
+    HARDWARE_COUNTER_INSTRUCTIONS,
+    HARDWARE_COUNTER_L1D_READ_MISSES,
+    HARDWARE_COUNTER_LLC_MISSES,
+    HARDWARE_COUNTER_BRANCH_MISSES,
+    NUM_HARDWARE_COUNTERS
+};
+
+char const* GetHardwareCounterName(HardwareCounter counter);
+
+//----------------------------------------------------------------------------------------------------
+// Running totals since the group was opened. A counter the CPU (or VM) does not expose reads -1.
+//
+struct HardwareCounterSample
+{
+    int64_t m_values[NUM_HARDWARE_COUNTERS] = {};
+
+    void AddDifference(HardwareCounterSample const& start, HardwareCounterSample const& end);
+};
+
+//----------------------------------------------------------------------------------------------------
+// User-space cycles, instructions, L1D read misses, last-level cache misses and branch misses for the
+// thread that opened the group, read as one perf_event_open group so every counter covers the same
+// span. Linux only; elsewhere, or when the kernel refuses (perf_event_paranoid, no PMU in a VM),
+// IsAvailable() is false and GetUnavailableReason() says why. Work handed to other threads, such as
+// WorkerPool flood fills, is not counted.
+//
+class HardwareCounterGroup
+{
+public:
+    HardwareCounterGroup();
+    ~HardwareCounterGroup();
+
+    HardwareCounterGroup(HardwareCounterGroup const&)            = delete;
+    HardwareCounterGroup& operator=(HardwareCounterGroup const&) = delete;
+
+    bool          IsAvailable() const { return m_numOpenCounters > 0; }
+    bool          IsCounterAvailable(HardwareCounter const counter) const { return m_readIndices[counter] >= 0; }
+    String const& GetUnavailableReason() const { return m_unavailableReason; }
+    bool          Read(HardwareCounterSample& outSample) const;
+
+private:
+    int    m_fileDescriptors[NUM_HARDWARE_COUNTERS] = {-1, -1, -1, -1, -1};
+    int    m_readIndices[NUM_HARDWARE_COUNTERS]     = {-1, -1, -1, -1, -1};     // Position in a group read
+    int    m_numOpenCounters                        = 0;
+    String m_unavailableReason;
+};
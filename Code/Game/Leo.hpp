@@ -22,6 +22,5 @@ private:
     void RenderBody() const;
     void UpdateShootCoolDown(float deltaSeconds);
 
-    float m_shootCoolDown         = 0.f;
-    float m_shootDegreesThreshold = g_gameConfigBlackboard.GetValue("leoShootDegreesThreshold", 5.f);
+    float m_shootCoolDown = 0.f;
 };
@@ -0,0 +1,368 @@
+//----------------------------------------------------------------------------------------------------
+// Log.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/Log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/RingBuffer.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Capacity of each thread's ring. The log thread drains every DRAIN_INTERVAL, so this bounds records
+// per thread per interval; anything past it is counted as dropped rather than stalling the thread.
+//
+static constexpr int                       RECORDS_PER_THREAD = 1024;
+static constexpr std::chrono::milliseconds DRAIN_INTERVAL(5);
+
+//----------------------------------------------------------------------------------------------------
+struct LogThreadBuffer
+{
+    RingBuffer<LogRecord, RECORDS_PER_THREAD> m_records;
+    std::atomic<int>                          m_numDroppedRecords{0};
+};
+
+//----------------------------------------------------------------------------------------------------
+static std::mutex                    s_threadBuffersMutex;
+static std::vector<LogThreadBuffer*> s_threadBuffers;                   // Owned; freed on Shutdown
+static std::atomic<int>              s_threadBuffersGeneration{0};      // Bumped on Shutdown so stale thread_local pointers re-register
+static std::atomic<bool>             s_isRunning{false};
+static std::mutex                    s_wakeMutex;
+static std::condition_variable       s_wakeCondition;
+static bool                          s_isStopping = false;              // Guarded by s_wakeMutex
+static std::thread                   s_logThread;
+static std::vector<LogRecord>        s_drainedRecords;                  // Log thread only
+static FILE*                         s_logFile    = nullptr;
+static int64_t const                 s_startTicks = static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+static thread_local LogThreadBuffer* t_threadBuffer           = nullptr;
+static thread_local int              t_threadBufferGeneration = -1;
+
+//----------------------------------------------------------------------------------------------------
+char const* GetLogCategoryName(LogCategory const category)
+{
+    switch (category)
+    {
+    case LOG_CATEGORY_APP: return "App";
+    case LOG_CATEGORY_GAME: return "Game";
+    case LOG_CATEGORY_MAP: return "Map";
+    case LOG_CATEGORY_ENTITY: return "Entity";
+    case LOG_CATEGORY_AUDIO: return "Audio";
+    case LOG_CATEGORY_ASSETS: return "Assets";
+    case NUM_LOG_CATEGORIES: break;
+    }
+
+    return "unknown";
+}
+
+//----------------------------------------------------------------------------------------------------
+char const* GetLogLevelName(LogLevel const level)
+{
+    switch (level)
+    {
+    case LOG_LEVEL_VERBOSE: return "VERBOSE";
+    case LOG_LEVEL_INFO: return "INFO";
+    case LOG_LEVEL_WARNING: return "WARNING";
+    case LOG_LEVEL_ERROR: return "ERROR";
+    case NUM_LOG_LEVELS: break;
+    }
+
+    return "unknown";
+}
+
+//----------------------------------------------------------------------------------------------------
+// Text that does not fit is truncated; every string stays null-terminated. Returns where the string
+// starts. Once the buffer is full, that is the last string's terminator, so later strings read empty.
+//
+int LogRecord::AddText(char const* text)
+{
+    if (m_textSize >= TEXT_CAPACITY) return TEXT_CAPACITY - 1;
+
+    int const textOffset = m_textSize;
+
+    int const available = TEXT_CAPACITY - m_textSize - 1;
+    int const length    = text ? std::min(static_cast<int>(std::strlen(text)), available) : 0;
+
+    if (length > 0) std::memcpy(m_text + m_textSize, text, static_cast<size_t>(length));
+
+    m_text[m_textSize + length] = '\0';
+    m_textSize += length + 1;
+
+    return textOffset;
+}
+
+//----------------------------------------------------------------------------------------------------
+static LogThreadBuffer* GetOrCreateThreadBuffer()
+{
+    int const generation = s_threadBuffersGeneration.load(std::memory_order_acquire);
+
+    if (t_threadBuffer && t_threadBufferGeneration == generation) return t_threadBuffer;
+
+    std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+    LogThreadBuffer* threadBuffer = new LogThreadBuffer();
+
+    s_threadBuffers.push_back(threadBuffer);
+
+    t_threadBuffer           = threadBuffer;
+    t_threadBufferGeneration = generation;
+
+    return threadBuffer;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Formats one conversion. The length modifiers in spec are replaced with ones that match how the
+// argument was captured, so "%d" takes any integer and "%f" any floating point value.
+//
+static void AppendFormattedArgument(String& line, String const& spec, char const conversion, LogRecord const& record, LogArgument const* argument)
+{
+    char buffer[256];
+
+    if (!argument)
+    {
+        line += "<missing>";
+        return;
+    }
+
+    bool const isIntegerConversion  = std::strchr("diouxXc", conversion) != nullptr;
+    bool const isFloatingConversion = std::strchr("fFeEgGaA", conversion) != nullptr;
+
+    if (conversion == 's')
+    {
+        char const* text = argument->m_type == LOG_ARGUMENT_TEXT ? record.m_text + argument->m_textOffset : "<not a string>";
+
+        std::snprintf(buffer, sizeof(buffer), (spec + "s").c_str(), text);
+    }
+    else if (isIntegerConversion && argument->m_type != LOG_ARGUMENT_TEXT)
+    {
+        long long const value = argument->m_type == LOG_ARGUMENT_DOUBLE ? static_cast<long long>(argument->m_double) : static_cast<long long>(argument->m_signed);
+
+        if (conversion == 'c') std::snprintf(buffer, sizeof(buffer), (spec + "c").c_str(), static_cast<int>(value));
+        else std::snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(), value);
+    }
+    else if (isFloatingConversion && argument->m_type != LOG_ARGUMENT_TEXT)
+    {
+        double const value = argument->m_type == LOG_ARGUMENT_DOUBLE   ? argument->m_double
+                           : argument->m_type == LOG_ARGUMENT_UNSIGNED ? static_cast<double>(argument->m_unsigned)
+                                                                       : static_cast<double>(argument->m_signed);
+
+        std::snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(), value);
+    }
+    else
+    {
+        std::snprintf(buffer, sizeof(buffer), "<bad %%%c>", conversion);
+    }
+
+    line += buffer;
+}
+
+//----------------------------------------------------------------------------------------------------
+// "[   12.345678] Map     INFO    ( Map0 ) Start  | GenerateAllTiles"
+//
+static String FormatRecord(LogRecord const& record)
+{
+    using Period = std::chrono::steady_clock::period;
+
+    double const seconds           = static_cast<double>(record.m_ticks - s_startTicks) * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+    String       line              = Stringf("[%12.6f] %-7s %-8s", seconds, GetLogCategoryName(record.m_category), GetLogLevelName(record.m_level));
+    int          nextArgumentIndex = 0;
+
+    for (char const* cursor = record.m_format; *cursor != '\0'; ++cursor)
+    {
+        if (*cursor != '%')
+        {
+            line += *cursor;
+            continue;
+        }
+
+        if (cursor[1] == '%')
+        {
+            line += '%';
+            ++cursor;
+            continue;
+        }
+
+        String spec = "%";
+
+        for (++cursor; *cursor != '\0' && std::strchr("-+ #0123456789.", *cursor) != nullptr; ++cursor)
+        {
+            spec += *cursor;
+        }
+
+        while (*cursor != '\0' && std::strchr("hljztL", *cursor) != nullptr)
+        {
+            ++cursor;
+        }
+
+        if (*cursor == '\0') break;
+
+        LogArgument const* argument = nextArgumentIndex < record.m_numArguments ? &record.m_arguments[nextArgumentIndex] : nullptr;
+
+        ++nextArgumentIndex;
+        AppendFormattedArgument(line, spec, *cursor, record, argument);
+    }
+
+    if (line.empty() || line.back() != '\n') line += '\n';
+
+    return line;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Pops everything the threads have pushed so far and writes it in timestamp order. Only the log thread
+// calls this while it runs, which keeps every ring single-consumer.
+//
+static void DrainAndWriteRecords()
+{
+    int numDroppedRecords = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+        for (LogThreadBuffer* threadBuffer : s_threadBuffers)
+        {
+            LogRecord record;
+
+            while (threadBuffer->m_records.TryPop(record))
+            {
+                s_drainedRecords.push_back(record);
+            }
+
+            numDroppedRecords += threadBuffer->m_numDroppedRecords.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    if (s_drainedRecords.empty() && numDroppedRecords == 0) return;
+
+    std::stable_sort(s_drainedRecords.begin(), s_drainedRecords.end(), [](LogRecord const& a, LogRecord const& b)
+    {
+        return a.m_ticks < b.m_ticks;
+    });
+
+    FILE* output = s_logFile ? s_logFile : stdout;
+
+    for (LogRecord const& record : s_drainedRecords)
+    {
+        String const line = FormatRecord(record);
+
+        std::fwrite(line.data(), 1, line.size(), output);
+    }
+
+    if (numDroppedRecords > 0) std::fprintf(output, "( Log ) %d records dropped (a thread's ring was full)\n", numDroppedRecords);
+
+    std::fflush(output);
+    s_drainedRecords.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+static void RunLogThread()
+{
+    std::unique_lock<std::mutex> lock(s_wakeMutex);
+
+    while (!s_isStopping)
+    {
+        lock.unlock();
+        DrainAndWriteRecords();
+        lock.lock();
+
+        s_wakeCondition.wait_for(lock, DRAIN_INTERVAL, [] { return s_isStopping; });
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// An empty filePath writes to stdout. Records pushed before this are written with the first drain.
+//
+STATIC void Log::Startup(String const& filePath)
+{
+    if (s_isRunning.load()) return;
+
+    s_logFile = nullptr;
+
+    if (!filePath.empty())
+    {
+        s_logFile = std::fopen(filePath.c_str(), "w");
+
+        if (!s_logFile) std::printf("( Log ) could not open %s, writing to stdout\n", filePath.c_str());
+    }
+
+    s_drainedRecords.reserve(RECORDS_PER_THREAD);
+
+    {
+        std::lock_guard<std::mutex> lock(s_wakeMutex);
+        s_isStopping = false;
+    }
+
+    s_logThread = std::thread(RunLogThread);
+    s_isRunning.store(true);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Other threads must be gone (or idle) by now. Their last records are written before the file closes.
+//
+STATIC void Log::Shutdown()
+{
+    if (!s_isRunning.load()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_wakeMutex);
+        s_isStopping = true;
+    }
+
+    s_wakeCondition.notify_one();
+    s_logThread.join();
+    s_isRunning.store(false);
+
+    DrainAndWriteRecords();
+
+    if (s_logFile)
+    {
+        std::fclose(s_logFile);
+        s_logFile = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+    for (LogThreadBuffer* threadBuffer : s_threadBuffers)
+    {
+        delete threadBuffer;
+    }
+
+    s_threadBuffers.clear();
+    s_threadBuffersGeneration.fetch_add(1, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int64_t Log::GetTicks()
+{
+    return static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+//----------------------------------------------------------------------------------------------------
+// Without a log thread there is nobody to drain the ring, so the record is written here instead.
+//
+STATIC void Log::Push(LogRecord const& record)
+{
+    if (!s_isRunning.load(std::memory_order_acquire))
+    {
+        String const line = FormatRecord(record);
+
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        return;
+    }
+
+    LogThreadBuffer* threadBuffer = GetOrCreateThreadBuffer();
+
+    if (!threadBuffer->m_records.TryPush(record))
+    {
+        threadBuffer->m_numDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------------------------------
+// Log.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/GameBuildPreferences.hpp"
+
+//----------------------------------------------------------------------------------------------------
+enum LogCategory : int
+{
+    LOG_CATEGORY_APP,
+    LOG_CATEGORY_GAME,
+    LOG_CATEGORY_MAP,
+    LOG_CATEGORY_ENTITY,
+    LOG_CATEGORY_AUDIO,
+    LOG_CATEGORY_ASSETS,
+    NUM_LOG_CATEGORIES
+};
+
+//----------------------------------------------------------------------------------------------------
+enum LogLevel : int
+{
+    LOG_LEVEL_VERBOSE,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR,
+    NUM_LOG_LEVELS
+};
+
+char const* GetLogCategoryName(LogCategory category);
+char const* GetLogLevelName(LogLevel level);
+
+//----------------------------------------------------------------------------------------------------
+// One argument as captured on the calling thread. Strings are copied into the record's text, so they
+// only have to live until GAME_LOG returns.
+//
+enum LogArgumentType : uint8_t
+{
+    LOG_ARGUMENT_SIGNED,
+    LOG_ARGUMENT_UNSIGNED,
+    LOG_ARGUMENT_DOUBLE,
+    LOG_ARGUMENT_TEXT
+};
+
+//----------------------------------------------------------------------------------------------------
+struct LogArgument
+{
+    LogArgumentType m_type = LOG_ARGUMENT_SIGNED;
+
+    union
+    {
+        int64_t  m_signed = 0;
+        uint64_t m_unsigned;
+        double   m_double;
+        int      m_textOffset;
+    };
+};
+
+//----------------------------------------------------------------------------------------------------
+// A log line before it is formatted: the format string, which must be a literal, and the raw
+// arguments. Formatting happens on the log thread.
+//
+struct LogRecord
+{
+    static constexpr int MAX_ARGUMENTS = 6;
+    static constexpr int TEXT_CAPACITY = 128;
+
+    int64_t     m_ticks        = 0;
+    char const* m_format       = nullptr;
+    LogCategory m_category     = LOG_CATEGORY_APP;
+    LogLevel    m_level        = LOG_LEVEL_INFO;
+    int         m_numArguments = 0;
+    int         m_textSize     = 0;
+    LogArgument m_arguments[MAX_ARGUMENTS];
+    char        m_text[TEXT_CAPACITY];
+
+    int AddText(char const* text);
+
+    template <typename T>
+    void AddArgument(T const& value)
+    {
+        LogArgument& argument = m_arguments[m_numArguments++];
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            argument.m_type   = LOG_ARGUMENT_DOUBLE;
+            argument.m_double = static_cast<double>(value);
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            argument.m_type   = LOG_ARGUMENT_SIGNED;
+            argument.m_signed = static_cast<int64_t>(value);
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            argument.m_type     = LOG_ARGUMENT_UNSIGNED;
+            argument.m_unsigned = static_cast<uint64_t>(value);
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            argument.m_type   = LOG_ARGUMENT_SIGNED;
+            argument.m_signed = static_cast<int64_t>(value);
+        }
+        else if constexpr (std::is_same_v<T, String>)
+        {
+            argument.m_type       = LOG_ARGUMENT_TEXT;
+            argument.m_textOffset = AddText(value.c_str());
+        }
+        else
+        {
+            static_assert(std::is_convertible_v<T const&, char const*>, "GAME_LOG arguments must be numbers, enums, C strings or Strings");
+
+            argument.m_type       = LOG_ARGUMENT_TEXT;
+            argument.m_textOffset = AddText(value);
+        }
+    }
+};
+
+//----------------------------------------------------------------------------------------------------
+// Structured logging for any thread. GAME_LOG captures its arguments into a record and pushes it onto
+// the calling thread's own lock-free ring; a background thread drains every ring, formats the records
+// in timestamp order and writes them to the log file (or stdout) with the time since launch. Calls
+// below GAME_LOG_MIN_LEVEL, or in a category outside GAME_LOG_CATEGORY_MASK, compile to nothing, so
+// verbose logging can stay in hot paths. Before Startup and after Shutdown records are written
+// straight to stdout on the calling thread.
+//
+class Log
+{
+public:
+    static void Startup(String const& filePath);
+    static void Shutdown();
+
+    template <typename... Arguments>
+    static void Write(LogCategory const category, LogLevel const level, char const* format, Arguments const&... arguments)
+    {
+        static_assert(sizeof...(Arguments) <= LogRecord::MAX_ARGUMENTS, "GAME_LOG takes at most LogRecord::MAX_ARGUMENTS arguments");
+
+        LogRecord record;
+
+        record.m_ticks    = GetTicks();
+        record.m_format   = format;
+        record.m_category = category;
+        record.m_level    = level;
+        (record.AddArgument(arguments), ...);
+
+        Push(record);
+    }
+
+private:
+    static int64_t GetTicks();
+    static void    Push(LogRecord const& record);
+};
+
+//----------------------------------------------------------------------------------------------------
+#if defined(GAME_ENABLE_LOGGING)
+constexpr bool IsLogCompiledIn(LogCategory const category, LogLevel const level)
+{
+    return level >= GAME_LOG_MIN_LEVEL && ((GAME_LOG_CATEGORY_MASK >> category) & 1) != 0;
+}
+#else
+constexpr bool IsLogCompiledIn(LogCategory, LogLevel) { return false; }
+#endif
+
+//----------------------------------------------------------------------------------------------------
+// format must be a string literal; the log thread reads it after the call returns.
+//
+#define GAME_LOG(category, level, format, ...)                          \
+    do                                                                  \
+    {                                                                   \
+        if constexpr (IsLogCompiledIn(category, level))                 \
+        {                                                               \
+            Log::Write(category, level, "" format, ##__VA_ARGS__);      \
+        }                                                               \
+    } while (false)
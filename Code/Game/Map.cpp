@@ -5,8 +5,9 @@
 //----------------------------------------------------------------------------------------------------
 #include "Game/Map.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <queue>
 
 #include "Debris.hpp"
 #include "Explosion.hpp"
@@ -24,13 +25,22 @@
 #include "Engine/Renderer/SpriteDefinition.hpp"
 #include "Game/Aries.hpp"
 #include "Game/Bullet.hpp"
+#include "Game/Capricorn.hpp"
+#include "Game/EntityDefinition.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Leo.hpp"
+#include "Game/Log.hpp"
 #include "Game/MapDefinition.hpp"
 #include "Game/PlayerTank.hpp"
+#include "Game/Profiler.hpp"
 #include "Game/Scorpio.hpp"
 #include "Game/Tile.hpp"
+#include "Game/TileDefinition.hpp"
+#include "Game/TileDistanceBFS.hpp"
+#include "Game/TileDistanceField.hpp"
+#include "Game/TileVisibility.hpp"
+#include "Game/WorkerPool.hpp"
 
 //----------------------------------------------------------------------------------------------------
 Map::Map(MapDefinition const& mapDef)
@@ -40,6 +50,28 @@ Map::Map(MapDefinition const& mapDef)
     m_tiles.reserve(static_cast<size_t>(m_dimensions.x) * static_cast<size_t>(m_dimensions.y));
     m_startPosition = IntVec2::ONE;
     m_exitPosition  = IntVec2(m_dimensions.x - 2, m_dimensions.y - 2);
+    m_tileFlags.Resize(m_dimensions);
+    m_scorpioOccupancy.Resize(m_dimensions);
+
+    // One draw from the global generator seeds the map, so std::srand still decides everything it rolls
+    uint32_t const seedHigh = static_cast<uint32_t>(g_theRNG->RollRandomIntInRange(0, 0xFFFF));
+    uint32_t const seedLow  = static_cast<uint32_t>(g_theRNG->RollRandomIntInRange(0, 0xFFFF));
+    m_random.SetSeed(seedHigh << 16 | seedLow);
+
+    m_aiLodSettings.m_nearDistance      = g_gameConfigBlackboard.GetValue("aiLodNearDistance", m_aiLodSettings.m_nearDistance);
+    m_aiLodSettings.m_midDistance       = std::max(g_gameConfigBlackboard.GetValue("aiLodMidDistance", m_aiLodSettings.m_midDistance), m_aiLodSettings.m_nearDistance);
+    m_aiLodSettings.m_midUpdateInterval = std::max(g_gameConfigBlackboard.GetValue("aiLodMidUpdateInterval", m_aiLodSettings.m_midUpdateInterval), 1);
+    m_aiLodSettings.m_farUpdateInterval = std::max(g_gameConfigBlackboard.GetValue("aiLodFarUpdateInterval", m_aiLodSettings.m_farUpdateInterval), 1);
+    m_aiLodSettings.m_isNearWhenVisible = g_gameConfigBlackboard.GetValue("aiLodNearWhenVisible", m_aiLodSettings.m_isNearWhenVisible);
+
+    float maxDetectRange = 0.f;
+
+    for (EntityDefinition const* entityDef : EntityDefinition::s_entityDefinitions)
+    {
+        maxDetectRange = std::max(maxDetectRange, entityDef->GetDetectRange());
+    }
+
+    m_playerViewRadius = RoundDownToInt(maxDetectRange) + 1;
 
     InitializeTileHeatMaps();
     GenerateAllTiles();
@@ -48,28 +80,44 @@ Map::Map(MapDefinition const& mapDef)
     // GenerateHeatMaps(*m_tileHeatMaps[1]);
     // GenerateHeatMaps(*m_tileHeatMaps[2]);
     // GenerateHeatMaps(*m_tileHeatMaps[3]);
-    PopulateDistanceField(*m_tileHeatMaps[0], m_startPosition, 999.f);
-    PopulateDistanceFieldForLandBased(*m_tileHeatMaps[1]);
-    PopulateDistanceFieldForAmphibian(*m_tileHeatMaps[2]);
-    PopulateDistanceFieldForEntity(*m_tileHeatMaps[3], m_startPosition, 999.f);
+    PopulateMapDistanceFields();
+
+    // Only HasLineOfSight reads the set, and no game code reaches it while the player's view covers every
+    // detectRange, so the build is opt-in
+    if (g_gameConfigBlackboard.GetValue("mapPvsEnabled", false)) BuildPotentiallyVisibleSet();
 }
 
 //----------------------------------------------------------------------------------------------------
+// The player tank travels between maps and is owned by the Game; every other entity belongs to the map.
+//
 Map::~Map()
 {
+    for (Entity const* entity : m_allEntities)
+    {
+        if (entity->m_type != ENTITY_TYPE_PLAYER_TANK) delete entity;
+    }
+
     m_allEntities.clear();
     m_entitiesByType->clear();
     m_agentsByFaction->clear();
     m_bulletsByFaction->clear();
     m_tiles.clear();
-    m_tileHeatMaps.clear();
 
-    delete m_currentSelectedEntity;
+    for (TileDistanceField const* field : m_distanceFields)
+    {
+        delete field;
+    }
+
+    m_distanceFields.clear();
+
+    delete m_debugHeatMap;
+    m_debugHeatMap = nullptr;
+
     m_currentSelectedEntity = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------
-void Map::Update(float const deltaSeconds)
+void Map::Update(float const deltaSeconds, MapUpdatePhaseListener* phaseListener)
 {
     if (g_theGame->IsAttractMode()) return;
 
@@ -106,12 +154,133 @@ void Map::Update(float const deltaSeconds)
         // }
     }
 
+    UpdateSimulation(deltaSeconds, phaseListener);
+}
+
+//----------------------------------------------------------------------------------------------------
+// The player tank only lives on the map it is currently in, so every other map sees nullptr.
+//
+PlayerTank const* Map::GetPlayerTank() const
+{
+    EntityList const& playerTanks = m_entitiesByType[ENTITY_TYPE_PLAYER_TANK];
+
+    return playerTanks.empty() ? nullptr : dynamic_cast<PlayerTank const*>(playerTanks.front());
+}
+
+//----------------------------------------------------------------------------------------------------
+// Background maps are out of earshot, and the sound queue belongs to the main thread.
+//
+void Map::PostSoundEvent(SoundID const soundID, Vec2 const& position, SoundPriority const priority) const
+{
+    if (m_isBackground) return;
+
+    g_theGame->PostSoundEvent(soundID, position, priority);
+}
+
+//----------------------------------------------------------------------------------------------------
+char const* GetMapUpdatePhaseName(MapUpdatePhase const phase)
+{
+    switch (phase)
+    {
+    case MAP_UPDATE_PHASE_UPDATE_ENTITIES: return "UpdateEntities";
+    case MAP_UPDATE_PHASE_PUSH_ENTITIES_OUT_OF_EACH_OTHER: return "PushEntitiesOutOfEachOther";
+    case MAP_UPDATE_PHASE_CHECK_ENTITY_VS_ENTITY_COLLISION: return "CheckEntityVsEntityCollision";
+    case MAP_UPDATE_PHASE_PUSH_ENTITIES_OUT_OF_WALLS: return "PushEntitiesOutOfWalls";
+    case MAP_UPDATE_PHASE_DELETE_GARBAGE_ENTITIES: return "DeleteGarbageEntities";
+    case NUM_MAP_UPDATE_PHASES: break;
+    }
+
+    return "Unknown";
+}
+
+//----------------------------------------------------------------------------------------------------
+// Brackets one phase with the listener's begin/end calls; costs a null check when nobody listens.
+//
+struct MapUpdatePhaseScope
+{
+    MapUpdatePhaseScope(MapUpdatePhaseListener* listener, MapUpdatePhase const phase)
+        : m_listener(listener),
+          m_phase(phase)
+    {
+        if (m_listener) m_listener->OnMapUpdatePhaseBegin(m_phase);
+    }
+
+    ~MapUpdatePhaseScope()
+    {
+        if (m_listener) m_listener->OnMapUpdatePhaseEnd(m_phase);
+    }
+
+    MapUpdatePhaseListener* m_listener;
+    MapUpdatePhase          m_phase;
+};
+
+//----------------------------------------------------------------------------------------------------
+struct MapPathRequestScope
+{
+    explicit MapPathRequestScope(MapUpdatePhaseListener* listener)
+        : m_listener(listener)
+    {
+        if (m_listener) m_listener->OnMapPathRequestBegin();
+    }
+
+    ~MapPathRequestScope()
+    {
+        if (m_listener) m_listener->OnMapPathRequestEnd();
+    }
+
+    MapUpdatePhaseListener* m_listener;
+};
 
-    UpdateEntities(deltaSeconds);
-    PushEntitiesOutOfEachOther(m_allEntities, m_allEntities);
-    CheckEntityVsEntityCollision(m_entitiesByType[ENTITY_TYPE_BULLET], m_allEntities);
-    PushEntitiesOutOfWalls();
-    DeleteGarbageEntities();
+//----------------------------------------------------------------------------------------------------
+// One fixed step of the world with no input or attract-mode checks, so benchmarks can drive it
+// without a player at the keyboard.
+//
+void Map::UpdateSimulation(float const deltaSeconds, MapUpdatePhaseListener* phaseListener)
+{
+    PROFILE_SCOPE("Map::UpdateSimulation");
+
+    m_phaseListener = phaseListener;
+    m_frameStats    = MapFrameStats();
+    ++m_numSimulationTicks;
+
+    {
+        MapUpdatePhaseScope const phaseScope(phaseListener, MAP_UPDATE_PHASE_UPDATE_ENTITIES);
+
+        {
+            // With a worker pool the paths are found off this thread, so the request span is the
+            // delivery and dispatch; inline, GenerateEntityPathToGoal brackets each request itself
+            MapPathRequestScope const pathRequestScope(g_theWorkerPool ? phaseListener : nullptr);
+            m_frameStats.m_pathRequestService = m_pathRequestScheduler.ServiceRequests(*this, !m_isBackground);
+        }
+
+        m_frameStats.m_numPathRequests       += m_frameStats.m_pathRequestService.m_numServed;
+        m_frameStats.m_numFlowFieldCacheHits += m_frameStats.m_pathRequestService.m_numFieldReuses;
+
+        UpdatePlayerView();
+        UpdateEntities(deltaSeconds);
+    }
+
+    {
+        MapUpdatePhaseScope const phaseScope(phaseListener, MAP_UPDATE_PHASE_PUSH_ENTITIES_OUT_OF_EACH_OTHER);
+        PushEntitiesOutOfEachOther(m_allEntities, m_allEntities);
+    }
+
+    {
+        MapUpdatePhaseScope const phaseScope(phaseListener, MAP_UPDATE_PHASE_CHECK_ENTITY_VS_ENTITY_COLLISION);
+        CheckEntityVsEntityCollision(m_entitiesByType[ENTITY_TYPE_BULLET], m_allEntities);
+    }
+
+    {
+        MapUpdatePhaseScope const phaseScope(phaseListener, MAP_UPDATE_PHASE_PUSH_ENTITIES_OUT_OF_WALLS);
+        PushEntitiesOutOfWalls();
+    }
+
+    {
+        MapUpdatePhaseScope const phaseScope(phaseListener, MAP_UPDATE_PHASE_DELETE_GARBAGE_ENTITIES);
+        DeleteGarbageEntities();
+    }
+
+    m_phaseListener = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -175,11 +344,32 @@ bool Map::HasLineOfSight(Vec2 const& startPos,
                          Vec2 const& endPos,
                          float const sightRange) const
 {
+    PROFILE_SCOPE("Map::HasLineOfSight");
+
     float const distSquared      = GetDistanceSquared2D(startPos, endPos);
     float const sighRangeSquared = sightRange * sightRange;
 
     if (distSquared >= sighRangeSquared) return false;
 
+    ++m_frameStats.m_numLineOfSightChecks;
+
+    // The set answers for the two tile centers. Off-center ends near the edge of what the start tile
+    // sees, and a clustered "maybe", raycast instead
+    if (m_potentiallyVisibleSet.IsBuilt())
+    {
+        IntVec2 const startCoords = GetTileCoordsFromWorldPos(startPos);
+        IntVec2 const endCoords   = GetTileCoordsFromWorldPos(endPos);
+        bool const    isVisible   = m_potentiallyVisibleSet.IsPotentiallyVisible(startCoords, endCoords);
+        bool const    isExact     = m_potentiallyVisibleSet.GetClusterSize() == 1 || !isVisible;
+        bool const    isAtCenters = startPos == GetWorldPosFromTileCoords(startCoords) && endPos == GetWorldPosFromTileCoords(endCoords);
+
+        if (isExact && (isAtCenters || !IsNearVisibilityEdge(startCoords, endCoords, isVisible)))
+        {
+            ++m_frameStats.m_numLineOfSightByPvs;
+            return isVisible;
+        }
+    }
+
     Vec2 const  fwdNormal = (endPos - startPos).GetNormalized();
     float const maxDist   = GetDistance2D(startPos, endPos);
     Ray2 const  ray       = Ray2(startPos, fwdNormal, maxDist);
@@ -188,38 +378,127 @@ bool Map::HasLineOfSight(Vec2 const& startPos,
 }
 
 //----------------------------------------------------------------------------------------------------
-bool Map::IsTileSolid(IntVec2 const& tileCoords) const
+// What every enemy asks each tick, answered from the player's view: a range check and one bit. The
+// view covers the longest detectRange any definition has, so the raycast fallback only runs for a
+// sightRange set in code past that, or on a map with no view yet.
+//
+bool Map::HasLineOfSightToPlayer(Vec2 const& position, float const sightRange) const
 {
-    if (IsTileCoordsOutOfBounds(tileCoords)) return true;
+    PlayerTank const* playerTank = GetPlayerTank();
 
-    int const tileIndex = tileCoords.y * m_dimensions.x + tileCoords.x;
+    if (!playerTank) return false;
 
-    if (tileIndex >= 0 &&
-        tileIndex < static_cast<int>(m_tiles.size()))
-    {
-        Tile const& tile = m_tiles[tileIndex];
+    if (!m_hasPlayerView || sightRange > static_cast<float>(m_playerViewRadius)) return HasLineOfSight(position, playerTank->m_position, sightRange);
+
+    ++m_frameStats.m_numPlayerSightChecks;
+
+    if (GetDistanceSquared2D(position, playerTank->m_position) >= sightRange * sightRange) return false;
+
+    IntVec2 const tileCoords = GetTileCoordsFromWorldPos(position);
+
+    return !IsTileCoordsOutOfBounds(tileCoords) && m_playerViewTiles.IsSet(tileCoords);
+}
 
-        return TileDefinition::GetTileDefByName(tile.m_name)->IsSolid() == true;
+//----------------------------------------------------------------------------------------------------
+// True when an 8-neighbor of either end tile gets the other answer. A line between two off-center
+// points strays up to half a tile from the line between their centers, so that is where the answers
+// can differ. It narrows the raycasts down but does not rule them all out: on random maps with one
+// tile in five a wall, under 0.1% of the off-center pairs it lets through disagree with RaycastVsTiles.
+//
+bool Map::IsNearVisibilityEdge(IntVec2 const& fromCoords, IntVec2 const& toCoords, bool const isVisible) const
+{
+    for (IntVec2 const& offset : {IntVec2(-1, -1), IntVec2(0, -1), IntVec2(1, -1), IntVec2(-1, 0), IntVec2(1, 0), IntVec2(-1, 1), IntVec2(0, 1), IntVec2(1, 1)})
+    {
+        if (!IsTileCoordsOutOfBounds(toCoords + offset) && m_potentiallyVisibleSet.IsPotentiallyVisible(fromCoords, toCoords + offset) != isVisible) return true;
+        if (!IsTileCoordsOutOfBounds(fromCoords + offset) && m_potentiallyVisibleSet.IsPotentiallyVisible(fromCoords + offset, toCoords) != isVisible) return true;
     }
 
     return false;
 }
 
-bool Map::IsTileWater(IntVec2 const& tileCoords) const
+//----------------------------------------------------------------------------------------------------
+// Tiles are final once the constructor has generated them, so sight between tiles is worked out once
+// here, in parallel, for any two tiles on the map. The build is a shadowcast per tile, so it grows with
+// the square of the tile count: skipped when the map has more than mapPvsMaxTiles tiles, and larger
+// maps share rows between clusters of tiles to stay inside mapPvsBudgetKB.
+//
+void Map::BuildPotentiallyVisibleSet()
 {
-    if (IsTileCoordsOutOfBounds(tileCoords)) return true;
+    int const maxTiles = g_gameConfigBlackboard.GetValue("mapPvsMaxTiles", 16384);
 
-    int const tileIndex = tileCoords.y * m_dimensions.x + tileCoords.x;
+    if (m_dimensions.x * m_dimensions.y > maxTiles)
+    {
+        GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Skip   | BuildPotentiallyVisibleSet (%d tiles, mapPvsMaxTiles %d)",
+                 m_mapDef->GetIndex(),
+                 m_dimensions.x * m_dimensions.y,
+                 maxTiles);
+        return;
+    }
+
+    int const                                   budgetKB  = std::max(g_gameConfigBlackboard.GetValue("mapPvsBudgetKB", 1024), 1);
+    std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
 
-    if (tileIndex >= 0 &&
-        tileIndex < static_cast<int>(m_tiles.size()))
+    BuildTraversabilityMask(m_transparentTiles, TILE_FLAG_SOLID, TILE_FLAG_WATER, false);
+    m_potentiallyVisibleSet.Build(m_transparentTiles, budgetKB * 1024);
+
+    double const milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Finish | BuildPotentiallyVisibleSet (%d rows, cluster %d, %.1f KB, %.2f ms)",
+             m_mapDef->GetIndex(),
+             m_potentiallyVisibleSet.GetNumRows(),
+             m_potentiallyVisibleSet.GetClusterSize(),
+             static_cast<double>(m_potentiallyVisibleSet.GetNumBytes()) / 1024.0,
+             milliseconds);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Shadowcasts the player's view from their tile once per tick, and only when they have moved to
+// another tile or the tiles have changed since the last cast. Sight between two tile centers is
+// symmetric, so "the player's tile sees mine" stands in for "I see the player".
+//
+void Map::UpdatePlayerView()
+{
+    PROFILE_SCOPE("Map::UpdatePlayerView");
+
+    PlayerTank const* playerTank = GetPlayerTank();
+
+    if (!playerTank)
     {
-        Tile const& tile = m_tiles[tileIndex];
+        m_hasPlayerView = false;
+        return;
+    }
+
+    IntVec2 const originCoords = GetTileCoordsFromWorldPos(playerTank->m_position);
 
-        return TileDefinition::GetTileDefByName(tile.m_name)->IsWater() == true;
+    if (m_hasPlayerView && originCoords == m_playerViewOrigin && m_playerViewVersion == m_traversabilityVersion) return;
+
+    if (!m_hasPlayerView || m_playerViewVersion != m_traversabilityVersion)
+    {
+        BuildTraversabilityMask(m_transparentTiles, TILE_FLAG_SOLID, TILE_FLAG_WATER, false);
     }
 
-    return false;
+    ComputeFieldOfView(m_transparentTiles, originCoords, m_playerViewRadius, m_playerViewTiles);
+
+    m_playerViewOrigin                 = originCoords;
+    m_playerViewVersion                = m_traversabilityVersion;
+    m_hasPlayerView                    = true;
+    m_frameStats.m_didRebuildPlayerView = true;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool Map::IsTileSolid(IntVec2 const& tileCoords) const
+{
+    if (IsTileCoordsOutOfBounds(tileCoords)) return true;
+
+    return (m_tileFlags.GetFlagsAtCoords(tileCoords) & TILE_FLAG_SOLID) != 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool Map::IsTileWater(IntVec2 const& tileCoords) const
+{
+    if (IsTileCoordsOutOfBounds(tileCoords)) return true;
+
+    return (m_tileFlags.GetFlagsAtCoords(tileCoords) & TILE_FLAG_WATER) != 0;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -233,16 +512,86 @@ bool Map::IsPointInSolid(Vec2 const& point) const
 //----------------------------------------------------------------------------------------------------
 void Map::UpdateEntities(float const deltaSeconds) const
 {
+    PROFILE_SCOPE("Map::UpdateEntities");
+
+    PlayerTank const* playerTank = GetPlayerTank();
+
     for (int entityIndex = 0; entityIndex < static_cast<int>(m_allEntities.size()); ++entityIndex)
     {
         Entity* entity = m_allEntities[entityIndex];
 
         if (!entity) continue;
 
-        entity->Update(deltaSeconds);
+        if (!IsAIAgent(entity))
+        {
+            entity->Update(deltaSeconds);
+            continue;
+        }
+
+        entity->m_aiLodTier = GetAILodTier(*entity, playerTank);
+        ++m_frameStats.m_numAIAgentsByLodTier[entity->m_aiLodTier];
+
+        if (ShouldRunFullAIUpdate(*entity, entityIndex))
+        {
+            ++m_frameStats.m_numFullAIUpdates;
+            entity->Update(deltaSeconds);
+        }
+        else
+        {
+            entity->FollowCachedPath(deltaSeconds);
+        }
     }
 }
 
+//----------------------------------------------------------------------------------------------------
+// Near within m_nearDistance of the player or inside the camera's view, mid out to m_midDistance and
+// far beyond. A map with no player has nobody to measure from: a background map's enemies are all far,
+// while a benchmark map keeps every enemy near so scenarios still measure the full AI.
+//
+AILodTier Map::GetAILodTier(Entity const& agent, PlayerTank const* playerTank) const
+{
+    if (!playerTank) return m_isBackground ? AI_LOD_TIER_FAR : AI_LOD_TIER_NEAR;
+
+    if (m_aiLodSettings.m_isNearWhenVisible && m_hasAILodViewBounds && m_aiLodViewBounds.IsPointInside(agent.m_position)) return AI_LOD_TIER_NEAR;
+
+    float const distanceSquared = GetDistanceSquared2D(agent.m_position, playerTank->m_position);
+
+    if (distanceSquared <= m_aiLodSettings.m_nearDistance * m_aiLodSettings.m_nearDistance) return AI_LOD_TIER_NEAR;
+    if (distanceSquared <= m_aiLodSettings.m_midDistance * m_aiLodSettings.m_midDistance) return AI_LOD_TIER_MID;
+
+    return AI_LOD_TIER_FAR;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Mid and far enemies take their turns offset by entity index, so the full updates of a crowd are
+// spread across ticks instead of landing together. Dying is always handled at once, whatever the tier.
+//
+bool Map::ShouldRunFullAIUpdate(Entity const& agent, int const entityIndex) const
+{
+    if (agent.m_health <= 0) return true;
+
+    uint32_t const slot = m_numSimulationTicks + static_cast<uint32_t>(entityIndex);
+
+    switch (agent.m_aiLodTier)
+    {
+    case AI_LOD_TIER_NEAR: return true;
+    case AI_LOD_TIER_MID: return slot % static_cast<uint32_t>(m_aiLodSettings.m_midUpdateInterval) == 0;
+    case AI_LOD_TIER_FAR: return (!agent.m_path || agent.m_path->IsEmpty()) && slot % static_cast<uint32_t>(m_aiLodSettings.m_farUpdateInterval) == 0;
+    case NUM_AI_LOD_TIERS: break;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The Game passes the world camera's bounds every frame for the map it is showing.
+//
+void Map::SetAILodViewBounds(AABB2 const& viewBounds)
+{
+    m_aiLodViewBounds    = viewBounds;
+    m_hasAILodViewBounds = true;
+}
+
 //----------------------------------------------------------------------------------------------------
 void Map::RenderTiles() const
 {
@@ -291,22 +640,16 @@ void Map::RenderTileHeatMap() const
 {
     if (m_currentTileHeatMapIndex == -1) return;
 
-    AABB2 const totalBounds = GetMapBound();
+    TileDistanceField const* field = GetDebugDistanceField();
 
-    VertexList_PCU verts;
+    if (!field) return;
 
-    if (m_currentTileHeatMapIndex == 3)
-    {
-        if (!m_currentSelectedEntity->m_heatMap) return;
+    AABB2 const totalBounds = GetMapBound();
 
-        m_currentSelectedEntity->m_heatMap->AddVertsForDebugDraw(verts, totalBounds);
-    }
-    else
-    {
-        if (!m_tileHeatMaps[m_currentTileHeatMapIndex]) return;
+    VertexList_PCU verts;
 
-        m_tileHeatMaps[m_currentTileHeatMapIndex]->AddVertsForDebugDraw(verts, totalBounds);
-    }
+    field->CopyToTileHeatMap(*m_debugHeatMap);
+    m_debugHeatMap->AddVertsForDebugDraw(verts, totalBounds);
 
     g_theRenderer->BindTexture(nullptr);
     g_theRenderer->DrawVertexArray(static_cast<int>(verts.size()), verts.data());
@@ -363,31 +706,19 @@ void Map::DebugRenderEntities() const
 //----------------------------------------------------------------------------------------------------
 void Map::DebugRenderTileIndex() const
 {
-    if (m_currentTileHeatMapIndex == -1) return;
+    TileDistanceField const* field = GetDebugDistanceField();
+
+    if (!field) return;
 
     for (int tileY = 0; tileY < m_dimensions.y; ++tileY)
     {
         for (int tileX = 0; tileX < m_dimensions.x; ++tileX)
         {
-            TileHeatMap const* heatMap;
+            uint16_t const distance = field->GetValueAtCoords(tileX, tileY);
+            int const      value    = distance == TileDistanceField::UNREACHABLE ? 999 : distance;
+            VertexList_PCU textVerts;
 
-            if (m_currentTileHeatMapIndex == 3)
-            {
-                if (!m_currentSelectedEntity->m_heatMap) return;
-
-                heatMap = m_currentSelectedEntity->m_heatMap;
-            }
-            else
-            {
-                if (!m_tileHeatMaps[m_currentTileHeatMapIndex]) return;
-
-                heatMap = m_tileHeatMaps[m_currentTileHeatMapIndex];
-            }
-
-            float const value = heatMap->GetValueAtCoords(tileX, tileY);
-            VertexList_PCU  textVerts;
-
-            g_theBitmapFont->AddVertsForText2D(textVerts, std::to_string(static_cast<int>(value)), Vec2(tileX, tileY), 0.2f, Rgba8::WHITE);
+            g_theBitmapFont->AddVertsForText2D(textVerts, std::to_string(value), Vec2(tileX, tileY), 0.2f, Rgba8::WHITE);
             g_theRenderer->BindTexture(&g_theBitmapFont->GetTexture());
             g_theRenderer->DrawVertexArray(static_cast<int>(textVerts.size()), textVerts.data());
         }
@@ -397,51 +728,106 @@ void Map::DebugRenderTileIndex() const
 //----------------------------------------------------------------------------------------------------
 void Map::InitializeTileHeatMaps()
 {
-    m_tileHeatMaps.reserve(4);
+    m_distanceFields.reserve(4);
 
     for (int i = 0; i < 4; ++i)
     {
-        m_tileHeatMaps.push_back(new TileHeatMap(m_dimensions, 999.f));
+        m_distanceFields.push_back(new TileDistanceField(m_dimensions));
     }
+
+    m_debugHeatMap = new TileHeatMap(m_dimensions, 999.f);
 }
 
 //----------------------------------------------------------------------------------------------------
-void Map::GenerateAllTiles()
+// The four fields only read the finished tiles, so they are built side by side; each flood fill may
+// split its own frontier across the same pool.
+//
+void Map::PopulateMapDistanceFields()
 {
-    printf("( Map%d ) Start  | GenerateAllTiles\n", m_mapDef->GetIndex());
+    PROFILE_SCOPE("Map::PopulateMapDistanceFields");
 
-    for (int y = 0; y < m_dimensions.y; ++y)
+    auto const populateField = [this](int const fieldIndex)
     {
-        for (int x = 0; x < m_dimensions.x; ++x)
+        TileDistanceField& field = *m_distanceFields[fieldIndex];
+
+        switch (fieldIndex)
         {
-            m_tiles.emplace_back();
+        case 0: PopulateDistanceField(field, m_startPosition); break;
+        case 1: PopulateDistanceFieldForLandBased(field); break;
+        case 2: PopulateDistanceFieldForAmphibian(field); break;
+        case 3: PopulateDistanceFieldForEntity(field, m_startPosition); break;
+        default: break;
         }
-    }
+    };
 
-    MapDefinition const* mapDef = MapDefinition::s_mapDefinitions[GetMapIndex()];
+    int const numFields = static_cast<int>(m_distanceFields.size());
 
-    GenerateTilesByType("Stone");
-    GenerateWormTiles(mapDef->GetWorm01TileName(), mapDef->GetWorm01Num(), mapDef->GetWorm01Length());
-    GenerateWormTiles(mapDef->GetWorm02TileName(), mapDef->GetWorm02Num(), mapDef->GetWorm02Length());
-    GenerateWormTiles(mapDef->GetWorm03TileName(), mapDef->GetWorm03Num(), mapDef->GetWorm03Length());
+    if (g_theWorkerPool)
+    {
+        g_theWorkerPool->ParallelFor(numFields, populateField);
+        return;
+    }
 
-    GenerateTilesByType("Floor");
+    for (int fieldIndex = 0; fieldIndex < numFields; ++fieldIndex)
+    {
+        populateField(fieldIndex);
+    }
+}
 
-    GenerateLShapeTiles(2, 2, 5, 5, false);
-    GenerateLShapeTiles(m_dimensions.x - 9, m_dimensions.y - 9, 7, 7, true);
-    GenerateStartPosTile();
-    GenerateExitPosTile();
+//----------------------------------------------------------------------------------------------------
+// The field shown by the F6 debug view: one of the map's fields, or the selected entity's own.
+//
+TileDistanceField const* Map::GetDebugDistanceField() const
+{
+    if (m_currentTileHeatMapIndex == -1) return nullptr;
 
-    if (!IsValidMap(IntVec2::ONE, m_exitPosition, 100))
+    if (m_currentTileHeatMapIndex == 3)
     {
-        ERROR_AND_DIE("Failed to GenerateAllTiles!")
+        return m_currentSelectedEntity ? m_currentSelectedEntity->m_distanceField : nullptr;
     }
 
-    TileHeatMap const heatMap(m_dimensions, 999.f);
-    PopulateDistanceField(heatMap, IntVec2::ONE, 999.f);
-    ConvertUnreachableTilesToSolid(heatMap, "Stone");
+    return m_distanceFields[m_currentTileHeatMapIndex];
+}
+
+//----------------------------------------------------------------------------------------------------
+void Map::GenerateAllTiles()
+{
+    PROFILE_SCOPE("Map::GenerateAllTiles");
+
+    GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Start  | GenerateAllTiles", m_mapDef->GetIndex());
+
+    m_tiles.resize(static_cast<size_t>(m_dimensions.x) * static_cast<size_t>(m_dimensions.y));
+
+    MapDefinition const* mapDef      = m_mapDef;
+    int constexpr        maxAttempts = 100;
+
+    // Every attempt rewrites every tile, so a rejected layout is simply generated over
+    for (int attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        GenerateTilesByType("Stone");
+        GenerateWormTiles(mapDef->GetWorm01TileName(), mapDef->GetWorm01Num(), mapDef->GetWorm01Length());
+        GenerateWormTiles(mapDef->GetWorm02TileName(), mapDef->GetWorm02Num(), mapDef->GetWorm02Length());
+        GenerateWormTiles(mapDef->GetWorm03TileName(), mapDef->GetWorm03Num(), mapDef->GetWorm03Length());
+
+        GenerateTilesByType("Floor");
 
-    printf("( Map%d ) Finish | GenerateAllTiles\n", m_mapDef->GetIndex());
+        GenerateLShapeTiles(2, 2, 5, 5, false);
+        GenerateLShapeTiles(m_dimensions.x - 9, m_dimensions.y - 9, 7, 7, true);
+        GenerateStartPosTile();
+        GenerateExitPosTile();
+
+        TileBitmap reachableTiles;
+
+        if (IsValidMap(IntVec2::ONE, m_exitPosition, reachableTiles))
+        {
+            ConvertUnreachableTilesToSolid(reachableTiles, "Stone");
+
+            GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Finish | GenerateAllTiles", m_mapDef->GetIndex());
+            return;
+        }
+    }
+
+    ERROR_AND_DIE("Failed to generate a valid map after maximum attempts!")
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -547,10 +933,21 @@ void Map::SetTileAtCoords(String const& tileName, int const tileX, int const til
 
     m_tiles[tileIndex].m_coords = IntVec2(tileX, tileY);
     m_tiles[tileIndex].m_name   = tileName;
+
+    // Cache the definition's flags so IsTileSolid / IsTileWater and the mask kernels skip the name lookup
+    TileDefinition const* tileDef = TileDefinition::GetTileDefByName(tileName);
+    uint8_t               flags   = TILE_FLAG_NONE;
+
+    if (tileDef && tileDef->IsSolid()) flags |= TILE_FLAG_SOLID;
+    if (tileDef && tileDef->IsWater()) flags |= TILE_FLAG_WATER;
+
+    m_tileFlags.SetFlagsAtCoords(IntVec2(tileX, tileY), flags);
+    m_potentiallyVisibleSet.Reset();
+    ++m_traversabilityVersion;
 }
 
 //----------------------------------------------------------------------------------------------------
-void Map::ConvertUnreachableTilesToSolid(TileHeatMap const& heatMap, String const& tileName)
+void Map::ConvertUnreachableTilesToSolid(TileBitmap const& reachableTiles, String const& tileName)
 {
     for (int y = 0; y < m_dimensions.y; ++y)
     {
@@ -559,7 +956,7 @@ void Map::ConvertUnreachableTilesToSolid(TileHeatMap const& heatMap, String cons
             IntVec2 tileCoords(x, y);
 
             if (!IsTileSolid(tileCoords) &&
-                heatMap.GetValueAtCoords(IntVec2(x, y)) == 999.f)
+                !reachableTiles.IsSet(tileCoords))
             {
                 SetTileAtCoords(tileName, x, y);
             }
@@ -627,22 +1024,40 @@ bool Map::IsWorldPosOccupiedByEntity(Vec2 const& position, EntityType const type
     return false;
 }
 
-bool Map::IsValidMap(IntVec2 const& startCoords, IntVec2 const& exitCoords, int const maxAttempts)
+//----------------------------------------------------------------------------------------------------
+// A scorpio blocks its tile only while it sits exactly on the tile center, matching
+// IsWorldPosOccupiedByEntity.
+//
+void Map::RebuildScorpioOccupancy()
 {
-    for (int attempt = 0; attempt < maxAttempts; ++attempt)
+    m_scorpioOccupancy.ClearAll();
+    ++m_traversabilityVersion;
+
+    for (Entity const* scorpio : m_entitiesByType[ENTITY_TYPE_SCORPIO])
     {
-        TileHeatMap heatMap(m_dimensions, 999.f);
-        PopulateDistanceField(heatMap, startCoords, 999.f);
+        IntVec2 const tileCoords = GetTileCoordsFromWorldPos(scorpio->m_position);
+
+        if (IsTileCoordsOutOfBounds(tileCoords)) continue;
 
-        if (heatMap.GetValueAtCoords(exitCoords) != 999.f)
+        if (scorpio->m_position == Vec2(tileCoords) + Vec2(0.5f, 0.5f))
         {
-            return true;
+            m_scorpioOccupancy.Set(tileCoords);
         }
-
-        GenerateAllTiles();
     }
+}
 
-    ERROR_AND_DIE("Failed to generate a valid map after maximum attempts!")
+//----------------------------------------------------------------------------------------------------
+// Connectivity only, so a bitboard flood fill over the same tiles PopulateDistanceField walks (not
+// solid, not water) replaces a full distance-field pass. outReachableTiles is kept for the caller.
+//
+bool Map::IsValidMap(IntVec2 const& startCoords, IntVec2 const& exitCoords, TileBitmap& outReachableTiles) const
+{
+    TileBitmap passableTiles;
+
+    BuildTraversabilityMask(passableTiles, TILE_FLAG_SOLID | TILE_FLAG_WATER, TILE_FLAG_NONE, false);
+    FloodFillPassableMask(passableTiles, startCoords, outReachableTiles);
+
+    return outReachableTiles.IsSet(exitCoords);
 }
 
 
@@ -676,353 +1091,296 @@ AABB2 const Map::GetTileBounds(int const tileIndex) const
 //----------------------------------------------------------------------------------------------------
 IntVec2 Map::RollRandomTileCoords() const
 {
-    int const randomX = g_theRNG->RollRandomIntInRange(0, m_dimensions.x - 1);
-    int const randomY = g_theRNG->RollRandomIntInRange(0, m_dimensions.y - 1);
+    int const randomX = m_random.RollRandomIntInRange(0, m_dimensions.x - 1);
+    int const randomY = m_random.RollRandomIntInRange(0, m_dimensions.y - 1);
 
     return IntVec2(randomX, randomY);
 }
 
 //----------------------------------------------------------------------------------------------------
-IntVec2 Map::RollRandomTraversableTileCoords(TileHeatMap const& heatMap, IntVec2 const& startCoords) const
+// A uniformly random tile that a land-based agent at startCoords can walk to. The answer is the same
+// set a flood from startCoords would reach, but it comes from the cached regions, so choosing a
+// wander goal costs no flood and stays out of the path request budget. A start tile that is itself
+// blocked (a scorpio's) reaches whatever its open neighbors do, as the flood would.
+//
+IntVec2 Map::RollRandomTraversableTileCoords(IntVec2 const& startCoords)
 {
-    // 先填充距離場
-    PopulateDistanceFieldForEntity(heatMap, startCoords, 999.f);
+    PROFILE_SCOPE("Map::RollRandomTraversableTileCoords");
 
-    // 儲存可到達的座標
-    std::vector<IntVec2> traversableCoords;
+    UpdateReachableRegions();
 
-    // 遍歷整個地圖的每個座標
-    for (int y = 0; y < m_dimensions.y; ++y)
+    IntVec2 const neighborOffsets[5] = {IntVec2::ZERO, IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1)};
+    int           regions[5]         = {};
+    int           numRegions         = 0;
+    int           numTiles           = 0;
+
+    for (IntVec2 const& offset : neighborOffsets)
     {
-        for (int x = 0; x < m_dimensions.x; ++x)
-        {
-            IntVec2 currentCoords(x, y);
+        IntVec2 const coords = startCoords + offset;
 
-            // 檢查該座標是否可到達
-            if (IsTileSolid(currentCoords) ||
-                IsWorldPosOccupiedByEntity(Vec2(x, y) + Vec2(0.5f, 0.5f), ENTITY_TYPE_SCORPIO) ||
-                heatMap.GetValueAtCoords(currentCoords) == 999.f)
-                continue;
+        if (IsTileCoordsOutOfBounds(coords)) continue;
 
-            traversableCoords.push_back(currentCoords);
-        }
+        int const region = m_reachableRegionByTile[coords.y * m_dimensions.x + coords.x];
+
+        if (region < 0 || std::find(regions, regions + numRegions, region) != regions + numRegions) continue;
+
+        regions[numRegions++] = region;
+        numTiles += m_reachableRegionStarts[region + 1] - m_reachableRegionStarts[region];
+
+        // An open start tile reaches exactly its own region
+        if (offset == IntVec2::ZERO) break;
     }
 
-    // 如果沒有可到達的座標，回傳一個無效座標或進行處理
-    if (traversableCoords.empty())
+    if (numTiles == 0)
     {
         ERROR_AND_DIE("No traversable tiles found!");
     }
 
-    // 從可到達的座標中隨機選擇一個
-    int randomIndex = g_theRNG->RollRandomIntInRange(0, static_cast<int>(traversableCoords.size() - 1));
-    return traversableCoords[randomIndex];
-}
+    int tileNumber = m_random.RollRandomIntInRange(0, numTiles - 1);
 
-//----------------------------------------------------------------------------------------------------
-IntVec2 Map::RollRandomCardinalDirection() const
-{
-    switch (g_theRNG->RollRandomIntInRange(0, 3))
+    for (int regionIndex = 0; regionIndex < numRegions; ++regionIndex)
     {
-    case 0:
-        return IntVec2(0, 1);
-    case 1:
-        return IntVec2(1, 0);
-    case 2:
-        return IntVec2(0, -1);
-    case 3:
-        return IntVec2(-1, 0);
-    }
-    return IntVec2::ZERO;
-}
+        int const firstTile      = m_reachableRegionStarts[regions[regionIndex]];
+        int const numRegionTiles = m_reachableRegionStarts[regions[regionIndex] + 1] - firstTile;
 
-//----------------------------------------------------------------------------------------------------
-void Map::GenerateHeatMaps(TileHeatMap const& heatMap) const
-{
-    printf("( Map%d ) Start  | GenerateHeatMaps\n", m_mapDef->GetIndex());
-
-    for (int y = 0; y < m_dimensions.y; ++y)
-    {
-        for (int x = 0; x < m_dimensions.x; ++x)
+        if (tileNumber < numRegionTiles)
         {
-            IntVec2 tileCoords(x, y);
-
-            if (IsTileSolid(tileCoords))
-            {
-                heatMap.SetValueAtCoords(tileCoords, 999.f);
-            }
+            int const tileIndex = m_reachableTilesByRegion[firstTile + tileNumber];
+            return IntVec2(tileIndex % m_dimensions.x, tileIndex / m_dimensions.x);
         }
+
+        tileNumber -= numRegionTiles;
     }
 
-    printf("( Map%d ) Finish | GenerateHeatMaps\n", m_mapDef->GetIndex());
+    return startCoords;
 }
 
 //----------------------------------------------------------------------------------------------------
-void Map::PopulateDistanceField(TileHeatMap const& heatMap, IntVec2 const& startCoords, float const specialValue) const
+// Labels the 4-connected regions of tiles a land-based agent may stand on (not solid, water or a
+// scorpio's) and lists each region's tiles in row order. Only redone when m_traversabilityVersion moves,
+// which for a generated map means when a scorpio is added or removed.
+//
+void Map::UpdateReachableRegions()
 {
-    // printf("( Map%d ) Start  | GenerateDistanceField\n", m_mapDef->GetIndex());
+    if (m_hasReachableRegions && m_reachableRegionsVersion == m_traversabilityVersion) return;
 
-    heatMap.SetValueAtAllTiles(specialValue);
-    heatMap.SetValueAtCoords(startCoords, 0.f);
+    PROFILE_SCOPE("Map::UpdateReachableRegions");
 
-    float currentSearchValue = 0.f;
-    bool  isStillGoing       = true;
+    TileBitmap passableMask;
+    BuildTraversabilityMask(passableMask, TILE_FLAG_SOLID | TILE_FLAG_WATER, TILE_FLAG_NONE, true);
 
-    while (isStillGoing)    // For each pass, assume we're done UNLESS something changes
-    {
-        isStillGoing = false;
-
-        for (int tileY = 0; tileY < m_dimensions.y; ++tileY)
-        {
-            for (int tileX = 0; tileX < m_dimensions.x; ++tileX)
-            {
-                IntVec2     tileCoords(tileX, tileY);
-                float const value = heatMap.GetValueAtCoords(tileX, tileY);
-
-                if (std::fabs(value - currentSearchValue) < FLOAT_MIN)
-                {
-                    // Found a search value ! Spread to cardinal neighbors...
-                    IntVec2     n               = tileCoords + IntVec2(0, 1);
-                    IntVec2     e               = tileCoords + IntVec2(1, 0);
-                    IntVec2     w               = tileCoords + IntVec2(-1, 0);
-                    IntVec2     s               = tileCoords + IntVec2(0, -1);
-                    float const nextSearchValue = currentSearchValue + 1.f;
-
-                    if (!IsTileCoordsOutOfBounds(e) && !IsTileSolid(e) && !IsTileWater(e) && heatMap.GetValueAtCoords(e) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(e, nextSearchValue);
-                        isStillGoing = true;
-                    }
+    int const numTiles   = GetTileNums();
+    int       numRegions = 0;
 
-                    if (!IsTileCoordsOutOfBounds(n) && !IsTileSolid(n) && !IsTileWater(n) && heatMap.GetValueAtCoords(n) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(n, nextSearchValue);
-                        isStillGoing = true;
-                    }
+    m_reachableRegionByTile.assign(numTiles, -1);
+    m_reachableRegionStarts.assign(1, 0);
 
-                    if (!IsTileCoordsOutOfBounds(s) && !IsTileSolid(s) && !IsTileWater(s) && heatMap.GetValueAtCoords(s) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(s, nextSearchValue);
-                        isStillGoing = true;
-                    }
+    std::vector<int> stack;
 
-                    if (!IsTileCoordsOutOfBounds(w) && !IsTileSolid(w) && !IsTileWater(w) && heatMap.GetValueAtCoords(w) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(w, nextSearchValue);
-                        isStillGoing = true;
-                    }
-                }
-            }
-        }
-        currentSearchValue++;
-    }
+    for (int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
+    {
+        IntVec2 const coords(tileIndex % m_dimensions.x, tileIndex / m_dimensions.x);
 
-    // printf("( Map%d ) Finish | GenerateDistanceField\n", m_mapDef->GetIndex());
-}
+        if (m_reachableRegionByTile[tileIndex] >= 0 || !passableMask.IsSet(coords)) continue;
 
-void Map::PopulateDistanceFieldForEntity(TileHeatMap const& heatMap, IntVec2 const& startCoords, float specialValue) const
-{
-    // printf("( Map%d ) Start  | GenerateDistanceField\n", m_mapDef->GetIndex());
+        int regionSize = 0;
 
-    heatMap.SetValueAtAllTiles(specialValue);
-    heatMap.SetValueAtCoords(startCoords, 0.f);
+        m_reachableRegionByTile[tileIndex] = numRegions;
+        stack.push_back(tileIndex);
 
-    float currentSearchValue = 0.f;
-    bool  isStillGoing       = true;
+        while (!stack.empty())
+        {
+            int const     currentIndex = stack.back();
+            IntVec2 const current(currentIndex % m_dimensions.x, currentIndex / m_dimensions.x);
 
-    while (isStillGoing)    // For each pass, assume we're done UNLESS something changes
-    {
-        isStillGoing = false;
+            stack.pop_back();
+            ++regionSize;
 
-        for (int tileY = 0; tileY < m_dimensions.y; ++tileY)
-        {
-            for (int tileX = 0; tileX < m_dimensions.x; ++tileX)
+            for (IntVec2 const& step : {IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1)})
             {
-                IntVec2     tileCoords(tileX, tileY);
-                float const value = heatMap.GetValueAtCoords(tileX, tileY);
+                IntVec2 const neighbor = current + step;
 
-                if (std::fabs(value - currentSearchValue) < FLOAT_MIN)
-                {
-                    // Found a search value ! Spread to cardinal neighbors...
-                    IntVec2     n               = tileCoords + IntVec2(0, 1);
-                    IntVec2     e               = tileCoords + IntVec2(1, 0);
-                    IntVec2     w               = tileCoords + IntVec2(-1, 0);
-                    IntVec2     s               = tileCoords + IntVec2(0, -1);
-                    float const nextSearchValue = currentSearchValue + 1.f;
-
-                    if (!IsTileCoordsOutOfBounds(e) && !IsTileSolid(e) && !IsTileWater(e) && !IsWorldPosOccupiedByEntity(Vec2(e) + Vec2(0.5f, 0.5f), ENTITY_TYPE_SCORPIO) && heatMap.GetValueAtCoords(e) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(e, nextSearchValue);
-                        isStillGoing = true;
-                    }
+                if (IsTileCoordsOutOfBounds(neighbor) || !passableMask.IsSet(neighbor)) continue;
 
-                    if (!IsTileCoordsOutOfBounds(n) && !IsTileSolid(n) && !IsTileWater(n) && !IsWorldPosOccupiedByEntity(Vec2(n) + Vec2(0.5f, 0.5f), ENTITY_TYPE_SCORPIO) && heatMap.GetValueAtCoords(n) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(n, nextSearchValue);
-                        isStillGoing = true;
-                    }
+                int const neighborIndex = neighbor.y * m_dimensions.x + neighbor.x;
 
-                    if (!IsTileCoordsOutOfBounds(s) && !IsTileSolid(s) && !IsTileWater(s) && !IsWorldPosOccupiedByEntity(Vec2(s) + Vec2(0.5f, 0.5f), ENTITY_TYPE_SCORPIO) && heatMap.GetValueAtCoords(s) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(s, nextSearchValue);
-                        isStillGoing = true;
-                    }
+                if (m_reachableRegionByTile[neighborIndex] >= 0) continue;
 
-                    if (!IsTileCoordsOutOfBounds(w) && !IsTileSolid(w) && !IsTileWater(w) && !IsWorldPosOccupiedByEntity(Vec2(w) + Vec2(0.5f, 0.5f), ENTITY_TYPE_SCORPIO) && heatMap.GetValueAtCoords(w) > nextSearchValue)
-                    {
-                        heatMap.SetValueAtCoords(w, nextSearchValue);
-                        isStillGoing = true;
-                    }
-                }
+                m_reachableRegionByTile[neighborIndex] = numRegions;
+                stack.push_back(neighborIndex);
             }
         }
-        currentSearchValue++;
-    }
 
-    // printf("( Map%d ) Finish | GenerateDistanceField\n", m_mapDef->GetIndex());
-}
+        m_reachableRegionStarts.push_back(m_reachableRegionStarts.back() + regionSize);
+        ++numRegions;
+    }
 
+    // Counting sort by region keeps each region's tiles in row order
+    std::vector<int> nextSlot(m_reachableRegionStarts.begin(), m_reachableRegionStarts.end() - 1);
+    m_reachableTilesByRegion.assign(m_reachableRegionStarts.back(), 0);
 
-//----------------------------------------------------------------------------------------------------
-void Map::PopulateDistanceFieldForLandBased(TileHeatMap const& heatMap) const
-{
-    for (int tileY = 0; tileY < m_dimensions.y; ++tileY)
+    for (int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
     {
-        for (int tileX = 0; tileX < m_dimensions.x; ++tileX)
-        {
-            Vec2 worldPos = Vec2(tileX, tileY) + Vec2(0.5f, 0.5f);
+        int const region = m_reachableRegionByTile[tileIndex];
 
-            if (IsWorldPosOccupiedByEntity(worldPos, ENTITY_TYPE_SCORPIO))
-            {
-                continue;
-            }
+        if (region >= 0) m_reachableTilesByRegion[nextSlot[region]++] = tileIndex;
+    }
 
-            IntVec2 tileCoords(tileX, tileY);
+    m_reachableRegionsVersion = m_traversabilityVersion;
+    m_hasReachableRegions     = true;
+}
 
-            if (!IsTileCoordsOutOfBounds(tileCoords) && !IsTileSolid(tileCoords))
-            {
-                heatMap.SetValueAtCoords(tileCoords, 0.f);
-            }
-        }
+//----------------------------------------------------------------------------------------------------
+IntVec2 Map::RollRandomCardinalDirection() const
+{
+    switch (m_random.RollRandomIntInRange(0, 3))
+    {
+    case 0:
+        return IntVec2(0, 1);
+    case 1:
+        return IntVec2(1, 0);
+    case 2:
+        return IntVec2(0, -1);
+    case 3:
+        return IntVec2(-1, 0);
     }
+    return IntVec2::ZERO;
 }
 
 //----------------------------------------------------------------------------------------------------
-void Map::PopulateDistanceFieldForAmphibian(TileHeatMap const& heatMap) const
+void Map::GenerateHeatMaps(TileDistanceField& field) const
 {
-    for (int tileY = 0; tileY < m_dimensions.y; ++tileY)
+    GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Start  | GenerateHeatMaps", m_mapDef->GetIndex());
+
+    for (int y = 0; y < m_dimensions.y; ++y)
     {
-        for (int tileX = 0; tileX < m_dimensions.x; ++tileX)
+        for (int x = 0; x < m_dimensions.x; ++x)
         {
-            Vec2 worldPos = Vec2(tileX, tileY) + Vec2(0.5f, 0.5f);
-
-            if (IsWorldPosOccupiedByEntity(worldPos, ENTITY_TYPE_SCORPIO))
-            {
-                continue;
-            }
-
-            IntVec2 tileCoords(tileX, tileY);
+            IntVec2 tileCoords(x, y);
 
-            if (!IsTileCoordsOutOfBounds(tileCoords) &&
-                !IsTileSolid(tileCoords) ||
-                IsTileWater(tileCoords))
+            if (IsTileSolid(tileCoords))
             {
-                heatMap.SetValueAtCoords(tileCoords, 0.f);
+                field.SetValueAtCoords(tileCoords, TileDistanceField::UNREACHABLE);
             }
         }
     }
+
+    GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Finish | GenerateHeatMaps", m_mapDef->GetIndex());
 }
 
-void Map::PopulateDistanceFieldToPosition(TileHeatMap const& heatMap, IntVec2 const& playerCoords) const
+//----------------------------------------------------------------------------------------------------
+void Map::PopulateDistanceField(TileDistanceField& field, IntVec2 const& startCoords) const
 {
-    // printf("( Map%d ) Start  | GenerateDistanceFieldToPlayerPosition\n", m_mapDef->GetIndex());
+    FloodFillDistanceField(field, startCoords, true, false);
+}
 
-    heatMap.SetValueAtAllTiles(999.f);
-    heatMap.SetValueAtCoords(playerCoords, 0.f);
+//----------------------------------------------------------------------------------------------------
+void Map::PopulateDistanceFieldForEntity(TileDistanceField& field, IntVec2 const& startCoords) const
+{
+    FloodFillDistanceField(field, startCoords, true, true);
+}
 
-    std::queue<IntVec2> openList;
-    openList.push(playerCoords);
+//----------------------------------------------------------------------------------------------------
+void Map::PopulateDistanceFieldForLandBased(TileDistanceField& field) const
+{
+    TileBitmap passableMask;
 
-    while (!openList.empty())
-    {
-        IntVec2 currentTile = openList.front();
-        openList.pop();
+    BuildTraversabilityMask(passableMask, TILE_FLAG_SOLID, TILE_FLAG_NONE, true);
+    ExpandPassableMaskToDistanceField(passableMask, field);
+}
 
-        float const currentDistance = heatMap.GetValueAtCoords(currentTile);
+//----------------------------------------------------------------------------------------------------
+// Water counts as passable even though it is flagged solid.
+//
+void Map::PopulateDistanceFieldForAmphibian(TileDistanceField& field) const
+{
+    TileBitmap passableMask;
 
-        // ???? tile ??????? (N, E, S, W)
-        IntVec2 neighbors[] = {
-            currentTile + IntVec2(0, 1),  // ? (N)
-            currentTile + IntVec2(1, 0),  // ? (E)
-            currentTile + IntVec2(0, -1), // ? (S)
-            currentTile + IntVec2(-1, 0)  // ? (W)
-        };
+    BuildTraversabilityMask(passableMask, TILE_FLAG_SOLID, TILE_FLAG_WATER, true);
+    ExpandPassableMaskToDistanceField(passableMask, field);
+}
 
-        for (IntVec2 const& neighbor : neighbors)
-        {
-            if (IsTileCoordsOutOfBounds(neighbor) || IsTileSolid(neighbor) || IsWorldPosOccupiedByEntity(Vec2(neighbor) + Vec2(0.5f, 0.5f), ENTITY_TYPE_SCORPIO))
-            {
-                continue; // ??????????????
-            }
+//----------------------------------------------------------------------------------------------------
+void Map::BuildTraversabilityMask(TileBitmap&   outMask,
+                                  uint8_t const blockFlags,
+                                  uint8_t const allowFlags,
+                                  bool const    isBlockedByScorpio) const
+{
+    BuildPassableMask(m_tileFlags, isBlockedByScorpio ? &m_scorpioOccupancy : nullptr, blockFlags, allowFlags, outMask);
+}
 
-            float const neighborDistance = heatMap.GetValueAtCoords(neighbor);
-            float const newDistance      = currentDistance + 1.f; // ??? tile ??? +1
+//----------------------------------------------------------------------------------------------------
+void Map::PopulateDistanceFieldToPosition(TileDistanceField& field, IntVec2 const& playerCoords) const
+{
+    FloodFillDistanceField(field, playerCoords, false, true);
+}
 
-            if (newDistance < neighborDistance) // ?????????
-            {
-                heatMap.SetValueAtCoords(neighbor, newDistance);
-                openList.push(neighbor); // ??????????????
-            }
-        }
-    }
+//----------------------------------------------------------------------------------------------------
+// Shared by every PopulateDistanceField* variant that floods from a start tile. Solid tiles always
+// block; water and scorpio-occupied tiles block when asked to.
+//
+void Map::FloodFillDistanceField(TileDistanceField& field,
+                                 IntVec2 const&     startCoords,
+                                 bool const         isBlockedByWater,
+                                 bool const         isBlockedByScorpio) const
+{
+    PROFILE_SCOPE("Map::FloodFillDistanceField");
+
+    TileBitmap    passableMask;
+    uint8_t const blockFlags = isBlockedByWater ? TILE_FLAG_SOLID | TILE_FLAG_WATER : TILE_FLAG_SOLID;
 
-    // printf("( Map%d ) Finish | GenerateDistanceFieldToPlayerPosition\n", m_mapDef->GetIndex());
+    BuildTraversabilityMask(passableMask, blockFlags, TILE_FLAG_NONE, isBlockedByScorpio);
+    PopulateDistanceFieldBFS(passableMask, startCoords, field);
 }
 
-std::vector<Vec2> Map::GenerateEntityPathToGoal(TileHeatMap const& heatMap, Vec2 const& start, Vec2 const& goal) const
+//----------------------------------------------------------------------------------------------------
+// Identifies a flood to goal's tile under the current traversability, in the form TileDistanceField
+// stores as its source key. 0 when the goal is off the map, which never matches a field.
+//
+uint64_t Map::GetPathSourceKey(Vec2 const& goal) const
 {
-    // 初始化熱圖，設置高初始值
-    // TileHeatMap heatMap(GetMapDimension(), 999.f);
-
-    // 計算目標在地圖上的座標
-    IntVec2 goalCoords = GetTileCoordsFromWorldPos(goal);
+    IntVec2 const goalCoords = GetTileCoordsFromWorldPos(goal);
 
-    // 填充距離場，用於計算路徑
-    PopulateDistanceFieldToPosition(heatMap, goalCoords);
+    if (IsTileCoordsOutOfBounds(goalCoords)) return 0;
 
-    // 設置當前位置
-    IntVec2           currentCoords = GetTileCoordsFromWorldPos(start);
-    std::vector<Vec2> path;
-    path.reserve((int)(m_dimensions.x * m_dimensions.y));
+    return (static_cast<uint64_t>(m_traversabilityVersion) + 1) << 32 | static_cast<uint32_t>(goalCoords.y * m_dimensions.x + goalCoords.x);
+}
 
-    while (currentCoords != goalCoords)
-    {
-        path.push_back(GetWorldPosFromTileCoords(currentCoords));
+//----------------------------------------------------------------------------------------------------
+// Writes the path goal-first into outPath. The distance at the start tile is the exact number of
+// tile steps, so the corridor is sized once up front instead of growing while descending. The flood
+// is skipped when the field already holds distances to the same goal tile and nothing that blocks
+// movement has changed since, which is the common case for an agent chasing a player who has not
+// left their tile.
+//
+void Map::GenerateEntityPathToGoal(TileDistanceField& field, Vec2 const& start, Vec2 const& goal, PathCorridor& outPath)
+{
+    PROFILE_SCOPE("Map::GenerateEntityPathToGoal");
+    MapPathRequestScope const pathRequestScope(m_phaseListener);
 
-        // 找到熱值最低的相鄰 tile
-        IntVec2 bestNeighbor = currentCoords;
-        float   lowestHeat   = heatMap.GetValueAtCoords(currentCoords);
+    IntVec2 const  goalCoords = GetTileCoordsFromWorldPos(goal);
+    uint64_t const sourceKey  = GetPathSourceKey(goal);
 
-        for (IntVec2 const& offset : {IntVec2(-1, 0), IntVec2(1, 0), IntVec2(0, -1), IntVec2(0, 1)})
-        {
-            IntVec2 neighbor = currentCoords + offset;
-            float   heat     = heatMap.GetValueAtCoords(neighbor);
+    if (sourceKey == 0 || field.GetSourceKey() != sourceKey)
+    {
+        PopulateDistanceFieldToPosition(field, goalCoords);
+        field.SetSourceKey(sourceKey);
+    }
 
-            if (heat < lowestHeat)
-            {
-                lowestHeat   = heat;
-                bestNeighbor = neighbor;
-            }
-        }
+    IntVec2 const  startCoords   = GetTileCoordsFromWorldPos(start);
+    uint16_t const startDistance = IsTileCoordsOutOfBounds(startCoords) ? TileDistanceField::UNREACHABLE : field.GetValueAtCoords(startCoords);
 
-        // 更新當前位置
-        currentCoords = bestNeighbor;
+    // Start is cut off from the goal; head straight for it and let wall pushing sort it out
+    if (startDistance == TileDistanceField::UNREACHABLE)
+    {
+        Vec2* points = m_pathArena.ResizeCorridor(outPath, 1);
+        points[0]    = goal;
+        return;
     }
 
-    // 添加最終目標點
-    path.push_back(goal);
-    std::reverse(path.begin(), path.end());
-    return path;
+    Vec2* points = m_pathArena.ResizeCorridor(outPath, startDistance + 1);
+
+    WritePathDownDistanceField(field, startCoords, goal, points);
 }
 
 bool Map::RaycastHitsImpassable(Vec2 const& currentPos, Vec2 const& nextNextPos)
@@ -1049,6 +1407,8 @@ Entity* Map::CreateNewEntity(EntityType const type, EntityFaction const faction)
         return new Leo(this, type, faction);
     case ENTITY_TYPE_ARIES:
         return new Aries(this, type, faction);
+    case ENTITY_TYPE_CAPRICORN:
+        return new Capricorn(this, type, faction);
     case ENTITY_TYPE_BULLET:
         return new Bullet(this, type, faction);
     case ENTITY_TYPE_EXPLOSION:
@@ -1077,6 +1437,8 @@ void Map::AddEntityToMap(Entity* entity, Vec2 const& position, float const orien
     if (IsBullet(entity)) AddEntityToList(entity, m_bulletsByFaction[entity->m_faction]);
 
     if (IsAgent(entity)) AddEntityToList(entity, m_agentsByFaction[entity->m_faction]);
+
+    if (entity->m_type == ENTITY_TYPE_SCORPIO) RebuildScorpioOccupancy();
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -1095,7 +1457,11 @@ void Map::RemoveEntityFromMap(Entity* entity)
 
     if (IsBullet(entity)) RemoveEntityFromList(entity, m_bulletsByFaction[entity->m_faction]);
 
-    entity->m_map = nullptr;
+    if (entity->m_type == ENTITY_TYPE_SCORPIO) RebuildScorpioOccupancy();
+
+    m_pathArena.ReleaseCorridor(entity->m_path);
+    entity->m_path = nullptr;
+    entity->m_map  = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -1114,19 +1480,28 @@ void Map::RemoveEntityFromList(Entity const* entity, EntityList& entityList)
 //----------------------------------------------------------------------------------------------------
 void Map::DeleteGarbageEntities()
 {
-    for (Entity* entity : m_allEntities)
+    PROFILE_SCOPE("Map::DeleteGarbageEntities");
+
+    // Walk backwards so erasing the current entity never skips the next one
+    for (int entityIndex = static_cast<int>(m_allEntities.size()) - 1; entityIndex >= 0; --entityIndex)
     {
-        if (entity->m_isGarbage)
-        {
-            RemoveEntityFromMap(entity);
-        }
+        Entity* entity = m_allEntities[entityIndex];
+
+        if (!entity->m_isGarbage) continue;
+
+        if (entity == m_currentSelectedEntity) m_currentSelectedEntity = nullptr;
+
+        m_pathRequestScheduler.Cancel(*entity);
+
+        RemoveEntityFromMap(entity);
+        delete entity;
     }
 }
 
 //----------------------------------------------------------------------------------------------------
 void Map::SpawnNewNPCs()
 {
-    printf("( Map%d ) Start  | SpawnNewNPCs\n", m_mapDef->GetIndex());
+    GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Start  | SpawnNewNPCs", m_mapDef->GetIndex());
 
     for (int i = 0; i < m_dimensions.x * m_dimensions.y; ++i)
     {
@@ -1141,26 +1516,52 @@ void Map::SpawnNewNPCs()
 
         if (IsWorldPosOccupied(worldPosition)) continue;
 
-        switch (g_theRNG->RollRandomIntInRange(0, 3))
+        switch (m_random.RollRandomIntInRange(0, 3))
         {
         case 0:
-            if (g_theRNG->RollRandomFloatZeroToOne() < m_mapDef->GetScorpioSpawnPercentage()) SpawnNewEntity(ENTITY_TYPE_SCORPIO, ENTITY_FACTION_EVIL, worldPosition, 0.f);
+            if (m_random.RollRandomFloatZeroToOne() < m_mapDef->GetScorpioSpawnPercentage()) SpawnNewEntity(ENTITY_TYPE_SCORPIO, ENTITY_FACTION_EVIL, worldPosition, 0.f);
 
             break;
 
         case 1:
-            if (g_theRNG->RollRandomFloatZeroToOne() < m_mapDef->GetLeoSpawnPercentage()) SpawnNewEntity(ENTITY_TYPE_LEO, ENTITY_FACTION_EVIL, worldPosition, 0.f);
+            if (m_random.RollRandomFloatZeroToOne() < m_mapDef->GetLeoSpawnPercentage()) SpawnNewEntity(ENTITY_TYPE_LEO, ENTITY_FACTION_EVIL, worldPosition, 0.f);
 
             break;
 
         case 2:
-            if (g_theRNG->RollRandomFloatZeroToOne() < m_mapDef->GetAriesSpawnPercentage()) SpawnNewEntity(ENTITY_TYPE_ARIES, ENTITY_FACTION_EVIL, worldPosition, 0.f);
+            if (m_random.RollRandomFloatZeroToOne() < m_mapDef->GetAriesSpawnPercentage()) SpawnNewEntity(ENTITY_TYPE_ARIES, ENTITY_FACTION_EVIL, worldPosition, 0.f);
 
             break;
         }
     }
 
-    printf("( Map%d ) Finish | SpawnNewNPCs\n", m_mapDef->GetIndex());
+    GAME_LOG(LOG_CATEGORY_MAP, LOG_LEVEL_INFO, "( Map%d ) Finish | SpawnNewNPCs", m_mapDef->GetIndex());
+}
+
+//----------------------------------------------------------------------------------------------------
+// Stress spawning for sim.spawn: entities go on the centers of random dry, open, interior tiles that
+// nothing else stands on, facing random directions. Gives up after a bounded number of rolls, so it
+// returns how many actually fit.
+//
+int Map::SpawnEntitiesOnRandomTiles(EntityType const type, EntityFaction const faction, int const count)
+{
+    int numSpawned = 0;
+
+    for (int rollIndex = 0; rollIndex < count * 20 && numSpawned < count; ++rollIndex)
+    {
+        IntVec2 const tileCoords = RollRandomTileCoords();
+
+        if (IsEdgeTile(tileCoords.x, tileCoords.y) || IsTileSolid(tileCoords) || IsTileWater(tileCoords)) continue;
+
+        Vec2 const worldPosition = GetWorldPosFromTileCoords(tileCoords);
+
+        if (IsWorldPosOccupied(worldPosition)) continue;
+
+        SpawnNewEntity(type, faction, worldPosition, m_random.RollRandomFloatInRange(0.f, 360.f));
+        ++numSpawned;
+    }
+
+    return numSpawned;
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -1178,9 +1579,24 @@ bool Map::IsAgent(Entity const* entity) const
         entity->m_type != ENTITY_TYPE_PLAYER_TANK;
 }
 
+//----------------------------------------------------------------------------------------------------
+// The enemies that think: they get AI level-of-detail tiers, while bullets, effects and the player
+// always update in full.
+//
+bool Map::IsAIAgent(Entity const* entity) const
+{
+    return
+        entity->m_type == ENTITY_TYPE_SCORPIO ||
+        entity->m_type == ENTITY_TYPE_LEO ||
+        entity->m_type == ENTITY_TYPE_ARIES ||
+        entity->m_type == ENTITY_TYPE_CAPRICORN;
+}
+
 //----------------------------------------------------------------------------------------------------
 void Map::PushEntitiesOutOfWalls() const
 {
+    PROFILE_SCOPE("Map::PushEntitiesOutOfWalls");
+
     for (int entityIndex = 0; entityIndex < static_cast<int>(m_allEntities.size()); ++entityIndex)
     {
         if (IsBullet(m_allEntities[entityIndex])) continue;
@@ -1224,6 +1640,8 @@ void Map::PushEntityOutOfTileIfSolid(Entity* entity, IntVec2 const& tileCoords)
 //----------------------------------------------------------------------------------------------------
 void Map::PushEntitiesOutOfEachOther(EntityList const& entityListA, EntityList const& entityListB) const
 {
+    PROFILE_SCOPE("Map::PushEntitiesOutOfEachOther");
+
     for (Entity* entityA : entityListA)
     {
         if (!entityA) continue;
@@ -1261,6 +1679,8 @@ void Map::PushEntitiesOutOfEachOther(EntityList const& entityListA, EntityList c
 //----------------------------------------------------------------------------------------------------
 void Map::CheckEntityVsEntityCollision(EntityList const& entityListA, EntityList const& entityListB)
 {
+    PROFILE_SCOPE("Map::CheckEntityVsEntityCollision");
+
     for (Entity* entityA : entityListA)
     {
         if (!entityA) continue;
@@ -1290,7 +1710,7 @@ void Map::CheckEntityVsEntityCollision(EntityList const& entityListA, EntityList
 
                         entityA->m_orientationDegrees = Atan2Degrees(reflectedVelocity.y, reflectedVelocity.x);
                         entityA->m_health--;
-                        g_theAudio->StartSound(g_theGame->GetEnemyHitSoundID());
+                        PostSoundEvent(g_theGame->GetEnemyHitSoundID(), entityB->m_position, SOUND_PRIORITY_LOW);
                         return;
                     }
                 }
@@ -1300,11 +1720,11 @@ void Map::CheckEntityVsEntityCollision(EntityList const& entityListA, EntityList
 
                 if (entityB->m_type == ENTITY_TYPE_PLAYER_TANK)
                 {
-                    g_theAudio->StartSound(g_theGame->GetPlayerTankHitSoundID());
+                    PostSoundEvent(g_theGame->GetPlayerTankHitSoundID(), entityB->m_position, SOUND_PRIORITY_HIGH);
                 }
                 else
                 {
-                    g_theAudio->StartSound(g_theGame->GetEnemyHitSoundID());
+                    PostSoundEvent(g_theGame->GetEnemyHitSoundID(), entityB->m_position, SOUND_PRIORITY_LOW);
                 }
             }
         }
@@ -1314,6 +1734,10 @@ void Map::CheckEntityVsEntityCollision(EntityList const& entityListA, EntityList
 //----------------------------------------------------------------------------------------------------
 RaycastResult2D Map::RaycastVsTiles(Ray2 const& ray) const
 {
+    PROFILE_SCOPE("Map::RaycastVsTiles");
+
+    ++m_frameStats.m_numRaycasts;
+
     RaycastResult2D raycastResult;
     raycastResult.m_rayForwardNormal = ray.m_forwardNormal;
     raycastResult.m_rayStartPosition = ray.m_startPosition;
@@ -10,66 +10,165 @@
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Game/Entity.hpp"
 #include "Game/MapDefinition.hpp"
+#include "Game/PathArena.hpp"
+#include "Game/PathRequestScheduler.hpp"
+#include "Game/PotentiallyVisibleSet.hpp"
+#include "Game/RandomStream.hpp"
+#include "Game/SoundEventQueue.hpp"
+#include "Game/TileMasks.hpp"
 
 //----------------------------------------------------------------------------------------------------
+class PlayerTank;
+class TileDistanceField;
 class TileHeatMap;
 struct Tile;
 
+//----------------------------------------------------------------------------------------------------
+// The steps of one Map::UpdateSimulation, in the order they run.
+//
+enum MapUpdatePhase : int
+{
+    MAP_UPDATE_PHASE_UPDATE_ENTITIES,
+    MAP_UPDATE_PHASE_PUSH_ENTITIES_OUT_OF_EACH_OTHER,
+    MAP_UPDATE_PHASE_CHECK_ENTITY_VS_ENTITY_COLLISION,
+    MAP_UPDATE_PHASE_PUSH_ENTITIES_OUT_OF_WALLS,
+    MAP_UPDATE_PHASE_DELETE_GARBAGE_ENTITIES,
+    NUM_MAP_UPDATE_PHASES
+};
+
+char const* GetMapUpdatePhaseName(MapUpdatePhase phase);
+
+//----------------------------------------------------------------------------------------------------
+// Told when each phase of UpdateSimulation starts and ends, for tools that measure them one by one,
+// and around the main thread's path request work, which nests inside UPDATE_ENTITIES: each tick's
+// PathService delivery and dispatch, or every inline request when there is no worker pool.
+//
+class MapUpdatePhaseListener
+{
+public:
+    virtual ~MapUpdatePhaseListener() = default;
+
+    virtual void OnMapUpdatePhaseBegin(MapUpdatePhase phase) = 0;
+    virtual void OnMapUpdatePhaseEnd(MapUpdatePhase phase) = 0;
+    virtual void OnMapPathRequestBegin() {}
+    virtual void OnMapPathRequestEnd() {}
+};
+
+//----------------------------------------------------------------------------------------------------
+// Work counted over the most recent UpdateSimulation, for the performance HUD.
+//
+struct MapFrameStats
+{
+    int                     m_numPathRequests       = 0;
+    int                     m_numFlowFieldCacheHits = 0;    // Path requests whose field was already flooded to that goal tile
+    int                     m_numRaycasts           = 0;
+    int                     m_numAIAgentsByLodTier[NUM_AI_LOD_TIERS] = {};
+    int                     m_numFullAIUpdates      = 0;    // Enemies that ran their full Update rather than FollowCachedPath
+    PathRequestServiceStats m_pathRequestService;           // The queue serviced at the start of the tick
+    int                     m_numPlayerSightChecks  = 0;
+    int                     m_numLineOfSightChecks  = 0;
+    int                     m_numLineOfSightByPvs   = 0;    // Answered by the visible set without a raycast
+    bool                    m_didRebuildPlayerView  = false;    // The player changed tile, or the tiles changed
+};
+
+//----------------------------------------------------------------------------------------------------
+// Where the AI level-of-detail tiers begin, read from GameConfig when a Map is built. Enemies inside
+// the camera's view are always near when m_isNearWhenVisible is set.
+//
+struct AILodSettings
+{
+    float m_nearDistance      = 12.f;     // Past every enemy's detectRange, so sighting the player is never delayed
+    float m_midDistance       = 24.f;
+    int   m_midUpdateInterval = 4;        // Ticks between a mid enemy's full updates
+    int   m_farUpdateInterval = 16;       // Ticks between a far enemy's chances to re-plan an empty path
+    bool  m_isNearWhenVisible = true;
+};
+
 //-----------------------------------------------------------------------------------------------
 class Map
 {
+    friend class MapBenchmark;
+    friend class ScenarioRunner;
+    friend class VisibilityCheck;
+
 public:
     explicit Map(MapDefinition const& mapDef);
     ~Map();
 
-    void Update(float deltaSeconds);
+    void Update(float deltaSeconds, MapUpdatePhaseListener* phaseListener = nullptr);
+    void UpdateSimulation(float deltaSeconds, MapUpdatePhaseListener* phaseListener = nullptr);
     void Render() const;
     void DebugRender() const;
     void RenderTileHeatMapText() const;
 
     // Accessors (const methods)
-    Vec2 const    GetWorldPosFromTileCoords(IntVec2 const& tileCoords) const;
-    IntVec2 const GetTileCoordsFromWorldPos(Vec2 const& worldPos) const;
-    IntVec2 const GetMapDimension() const { return m_dimensions; }
-    IntVec2 const GetMapExitPosition() const { return m_exitPosition; }
-    AABB2 const   GetMapBound() const { return AABB2(IntVec2::ZERO, m_dimensions); }
-    int           GetMapIndex() const { return m_mapDef->GetIndex(); }
-    int           GetTileNums() const { return m_dimensions.x * m_dimensions.y; }
+    Vec2 const        GetWorldPosFromTileCoords(IntVec2 const& tileCoords) const;
+    IntVec2 const     GetTileCoordsFromWorldPos(Vec2 const& worldPos) const;
+    IntVec2 const     GetMapDimension() const { return m_dimensions; }
+    IntVec2 const     GetMapExitPosition() const { return m_exitPosition; }
+    AABB2 const       GetMapBound() const { return AABB2(IntVec2::ZERO, m_dimensions); }
+    int               GetMapIndex() const { return m_mapDef->GetIndex(); }
+    int               GetTileNums() const { return m_dimensions.x * m_dimensions.y; }
+    int               GetNumEntitiesOfType(EntityType const type) const { return static_cast<int>(m_entitiesByType[type].size()); }
+    MapFrameStats     GetFrameStats() const { return m_frameStats; }
+    PlayerTank const* GetPlayerTank() const;
+    RandomStream&     GetRandom() const { return m_random; }
+    bool              IsBackground() const { return m_isBackground; }
+    uint32_t          GetTraversabilityVersion() const { return m_traversabilityVersion; }
 
     // Mutators (non-const methods)
     Entity* SpawnNewEntity(EntityType type, EntityFaction faction, Vec2 const& position, float orientationDegrees);
+    int     SpawnEntitiesOnRandomTiles(EntityType type, EntityFaction faction, int count);
     void    AddEntityToMap(Entity* entity, Vec2 const& position, float orientationDegrees);
     void    RemoveEntityFromMap(Entity* entity);
+    PathCorridor* AcquirePathCorridor() { return m_pathArena.AcquireCorridor(); }
+    Vec2*   ResizePathCorridor(PathCorridor& corridor, int const numPoints) { return m_pathArena.ResizeCorridor(corridor, numPoints); }
+    void    SetIsBackground(bool const isBackground) { m_isBackground = isBackground; }
+    void    SetAILodViewBounds(AABB2 const& viewBounds);
+    void    PostSoundEvent(SoundID soundID, Vec2 const& position, SoundPriority priority) const;
+    void    RequestPath(Entity& agent, Vec2 const& goal, bool isChasing) { m_pathRequestScheduler.Enqueue(agent, goal, isChasing); }
 
     // Helpers
     RaycastResult2D RaycastVsTiles(Ray2 const& ray) const;
     bool            HasLineOfSight(Vec2 const& startPos, Vec2 const& endPos, float sightRange) const;
+    bool            HasLineOfSightToPlayer(Vec2 const& position, float sightRange) const;
     bool            IsTileSolid(IntVec2 const& tileCoords) const;
     bool            IsTileWater(IntVec2 const& tileCoords) const;
+    bool            IsTileOccupiedByScorpio(IntVec2 const& tileCoords) const { return m_scorpioOccupancy.IsSet(tileCoords); }
     bool            IsPointInSolid(Vec2 const& point) const;
     bool            IsTileCoordsOutOfBounds(IntVec2 const& tileCoords) const;
     IntVec2         RollRandomTileCoords() const;
-    IntVec2         RollRandomTraversableTileCoords(TileHeatMap const& heatMap, IntVec2 const& startCoords) const;
-
-    // Heatmap-related
-    void              GenerateHeatMaps(TileHeatMap const& heatMap) const;
-    void              PopulateDistanceField(TileHeatMap const& heatMap, IntVec2 const& startCoords, float specialValue) const;
-    void              PopulateDistanceFieldForEntity(TileHeatMap const& heatMap, IntVec2 const& startCoords, float specialValue) const;
-    void              PopulateDistanceFieldForLandBased(TileHeatMap const& heatMap) const;
-    void              PopulateDistanceFieldForAmphibian(TileHeatMap const& heatMap) const;
-    void              PopulateDistanceFieldToPosition(TileHeatMap const& heatMap, IntVec2 const& playerCoords) const;
-    std::vector<Vec2> GenerateEntityPathToGoal(TileHeatMap const& heatMap,Vec2 const& start, Vec2 const& goal) const;
+    IntVec2         RollRandomTraversableTileCoords(IntVec2 const& startCoords);
+
+    // Distance-field-related
+    void              GenerateHeatMaps(TileDistanceField& field) const;
+    void              PopulateDistanceField(TileDistanceField& field, IntVec2 const& startCoords) const;
+    void              PopulateDistanceFieldForEntity(TileDistanceField& field, IntVec2 const& startCoords) const;
+    void              PopulateDistanceFieldForLandBased(TileDistanceField& field) const;
+    void              PopulateDistanceFieldForAmphibian(TileDistanceField& field) const;
+    void              BuildTraversabilityMask(TileBitmap& outMask, uint8_t blockFlags, uint8_t allowFlags, bool isBlockedByScorpio) const;
+    void              PopulateDistanceFieldToPosition(TileDistanceField& field, IntVec2 const& playerCoords) const;
+    void              GenerateEntityPathToGoal(TileDistanceField& field, Vec2 const& start, Vec2 const& goal, PathCorridor& outPath);
+    uint64_t          GetPathSourceKey(Vec2 const& goal) const;
     bool              RaycastHitsImpassable(Vec2 const& currentPos, Vec2 const& nextNextPos);
 
 private:
     void UpdateEntities(float deltaSeconds) const;
+    void UpdatePlayerView();
+    void UpdateReachableRegions();
+    void BuildPotentiallyVisibleSet();
+    bool IsNearVisibilityEdge(IntVec2 const& fromCoords, IntVec2 const& toCoords, bool isVisible) const;
+    AILodTier GetAILodTier(Entity const& agent, PlayerTank const* playerTank) const;
+    bool      ShouldRunFullAIUpdate(Entity const& agent, int entityIndex) const;
     void RenderTiles() const;
     void RenderEntities() const;
     void RenderTileHeatMap() const;
     void DebugRenderEntities() const;
     void DebugRenderTileIndex() const;
 
-    void InitializeTileHeatMaps();
+    void                     InitializeTileHeatMaps();
+    void                     PopulateMapDistanceFields();
+    TileDistanceField const* GetDebugDistanceField() const;
 
 // Map-related
     void GenerateAllTiles();
@@ -79,12 +178,14 @@ private:
     void GenerateStartPosTile();
     void GenerateExitPosTile();
     void SetTileAtCoords(String const& tileName, int tileX, int tileY);
-    void ConvertUnreachableTilesToSolid(TileHeatMap const& heatMap, String const& tileName);
+    void ConvertUnreachableTilesToSolid(TileBitmap const& reachableTiles, String const& tileName);
     bool IsEdgeTile(int x, int y) const;
     bool IsTileCoordsInLShape(int x, int y) const;
     bool IsWorldPosOccupied(Vec2 const& position) const;
     bool IsWorldPosOccupiedByEntity(Vec2 const& position, EntityType type) const;
-    bool IsValidMap(IntVec2 const& startCoords, IntVec2 const& exitCoords, int maxAttempts);
+    void RebuildScorpioOccupancy();
+    bool IsValidMap(IntVec2 const& startCoords, IntVec2 const& exitCoords, TileBitmap& outReachableTiles) const;
+    void FloodFillDistanceField(TileDistanceField& field, IntVec2 const& startCoords, bool isBlockedByWater, bool isBlockedByScorpio) const;
 
     AABB2 const GetTileBounds(IntVec2 const& tileCoords) const;
     AABB2 const GetTileBounds(int tileIndex) const;
@@ -98,6 +199,7 @@ private:
     void    SpawnNewNPCs();
     bool    IsBullet(Entity const* entity) const;
     bool    IsAgent(Entity const* entity) const;
+    bool    IsAIAgent(Entity const* entity) const;
 
     // Entity-physic-related
     void PushEntitiesOutOfWalls() const;
@@ -115,9 +217,35 @@ private:
     IntVec2              m_exitPosition  = IntVec2::ZERO;
     IntVec2              m_dimensions;
     MapDefinition const* m_mapDef = nullptr;
+    PathArena            m_pathArena;
+    PathRequestScheduler m_pathRequestScheduler;
+    TileFlagGrid         m_tileFlags;
+    TileBitmap           m_scorpioOccupancy;    // Scorpios are turrets; rebuilt whenever one is added or removed
 
     // MetaData management
-    std::vector<TileHeatMap*> m_tileHeatMaps;
-    Entity*                   m_currentSelectedEntity   = nullptr;
-    int                       m_currentTileHeatMapIndex = -1;
+    std::vector<TileDistanceField*> m_distanceFields;
+    TileHeatMap*                    m_debugHeatMap            = nullptr;  // F6 visualization only, filled from m_distanceFields
+    Entity*                         m_currentSelectedEntity   = nullptr;
+    int                             m_currentTileHeatMapIndex = -1;
+    MapUpdatePhaseListener*         m_phaseListener           = nullptr;  // Set only for the length of an UpdateSimulation
+    mutable MapFrameStats           m_frameStats;                         // Reset at the start of every UpdateSimulation
+    uint32_t                        m_traversabilityVersion   = 0;        // Bumped when tiles or scorpio occupancy change
+    mutable RandomStream            m_random;                             // Every roll the map and its entities make
+    bool                            m_isBackground            = false;    // Ticked by the MapScheduler off the main thread
+    AILodSettings                   m_aiLodSettings;
+    AABB2                           m_aiLodViewBounds;
+    bool                            m_hasAILodViewBounds      = false;    // Only the map the camera is on has one
+    uint32_t                        m_numSimulationTicks      = 0;        // Staggers the mid and far tiers' updates
+    TileBitmap                      m_transparentTiles;                   // Solid tiles other than water block sight
+    TileBitmap                      m_playerViewTiles;                    // Seen from the player's tile, out to m_playerViewRadius
+    IntVec2                         m_playerViewOrigin        = IntVec2::ZERO;
+    uint32_t                        m_playerViewVersion       = 0;        // m_traversabilityVersion the view was cast against
+    int                             m_playerViewRadius        = 0;        // Covers every entity definition's detectRange
+    bool                            m_hasPlayerView           = false;
+    PotentiallyVisibleSet           m_potentiallyVisibleSet;              // Built once the tiles are final; reset if one changes
+    std::vector<int>                m_reachableRegionByTile;              // -1 where a land-based agent cannot stand
+    std::vector<int>                m_reachableRegionStarts;              // Region r's tiles are [starts[r], starts[r + 1]) below
+    std::vector<int>                m_reachableTilesByRegion;             // Tile indices grouped by region, row order within each
+    uint32_t                        m_reachableRegionsVersion = 0;        // m_traversabilityVersion the regions were labeled at
+    bool                            m_hasReachableRegions     = false;
 };
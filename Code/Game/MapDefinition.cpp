@@ -6,6 +6,7 @@
 #include "Game/MapDefinition.hpp"
 
 #include "Engine/Core/EngineCommon.hpp"
+#include "Game/DefinitionCache.hpp"
 
 //----------------------------------------------------------------------------------------------------
 std::vector<MapDefinition*> MapDefinition::s_mapDefinitions;
@@ -31,21 +32,79 @@ MapDefinition::MapDefinition(XmlElement const& mapDefElement)
 }
 
 //----------------------------------------------------------------------------------------------------
-MapDefinition::~MapDefinition()
+MapDefinition::MapDefinition(DefinitionCacheReader& cacheReader)
 {
-    for (MapDefinition const* mapDef : s_mapDefinitions)
-    {
-        delete mapDef;
-    }
+    m_name                   = cacheReader.ReadString();
+    m_index                  = cacheReader.ReadInt();
+    m_worm01TileName         = cacheReader.ReadString();
+    m_worm02TileName         = cacheReader.ReadString();
+    m_worm03TileName         = cacheReader.ReadString();
+    m_worm01Num              = cacheReader.ReadInt();
+    m_worm02Num              = cacheReader.ReadInt();
+    m_worm03Num              = cacheReader.ReadInt();
+    m_worm01Length           = cacheReader.ReadInt();
+    m_worm02Length           = cacheReader.ReadInt();
+    m_worm03Length           = cacheReader.ReadInt();
+    m_scorpioSpawnPercentage = cacheReader.ReadFloat();
+    m_leoSpawnPercentage     = cacheReader.ReadFloat();
+    m_ariesSpawnPercentage   = cacheReader.ReadFloat();
+    m_dimensions             = cacheReader.ReadIntVec2();
+}
 
-    s_mapDefinitions.clear();
+//----------------------------------------------------------------------------------------------------
+void MapDefinition::WriteToCache(DefinitionCacheWriter& cacheWriter) const
+{
+    cacheWriter.WriteString(m_name);
+    cacheWriter.WriteInt(m_index);
+    cacheWriter.WriteString(m_worm01TileName);
+    cacheWriter.WriteString(m_worm02TileName);
+    cacheWriter.WriteString(m_worm03TileName);
+    cacheWriter.WriteInt(m_worm01Num);
+    cacheWriter.WriteInt(m_worm02Num);
+    cacheWriter.WriteInt(m_worm03Num);
+    cacheWriter.WriteInt(m_worm01Length);
+    cacheWriter.WriteInt(m_worm02Length);
+    cacheWriter.WriteInt(m_worm03Length);
+    cacheWriter.WriteFloat(m_scorpioSpawnPercentage);
+    cacheWriter.WriteFloat(m_leoSpawnPercentage);
+    cacheWriter.WriteFloat(m_ariesSpawnPercentage);
+    cacheWriter.WriteIntVec2(m_dimensions);
 }
 
 //----------------------------------------------------------------------------------------------------
+// Same cache-or-XML scheme as TileDefinition::InitializeTileDefs.
+//
 STATIC void MapDefinition::InitializeMapDefs()
 {
-    XmlDocument mapDefXml;
-    if (mapDefXml.LoadFile("Data/Definitions/MapDefinitions.xml") != XmlResult::XML_SUCCESS)
+    String const          sourcePath = "Data/Definitions/MapDefinitions.xml";
+    DefinitionCacheReader cacheReader;
+
+    if (cacheReader.Open(sourcePath))
+    {
+        std::vector<MapDefinition*> cachedMapDefs;
+        int const                   numMapDefs = cacheReader.ReadInt();
+
+        for (int mapDefIndex = 0; mapDefIndex < numMapDefs && !cacheReader.HasFailed(); ++mapDefIndex)
+        {
+            cachedMapDefs.push_back(new MapDefinition(cacheReader));
+        }
+
+        if (!cacheReader.HasFailed())
+        {
+            s_mapDefinitions.insert(s_mapDefinitions.end(), cachedMapDefs.begin(), cachedMapDefs.end());
+            return;
+        }
+
+        for (MapDefinition const* mapDef : cachedMapDefs)
+        {
+            delete mapDef;
+        }
+    }
+
+    XmlDocument  mapDefXml;
+    size_t const firstNewMapDef = s_mapDefinitions.size();
+
+    if (mapDefXml.LoadFile(sourcePath.c_str()) != XmlResult::XML_SUCCESS)
     {
         return;
     }
@@ -58,6 +117,16 @@ STATIC void MapDefinition::InitializeMapDefs()
             s_mapDefinitions.push_back(mapDef);
         }
     }
+
+    DefinitionCacheWriter cacheWriter(cacheReader.GetSourceHash());
+    cacheWriter.WriteInt(static_cast<int>(s_mapDefinitions.size() - firstNewMapDef));
+
+    for (size_t mapDefIndex = firstNewMapDef; mapDefIndex < s_mapDefinitions.size(); ++mapDefIndex)
+    {
+        s_mapDefinitions[mapDefIndex]->WriteToCache(cacheWriter);
+    }
+
+    cacheWriter.Save(sourcePath);
 }
 
 //----------------------------------------------------------------------------------------------------
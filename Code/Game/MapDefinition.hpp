@@ -8,11 +8,18 @@
 #include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 
+//----------------------------------------------------------------------------------------------------
+class DefinitionCacheReader;
+class DefinitionCacheWriter;
+
 //----------------------------------------------------------------------------------------------------
 struct MapDefinition
 {
     explicit MapDefinition(XmlElement const& mapDefElement);
-    ~MapDefinition();
+    explicit MapDefinition(DefinitionCacheReader& cacheReader);
+    ~MapDefinition() = default;
+
+    void WriteToCache(DefinitionCacheWriter& cacheWriter) const;
 
     static void                        InitializeMapDefs();
     static MapDefinition const*        GetTileDefByName(String const& name);
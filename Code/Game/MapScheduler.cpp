@@ -0,0 +1,152 @@
+//----------------------------------------------------------------------------------------------------
+// MapScheduler.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/MapScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/Profiler.hpp"
+
+//----------------------------------------------------------------------------------------------------
+MapScheduler::MapScheduler()
+{
+    m_tickRate         = std::max(g_gameConfigBlackboard.GetValue("backgroundMapTickRate", m_tickRate), 1.f);
+    m_maxTicksPerFrame = std::max(g_gameConfigBlackboard.GetValue("backgroundMapMaxTicksPerFrame", m_maxTicksPerFrame), 1);
+}
+
+//----------------------------------------------------------------------------------------------------
+MapScheduler::~MapScheduler()
+{
+    FinishBackgroundTicks();
+}
+
+//----------------------------------------------------------------------------------------------------
+// Call on the main thread before updating currentMap, and FinishBackgroundTicks after it. Until then
+// the background maps belong to the workers: nothing else may touch them or move entities between maps.
+//
+void MapScheduler::BeginBackgroundTicks(std::vector<Map*> const& maps, Map const* currentMap, float const deltaSeconds)
+{
+    FinishBackgroundTicks();
+
+    float const fixedDeltaSeconds = 1.f / m_tickRate;
+
+    m_activeIndices.clear();
+
+    for (ScheduledMap& scheduledMap : m_scheduledMaps)
+    {
+        scheduledMap.m_numTicksThisFrame     = 0;
+        scheduledMap.m_lastFrameMilliseconds = 0.f;
+    }
+
+    for (Map* map : maps)
+    {
+        bool const isBackground = map != currentMap;
+
+        map->SetIsBackground(isBackground);
+
+        if (!isBackground) continue;
+
+        ScheduledMap* scheduledMap = FindOrAddScheduledMap(map);
+
+        scheduledMap->m_accumulatedSeconds += deltaSeconds;
+
+        int const numTicksDue = static_cast<int>(scheduledMap->m_accumulatedSeconds / fixedDeltaSeconds);
+
+        scheduledMap->m_numTicksThisFrame = std::min(numTicksDue, m_maxTicksPerFrame);
+        scheduledMap->m_accumulatedSeconds -= static_cast<float>(numTicksDue) * fixedDeltaSeconds;
+        scheduledMap->m_numDroppedTicks += numTicksDue - scheduledMap->m_numTicksThisFrame;
+
+        if (scheduledMap->m_numTicksThisFrame > 0) m_activeIndices.push_back(static_cast<int>(scheduledMap - m_scheduledMaps.data()));
+    }
+
+    if (m_activeIndices.empty()) return;
+
+    if (!g_theWorkerPool)
+    {
+        for (int const scheduledIndex : m_activeIndices)
+        {
+            TickScheduledMap(m_scheduledMaps[scheduledIndex]);
+        }
+
+        return;
+    }
+
+    m_task = g_theWorkerPool->Submit([this](int const index)
+    {
+        TickScheduledMap(m_scheduledMaps[m_activeIndices[index]]);
+    }, static_cast<int>(m_activeIndices.size()));
+}
+
+//----------------------------------------------------------------------------------------------------
+void MapScheduler::FinishBackgroundTicks()
+{
+    if (!m_task) return;
+
+    PROFILE_SCOPE("MapScheduler::FinishBackgroundTicks");
+
+    g_theWorkerPool->Wait(m_task);
+    m_task.reset();
+}
+
+//----------------------------------------------------------------------------------------------------
+StringList MapScheduler::GetStatLines() const
+{
+    StringList lines;
+
+    for (ScheduledMap const& scheduledMap : m_scheduledMaps)
+    {
+        if (!scheduledMap.m_map->IsBackground()) continue;
+
+        lines.push_back(Stringf("Map%d background: %d ticks %.3f ms this frame, %lld total, %d over budget (%.0f Hz, %d/frame)",
+                                scheduledMap.m_map->GetMapIndex(),
+                                scheduledMap.m_numTicksThisFrame,
+                                scheduledMap.m_lastFrameMilliseconds,
+                                static_cast<long long>(scheduledMap.m_numTotalTicks),
+                                scheduledMap.m_numDroppedTicks,
+                                m_tickRate,
+                                m_maxTicksPerFrame));
+    }
+
+    return lines;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The vector only grows from BeginBackgroundTicks, after the previous frame's task has finished, so
+// pointers into it stay valid while workers run.
+//
+MapScheduler::ScheduledMap* MapScheduler::FindOrAddScheduledMap(Map* map)
+{
+    for (ScheduledMap& scheduledMap : m_scheduledMaps)
+    {
+        if (scheduledMap.m_map == map) return &scheduledMap;
+    }
+
+    ScheduledMap scheduledMap;
+    scheduledMap.m_map = map;
+    m_scheduledMaps.push_back(scheduledMap);
+
+    return &m_scheduledMaps.back();
+}
+
+//----------------------------------------------------------------------------------------------------
+void MapScheduler::TickScheduledMap(ScheduledMap& scheduledMap) const
+{
+    PROFILE_SCOPE("MapScheduler::TickScheduledMap");
+
+    float const                                 fixedDeltaSeconds = 1.f / m_tickRate;
+    std::chrono::steady_clock::time_point const start             = std::chrono::steady_clock::now();
+
+    for (int tickIndex = 0; tickIndex < scheduledMap.m_numTicksThisFrame; ++tickIndex)
+    {
+        scheduledMap.m_map->UpdateSimulation(fixedDeltaSeconds);
+    }
+
+    scheduledMap.m_numTotalTicks += scheduledMap.m_numTicksThisFrame;
+    scheduledMap.m_lastFrameMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
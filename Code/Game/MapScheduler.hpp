@@ -0,0 +1,54 @@
+//----------------------------------------------------------------------------------------------------
+// MapScheduler.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/WorkerPool.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class Map;
+
+//----------------------------------------------------------------------------------------------------
+// Keeps every map other than the current one alive. Each background map accumulates frame time and is
+// stepped with a fixed delta at m_tickRate, one worker task index per map, while the main thread
+// updates the current map. A map runs at most m_maxTicksPerFrame steps a frame; time past that budget
+// is dropped rather than carried, so a slow frame never snowballs. Every step uses the same fixed delta
+// and each map rolls only its own RandomStream, so a map's state after N steps does not depend on
+// which thread ran them or how frames were sliced.
+//
+class MapScheduler
+{
+public:
+    MapScheduler();
+    ~MapScheduler();
+
+    void BeginBackgroundTicks(std::vector<Map*> const& maps, Map const* currentMap, float deltaSeconds);
+    void FinishBackgroundTicks();
+
+    StringList GetStatLines() const;
+
+private:
+    struct ScheduledMap
+    {
+        Map*    m_map                   = nullptr;
+        float   m_accumulatedSeconds    = 0.f;
+        int     m_numTicksThisFrame     = 0;
+        int     m_numDroppedTicks       = 0;     // Over the per-frame budget, since the Game started
+        int64_t m_numTotalTicks         = 0;
+        float   m_lastFrameMilliseconds = 0.f;
+    };
+
+    ScheduledMap* FindOrAddScheduledMap(Map* map);
+    void          TickScheduledMap(ScheduledMap& scheduledMap) const;
+
+    std::vector<ScheduledMap> m_scheduledMaps;
+    std::vector<int>          m_activeIndices;      // This frame's background maps that have ticks to run
+    WorkerTaskHandle          m_task;
+    float                     m_tickRate         = 10.f;
+    int                       m_maxTicksPerFrame = 2;
+};
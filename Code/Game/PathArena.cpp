@@ -0,0 +1,127 @@
+//----------------------------------------------------------------------------------------------------
+// PathArena.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/PathArena.hpp"
+
+#include <algorithm>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+//----------------------------------------------------------------------------------------------------
+PathArena::~PathArena()
+{
+    for (PathCorridor const* corridor : m_allCorridors)
+    {
+        delete corridor;
+    }
+
+    for (Vec2 const* block : m_allBlocks)
+    {
+        delete[] block;
+    }
+
+    m_allCorridors.clear();
+    m_freeCorridors.clear();
+    m_allBlocks.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+PathCorridor* PathArena::AcquireCorridor()
+{
+    if (!m_freeCorridors.empty())
+    {
+        PathCorridor* corridor = m_freeCorridors.back();
+        m_freeCorridors.pop_back();
+
+        return corridor;
+    }
+
+    PathCorridor* corridor = new PathCorridor();
+    m_allCorridors.push_back(corridor);
+
+    return corridor;
+}
+
+//----------------------------------------------------------------------------------------------------
+void PathArena::ReleaseCorridor(PathCorridor* corridor)
+{
+    if (!corridor) return;
+
+    // Releasing twice would hand the same corridor to two agents
+    ASSERT_OR_DIE(std::find(m_freeCorridors.begin(), m_freeCorridors.end(), corridor) == m_freeCorridors.end(), "PathArena: corridor released twice")
+
+    if (corridor->m_overflowPoints)
+    {
+        ReleaseBlock(corridor->m_overflowPoints, corridor->m_overflowSizeClass);
+        corridor->m_overflowPoints    = nullptr;
+        corridor->m_overflowSizeClass = -1;
+    }
+
+    corridor->Clear();
+    m_freeCorridors.push_back(corridor);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Returns writable storage for exactly numPoints points; previous contents are discarded.
+//
+Vec2* PathArena::ResizeCorridor(PathCorridor& corridor, int const numPoints)
+{
+    int const requiredSizeClass = numPoints > PathCorridor::INLINE_CAPACITY ? GetSizeClassForCapacity(numPoints) : -1;
+
+    if (requiredSizeClass != corridor.m_overflowSizeClass)
+    {
+        if (corridor.m_overflowPoints)
+        {
+            ReleaseBlock(corridor.m_overflowPoints, corridor.m_overflowSizeClass);
+        }
+
+        corridor.m_overflowPoints    = requiredSizeClass >= 0 ? AcquireBlock(requiredSizeClass) : nullptr;
+        corridor.m_overflowSizeClass = requiredSizeClass;
+    }
+
+    corridor.m_numPoints = numPoints;
+
+    return corridor.GetPoints();
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int PathArena::GetSizeClassForCapacity(int const capacity)
+{
+    for (int sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass)
+    {
+        if (GetCapacityForSizeClass(sizeClass) >= capacity)
+        {
+            return sizeClass;
+        }
+    }
+
+    ERROR_AND_DIE("PathArena: path is longer than the largest block size")
+}
+
+//----------------------------------------------------------------------------------------------------
+Vec2* PathArena::AcquireBlock(int const sizeClass)
+{
+    std::vector<Vec2*>& freeBlocks = m_freeBlocks[sizeClass];
+
+    if (!freeBlocks.empty())
+    {
+        Vec2* block = freeBlocks.back();
+        freeBlocks.pop_back();
+
+        return block;
+    }
+
+    Vec2* block = new Vec2[GetCapacityForSizeClass(sizeClass)];
+    m_allBlocks.push_back(block);
+
+    return block;
+}
+
+//----------------------------------------------------------------------------------------------------
+void PathArena::ReleaseBlock(Vec2* block, int const sizeClass)
+{
+    m_freeBlocks[sizeClass].push_back(block);
+}
@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------------------------------
+// PathArena.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <vector>
+
+#include "Engine/Math/Vec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// A path owned by one agent. Points are stored goal-first, so the next point to walk toward is
+// always Back(). Short paths live in the inline buffer; longer ones borrow a block from the arena.
+//
+struct PathCorridor
+{
+    static constexpr int INLINE_CAPACITY = 16;
+
+    bool        IsEmpty() const { return m_numPoints == 0; }
+    int         GetNumPoints() const { return m_numPoints; }
+    Vec2 const& GetPoint(int const index) const { return GetPoints()[index]; }
+    Vec2 const& Back() const { return GetPoints()[m_numPoints - 1]; }
+    void        PopBack() { if (m_numPoints > 0) --m_numPoints; }
+    void        Clear() { m_numPoints = 0; }
+    Vec2 const* GetPoints() const { return m_overflowPoints ? m_overflowPoints : m_inlinePoints; }
+    Vec2*       GetPoints() { return m_overflowPoints ? m_overflowPoints : m_inlinePoints; }
+
+    Vec2  m_inlinePoints[INLINE_CAPACITY];
+    Vec2* m_overflowPoints    = nullptr;
+    int   m_overflowSizeClass = -1;
+    int   m_numPoints         = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Map-owned storage for agent paths. Corridors and overflow blocks are recycled through free lists,
+// so steady-state re-pathing does not touch the heap.
+//
+class PathArena
+{
+public:
+    PathArena() = default;
+    ~PathArena();
+
+    PathArena(PathArena const&)            = delete;
+    PathArena& operator=(PathArena const&) = delete;
+
+    PathCorridor* AcquireCorridor();
+    void          ReleaseCorridor(PathCorridor* corridor);
+    Vec2*         ResizeCorridor(PathCorridor& corridor, int numPoints);
+
+private:
+    static constexpr int MIN_BLOCK_CAPACITY = 32;
+    static constexpr int NUM_SIZE_CLASSES   = 24;
+
+    static int GetSizeClassForCapacity(int capacity);
+    static int GetCapacityForSizeClass(int sizeClass) { return MIN_BLOCK_CAPACITY << sizeClass; }
+
+    Vec2* AcquireBlock(int sizeClass);
+    void  ReleaseBlock(Vec2* block, int sizeClass);
+
+    std::vector<PathCorridor*> m_allCorridors;
+    std::vector<PathCorridor*> m_freeCorridors;
+    std::vector<Vec2*>         m_allBlocks;
+    std::vector<Vec2*>         m_freeBlocks[NUM_SIZE_CLASSES];
+};
@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------------------------------
+// PathRequestScheduler.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/PathRequestScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Entity.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/TileDistanceField.hpp"
+
+//----------------------------------------------------------------------------------------------------
+PathRequestScheduler::PathRequestScheduler()
+{
+    m_budgetMicroseconds = std::max(g_gameConfigBlackboard.GetValue("pathRequestBudgetMicroseconds", m_budgetMicroseconds), 0.f);
+    m_maxRequestsPerTick = std::max(g_gameConfigBlackboard.GetValue("pathRequestsPerTick", m_maxRequestsPerTick), 1);
+}
+
+//----------------------------------------------------------------------------------------------------
+// A queued agent keeps its place in line and takes the more urgent of its two priorities.
+//
+void PathRequestScheduler::Enqueue(Entity& agent, Vec2 const& goal, bool const isChasing)
+{
+    int const priority = (isChasing ? 0 : NUM_AI_LOD_TIERS) + agent.m_aiLodTier;
+
+    if (agent.m_isPathPending)
+    {
+        for (PathRequest& request : m_pendingRequests)
+        {
+            if (request.m_agent != &agent) continue;
+
+            request.m_goal     = goal;
+            request.m_priority = std::min(request.m_priority, priority);
+            return;
+        }
+    }
+
+    PathRequest request;
+
+    request.m_agent       = &agent;
+    request.m_goal        = goal;
+    request.m_priority    = priority;
+    request.m_enqueueTick = m_serviceTick;
+    request.m_sequence    = m_nextSequence++;
+
+    m_pendingRequests.push_back(request);
+    agent.m_isPathPending = true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// For an agent about to be deleted, whether its request is queued or with the PathService.
+//
+void PathRequestScheduler::Cancel(Entity const& agent)
+{
+    if (!agent.m_isPathPending) return;
+
+    m_pendingRequests.erase(std::remove_if(m_pendingRequests.begin(), m_pendingRequests.end(), [&agent](PathRequest const& request)
+    {
+        return request.m_agent == &agent;
+    }), m_pendingRequests.end());
+
+    m_pathService.Cancel(agent);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Background maps pass isTimeBudgeted false. Inline servicing then stops on count alone, and the
+// PathService always answers a batch exactly one tick later, so a map's replay never depends on
+// machine speed.
+//
+PathRequestServiceStats PathRequestScheduler::ServiceRequests(Map& map, bool const isTimeBudgeted)
+{
+    PROFILE_SCOPE("PathRequestScheduler::ServiceRequests");
+
+    PathRequestServiceStats                     stats;
+    std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+
+    ++m_serviceTick;
+
+    if (g_theWorkerPool) DeliverServiceResults(map, stats);
+
+    std::sort(m_pendingRequests.begin(), m_pendingRequests.end(), [this](PathRequest const& a, PathRequest const& b)
+    {
+        int const priorityA = GetEffectivePriority(a);
+        int const priorityB = GetEffectivePriority(b);
+
+        return priorityA != priorityB ? priorityA < priorityB : a.m_sequence < b.m_sequence;
+    });
+
+    int const numTaken = g_theWorkerPool ? DispatchRequests(map, stats) : ServeRequestsInline(map, isTimeBudgeted, stats);
+
+    m_pendingRequests.erase(m_pendingRequests.begin(), m_pendingRequests.begin() + numTaken);
+
+    stats.m_numWaiting   = static_cast<int>(m_pendingRequests.size());
+    stats.m_microseconds = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------------------
+// An agent that asked again while its request was in flight stays pending for the newer one, but
+// still gets this path to follow in the meantime.
+//
+void PathRequestScheduler::DeliverServiceResults(Map& map, PathRequestServiceStats& stats)
+{
+    for (PathServiceResult const& result : m_pathService.WaitForResults())
+    {
+        if (!result.m_agent) continue;
+
+        Entity&   agent     = *result.m_agent;
+        int const numPoints = static_cast<int>(result.m_points.size());
+        Vec2*     points    = map.ResizePathCorridor(*agent.m_path, numPoints);
+
+        std::copy(result.m_points.begin(), result.m_points.end(), points);
+
+        agent.m_isPathPending = IsQueued(agent);
+        ++stats.m_numServed;
+
+        if (result.m_didReuseField) ++stats.m_numFieldReuses;
+    }
+
+    stats.m_numFloods = m_pathService.GetNumFloods();
+}
+
+//----------------------------------------------------------------------------------------------------
+// Sends the most urgent requests to the workers; their answers are delivered next tick.
+//
+int PathRequestScheduler::DispatchRequests(Map const& map, PathRequestServiceStats& stats)
+{
+    int const numTaken = std::min(static_cast<int>(m_pendingRequests.size()), m_maxRequestsPerTick);
+
+    m_dispatchAgents.clear();
+    m_dispatchGoals.clear();
+
+    for (int requestIndex = 0; requestIndex < numTaken; ++requestIndex)
+    {
+        m_dispatchAgents.push_back(m_pendingRequests[requestIndex].m_agent);
+        m_dispatchGoals.push_back(m_pendingRequests[requestIndex].m_goal);
+    }
+
+    m_pathService.Dispatch(map, m_dispatchAgents, m_dispatchGoals);
+
+    stats.m_numDispatched = numTaken;
+    stats.m_numCoalesced  = std::max(numTaken - m_pathService.GetNumGoalGroups(), 0);
+
+    return numTaken;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The fallback with no worker pool. At least one request is served every call, so the queue always
+// drains even when a single flood costs more than the whole budget.
+//
+int PathRequestScheduler::ServeRequestsInline(Map& map, bool const isTimeBudgeted, PathRequestServiceStats& stats)
+{
+    std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+
+    m_servedFields.clear();
+
+    int numServed = 0;
+
+    for (PathRequest const& request : m_pendingRequests)
+    {
+        if (numServed >= m_maxRequestsPerTick) break;
+
+        if (isTimeBudgeted && numServed > 0)
+        {
+            float const elapsedMicroseconds = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+
+            if (elapsedMicroseconds >= m_budgetMicroseconds) break;
+        }
+
+        Entity&            agent     = *request.m_agent;
+        uint64_t const     sourceKey = map.GetPathSourceKey(request.m_goal);
+        TileDistanceField* field     = agent.m_distanceField;
+
+        for (TileDistanceField* servedField : m_servedFields)
+        {
+            if (sourceKey == 0 || servedField->GetSourceKey() != sourceKey) continue;
+
+            field = servedField;
+            ++stats.m_numCoalesced;
+            break;
+        }
+
+        if (sourceKey == 0 || field->GetSourceKey() != sourceKey) ++stats.m_numFloods;
+        else ++stats.m_numFieldReuses;
+
+        map.GenerateEntityPathToGoal(*field, agent.m_position, request.m_goal, *agent.m_path);
+
+        if (field == agent.m_distanceField) m_servedFields.push_back(field);
+
+        agent.m_isPathPending = false;
+        ++numServed;
+    }
+
+    stats.m_numServed = numServed;
+
+    return numServed;
+}
+
+//----------------------------------------------------------------------------------------------------
+int PathRequestScheduler::GetEffectivePriority(PathRequest const& request) const
+{
+    return request.m_priority - static_cast<int>((m_serviceTick - request.m_enqueueTick) / AGING_TICKS);
+}
+
+//----------------------------------------------------------------------------------------------------
+bool PathRequestScheduler::IsQueued(Entity const& agent) const
+{
+    for (PathRequest const& request : m_pendingRequests)
+    {
+        if (request.m_agent == &agent) return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------------------------------
+// PathRequestScheduler.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Math/Vec2.hpp"
+#include "Game/PathService.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class Entity;
+class Map;
+class TileDistanceField;
+
+//----------------------------------------------------------------------------------------------------
+// What the most recent ServiceRequests did, for the performance HUD.
+//
+struct PathRequestServiceStats
+{
+    int   m_numServed      = 0;     // Paths handed to agents
+    int   m_numDispatched  = 0;     // Requests sent to the PathService, answered next tick
+    int   m_numCoalesced   = 0;     // Shared a goal tile's flood with another request
+    int   m_numFloods      = 0;     // Distance fields flooded for the paths served
+    int   m_numFieldReuses = 0;     // Paths served from a field already flooded to their goal tile
+    int   m_numWaiting     = 0;     // Still queued after the budget ran out
+    float m_microseconds   = 0.f;   // Main-thread time, including any wait for the PathService
+};
+
+//----------------------------------------------------------------------------------------------------
+// The Map's queue of agent path requests. Agents enqueue while they update and keep following the path
+// they already have; at the start of the next tick the Map services the queue, most urgent first, and
+// whatever does not fit waits for a later tick. Chasing comes before wandering and near tiers before
+// far ones; every AGING_TICKS spent waiting raises a request one step, so wanderers are never starved
+// by a long chase. An agent has at most one request queued: asking again only moves its goal.
+//
+// With a worker pool, each service hands the PathService's answers to last tick's batch to their
+// agents and dispatches up to m_maxRequestsPerTick more, so the main thread only copies paths. Without
+// one, requests are answered inline until m_budgetMicroseconds or m_maxRequestsPerTick is used up, and
+// a request for a goal tile another agent was just given reuses that agent's flooded field. Either
+// way a pack spotting the player in one frame pays for one flood.
+//
+class PathRequestScheduler
+{
+public:
+    PathRequestScheduler();
+
+    void Enqueue(Entity& agent, Vec2 const& goal, bool isChasing);
+    void Cancel(Entity const& agent);
+
+    PathRequestServiceStats ServiceRequests(Map& map, bool isTimeBudgeted);
+
+private:
+    static constexpr int AGING_TICKS = 8;
+
+    struct PathRequest
+    {
+        Entity*  m_agent        = nullptr;
+        Vec2     m_goal         = Vec2::ZERO;
+        int      m_priority     = 0;        // Lower is more urgent
+        uint32_t m_enqueueTick  = 0;
+        uint32_t m_sequence     = 0;        // Breaks ties in arrival order, so servicing is deterministic
+    };
+
+    int  GetEffectivePriority(PathRequest const& request) const;
+    bool IsQueued(Entity const& agent) const;
+    void DeliverServiceResults(Map& map, PathRequestServiceStats& stats);
+    int  DispatchRequests(Map const& map, PathRequestServiceStats& stats);
+    int  ServeRequestsInline(Map& map, bool isTimeBudgeted, PathRequestServiceStats& stats);
+
+    std::vector<PathRequest>        m_pendingRequests;
+    std::vector<TileDistanceField*> m_servedFields;             // Flooded during the current inline ServiceRequests
+    PathService                     m_pathService;
+    std::vector<Entity*>            m_dispatchAgents;
+    std::vector<Vec2>               m_dispatchGoals;
+    uint32_t                        m_serviceTick        = 0;
+    uint32_t                        m_nextSequence       = 0;
+    float                           m_budgetMicroseconds = 1000.f;
+    int                             m_maxRequestsPerTick = 64;
+};
@@ -0,0 +1,199 @@
+//----------------------------------------------------------------------------------------------------
+// PathService.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/PathService.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Entity.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/TileDistanceBFS.hpp"
+#include "Game/TileDistanceField.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// The workers still hold pointers into the pools, so a batch in flight has to finish first.
+//
+PathService::~PathService()
+{
+    WaitForResults();
+}
+
+//----------------------------------------------------------------------------------------------------
+// Call once per tick, after WaitForResults, even with nothing to ask for: it is also what clears the
+// previous batch's results. goals[i] is where agents[i] wants to go.
+//
+void PathService::Dispatch(Map const& map, std::vector<Entity*> const& agents, std::vector<Vec2> const& goals)
+{
+    PROFILE_SCOPE("PathService::Dispatch");
+
+    WaitForResults();
+
+    m_results.resize(agents.size());
+    m_goalGroups.clear();
+
+    if (agents.empty()) return;
+
+    if (!m_hasSnapshot || m_snapshotVersion != map.GetTraversabilityVersion())
+    {
+        map.BuildTraversabilityMask(m_passableSnapshot, TILE_FLAG_SOLID, TILE_FLAG_NONE, true);
+        m_snapshotVersion = map.GetTraversabilityVersion();
+        m_hasSnapshot     = true;
+    }
+
+    for (int requestIndex = 0; requestIndex < static_cast<int>(agents.size()); ++requestIndex)
+    {
+        PathServiceResult& result = m_results[requestIndex];
+
+        result.m_agent         = agents[requestIndex];
+        result.m_start         = agents[requestIndex]->m_position;
+        result.m_goal          = goals[requestIndex];
+        result.m_startCoords   = map.GetTileCoordsFromWorldPos(result.m_start);
+        result.m_didReuseField = false;
+        result.m_points.clear();
+
+        IntVec2 const goalCoords = map.GetTileCoordsFromWorldPos(result.m_goal);
+
+        // Off the map there is nothing to flood; head straight for it, as GenerateEntityPathToGoal does
+        if (map.IsTileCoordsOutOfBounds(goalCoords))
+        {
+            result.m_points.push_back(result.m_goal);
+            continue;
+        }
+
+        GoalGroup* group = nullptr;
+
+        for (GoalGroup& existingGroup : m_goalGroups)
+        {
+            if (existingGroup.m_goalCoords == goalCoords) group = &existingGroup;
+        }
+
+        if (!group)
+        {
+            m_goalGroups.emplace_back();
+            group               = &m_goalGroups.back();
+            group->m_goalCoords = goalCoords;
+            group->m_sourceKey  = map.GetPathSourceKey(result.m_goal);
+        }
+
+        group->m_resultIndices.push_back(requestIndex);
+    }
+
+    // Groups whose goal a pooled field already holds take that field; the rest take any free one
+    std::vector<bool> isFieldTaken(m_fields.size(), false);
+
+    for (GoalGroup& group : m_goalGroups)
+    {
+        for (int fieldIndex = 0; fieldIndex < static_cast<int>(m_fields.size()); ++fieldIndex)
+        {
+            if (isFieldTaken[fieldIndex] || m_fields[fieldIndex]->GetSourceKey() != group.m_sourceKey) continue;
+
+            group.m_field            = m_fields[fieldIndex].get();
+            isFieldTaken[fieldIndex] = true;
+            break;
+        }
+    }
+
+    int nextFreeField = 0;
+
+    for (GoalGroup& group : m_goalGroups)
+    {
+        if (group.m_field) continue;
+
+        while (nextFreeField < static_cast<int>(m_fields.size()) && isFieldTaken[nextFreeField])
+        {
+            ++nextFreeField;
+        }
+
+        if (nextFreeField == static_cast<int>(m_fields.size()))
+        {
+            m_fields.push_back(std::make_unique<TileDistanceField>(map.GetMapDimension()));
+            isFieldTaken.push_back(false);
+        }
+
+        group.m_field               = m_fields[nextFreeField].get();
+        isFieldTaken[nextFreeField] = true;
+    }
+
+    if (m_goalGroups.empty()) return;
+
+    m_task = g_theWorkerPool->Submit([this](int const groupIndex)
+    {
+        RunGoalGroup(groupIndex);
+    }, static_cast<int>(m_goalGroups.size()));
+}
+
+//----------------------------------------------------------------------------------------------------
+// Valid until the next Dispatch. A result whose agent was cancelled has m_agent set to nullptr.
+//
+std::vector<PathServiceResult> const& PathService::WaitForResults()
+{
+    if (!m_task) return m_results;
+
+    PROFILE_SCOPE("PathService::WaitForResults");
+
+    g_theWorkerPool->Wait(m_task);
+    m_task = nullptr;
+
+    m_numFloods = 0;
+
+    for (GoalGroup const& group : m_goalGroups)
+    {
+        if (group.m_didFlood) ++m_numFloods;
+    }
+
+    return m_results;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Only m_agent is cleared, which no worker reads, so this is safe while the batch runs.
+//
+void PathService::Cancel(Entity const& agent)
+{
+    for (PathServiceResult& result : m_results)
+    {
+        if (result.m_agent == &agent) result.m_agent = nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Runs on a worker. Touches only this group, its field and its requests' point buffers.
+//
+void PathService::RunGoalGroup(int const groupIndex)
+{
+    PROFILE_SCOPE("PathService::RunGoalGroup");
+
+    GoalGroup&         group = m_goalGroups[groupIndex];
+    TileDistanceField& field = *group.m_field;
+
+    if (field.GetSourceKey() != group.m_sourceKey)
+    {
+        PopulateDistanceFieldBFS(m_passableSnapshot, group.m_goalCoords, field);
+        field.SetSourceKey(group.m_sourceKey);
+        group.m_didFlood = true;
+    }
+
+    IntVec2 const dimensions = field.GetDimensions();
+
+    for (int const resultIndex : group.m_resultIndices)
+    {
+        PathServiceResult& result      = m_results[resultIndex];
+        IntVec2 const      startCoords = result.m_startCoords;
+        bool const         isInBounds  = startCoords.x >= 0 && startCoords.x < dimensions.x && startCoords.y >= 0 && startCoords.y < dimensions.y;
+        uint16_t const     distance    = isInBounds ? field.GetValueAtCoords(startCoords) : TileDistanceField::UNREACHABLE;
+
+        result.m_didReuseField = !group.m_didFlood;
+
+        // Start is cut off from the goal; head straight for it and let wall pushing sort it out
+        if (distance == TileDistanceField::UNREACHABLE)
+        {
+            result.m_points.push_back(result.m_goal);
+            continue;
+        }
+
+        result.m_points.resize(static_cast<size_t>(distance) + 1);
+        WritePathDownDistanceField(field, startCoords, result.m_goal, result.m_points.data());
+    }
+}
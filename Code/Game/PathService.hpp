@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------------------------------
+// PathService.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Game/TileMasks.hpp"
+#include "Game/WorkerPool.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class Entity;
+class Map;
+class TileDistanceField;
+
+//----------------------------------------------------------------------------------------------------
+// One answered request: the agent it was for (nullptr once cancelled) and its path, goal-first like a
+// PathCorridor.
+//
+struct PathServiceResult
+{
+    Entity*           m_agent         = nullptr;
+    Vec2              m_start         = Vec2::ZERO;
+    Vec2              m_goal          = Vec2::ZERO;
+    IntVec2           m_startCoords   = IntVec2::ZERO;
+    std::vector<Vec2> m_points;
+    bool              m_didReuseField = false;      // The goal tile's field was already flooded, so none was needed
+};
+
+//----------------------------------------------------------------------------------------------------
+// Answers a Map's path requests on g_theWorkerPool. Dispatch copies the requests, refreshes a private
+// snapshot of the map's passability when tiles or scorpios have changed, groups the requests by goal
+// tile and submits one task index per group: flood a distance field to the goal, then descend it for
+// every request in the group. The workers read only the snapshot and write only the service's own
+// fields and result buffers, so the map carries on updating meanwhile. WaitForResults, called at the
+// start of the next tick, blocks until the batch is done and hands the results back. Distance fields
+// are pooled and remember what they were flooded to, so a goal tile asked for again next tick is not
+// flooded again.
+//
+class PathService
+{
+public:
+    PathService() = default;
+    ~PathService();
+
+    PathService(PathService const&)            = delete;
+    PathService& operator=(PathService const&) = delete;
+
+    void                                  Dispatch(Map const& map, std::vector<Entity*> const& agents, std::vector<Vec2> const& goals);
+    std::vector<PathServiceResult> const& WaitForResults();
+    void                                  Cancel(Entity const& agent);
+    bool                                  IsBusy() const { return m_task != nullptr; }
+    int                                   GetNumGoalGroups() const { return static_cast<int>(m_goalGroups.size()); }
+    int                                   GetNumFloods() const { return m_numFloods; }
+
+private:
+    struct GoalGroup
+    {
+        IntVec2            m_goalCoords    = IntVec2::ZERO;
+        uint64_t           m_sourceKey     = 0;
+        TileDistanceField* m_field         = nullptr;
+        std::vector<int>   m_resultIndices;
+        bool               m_didFlood      = false;      // Written by the worker that ran the group
+    };
+
+    void RunGoalGroup(int groupIndex);
+
+    TileBitmap                                      m_passableSnapshot;
+    uint32_t                                        m_snapshotVersion = 0;
+    bool                                            m_hasSnapshot     = false;
+    std::vector<std::unique_ptr<TileDistanceField>> m_fields;            // Pooled across batches; source keys say what each holds
+    std::vector<GoalGroup>                          m_goalGroups;
+    std::vector<PathServiceResult>                  m_results;
+    WorkerTaskHandle                                m_task;
+    int                                             m_numFloods       = 0;
+};
@@ -0,0 +1,216 @@
+//----------------------------------------------------------------------------------------------------
+// PerformanceHud.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/PerformanceHud.hpp"
+
+#include <algorithm>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/SimpleTriangleFont.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Game/AllocationTracker.hpp"
+#include "Game/GameCommon.hpp"
+
+//----------------------------------------------------------------------------------------------------
+static float constexpr FRAME_BUDGET_MILLISECONDS = 1000.f / 60.f;
+static float constexpr GRAPH_MAX_MILLISECONDS    = 50.f;
+static float constexpr GRAPH_HEIGHT              = 80.f;
+static float constexpr LINE_HEIGHT               = 16.f;
+static float constexpr TEXT_CELL_HEIGHT          = 12.f;
+static float constexpr TEXT_CELL_ASPECT          = 0.6f;
+static float constexpr PHASE_SMOOTHING           = 0.1f;       // Weight of the newest tick in each phase average
+
+//----------------------------------------------------------------------------------------------------
+// SimpleTriangleFont glyphs are plain triangles, so text shares the panel's untextured draw.
+//
+static void AddVertsForTextLine(VertexList_PCU& verts, String const& text, Vec2 const& position)
+{
+    AddVertsForTextTriangles2D(verts,
+                               text,
+                               position,
+                               TEXT_CELL_HEIGHT,
+                               Rgba8::WHITE,
+                               TEXT_CELL_ASPECT,
+                               true,
+                               0.05f);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Measures the wall-clock time since the previous call, so pause and slow-mo do not distort it.
+//
+void PerformanceHud::BeginFrame()
+{
+    std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+
+    if (m_hasFrameStart)
+    {
+        m_frameMilliseconds[m_nextFrameSample] = std::chrono::duration<float, std::milli>(now - m_frameStartTime).count();
+        m_nextFrameSample                      = (m_nextFrameSample + 1) % NUM_FRAME_SAMPLES;
+        m_numFrameSamples                      = std::min(m_numFrameSamples + 1, NUM_FRAME_SAMPLES);
+    }
+
+    m_frameStartTime = now;
+    m_hasFrameStart  = true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void PerformanceHud::OnMapUpdatePhaseBegin(MapUpdatePhase const phase)
+{
+    UNUSED(phase)
+
+    m_phaseStartTime = std::chrono::steady_clock::now();
+}
+
+//----------------------------------------------------------------------------------------------------
+void PerformanceHud::OnMapUpdatePhaseEnd(MapUpdatePhase const phase)
+{
+    float const milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_phaseStartTime).count();
+
+    m_phaseMilliseconds[phase] += (milliseconds - m_phaseMilliseconds[phase]) * PHASE_SMOOTHING;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Lines run top-down from the top-left of bounds; the graph sits under the frame time summary.
+//
+void PerformanceHud::Render(Map const& map, AABB2 const& bounds) const
+{
+    VertexList_PCU verts;
+
+    verts.reserve(NUM_FRAME_SAMPLES * 6 + 8192);
+    AddVertsForAABB2D(verts, bounds, Rgba8(0, 0, 0, 160));
+
+    float const left = bounds.m_mins.x + 8.f;
+    float       y    = bounds.m_maxs.y - LINE_HEIGHT;
+
+    AddVertsForTextLine(verts, GetFrameTimeSummary(), Vec2(left, y));
+
+    y -= GRAPH_HEIGHT + 4.f;
+    AddVertsForFrameGraph(verts, AABB2(Vec2(left, y), Vec2(bounds.m_maxs.x - 8.f, y + GRAPH_HEIGHT)));
+    y -= LINE_HEIGHT + 4.f;
+
+    for (String const& line : GetStatLines(map))
+    {
+        AddVertsForTextLine(verts, line, Vec2(left, y));
+        y -= LINE_HEIGHT;
+    }
+
+    g_theRenderer->BindTexture(nullptr);
+    g_theRenderer->DrawVertexArray(static_cast<int>(verts.size()), verts.data());
+}
+
+//----------------------------------------------------------------------------------------------------
+String PerformanceHud::GetFrameTimeSummary() const
+{
+    float latestMilliseconds = 0.f;
+    float totalMilliseconds  = 0.f;
+    float maxMilliseconds    = 0.f;
+
+    for (int sampleIndex = 0; sampleIndex < m_numFrameSamples; ++sampleIndex)
+    {
+        totalMilliseconds += m_frameMilliseconds[sampleIndex];
+        maxMilliseconds = std::max(maxMilliseconds, m_frameMilliseconds[sampleIndex]);
+    }
+
+    if (m_numFrameSamples > 0) latestMilliseconds = m_frameMilliseconds[(m_nextFrameSample + NUM_FRAME_SAMPLES - 1) % NUM_FRAME_SAMPLES];
+
+    float const averageMilliseconds = m_numFrameSamples > 0 ? totalMilliseconds / static_cast<float>(m_numFrameSamples) : 0.f;
+
+    return Stringf("Frame %5.2f ms  avg %5.2f  max %5.2f  (%d frames)", latestMilliseconds, averageMilliseconds, maxMilliseconds, m_numFrameSamples);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Phase times, entity counts four types to a line, the last tick's path and ray work, enemies per AI
+// level-of-detail tier, and the heap.
+//
+StringList PerformanceHud::GetStatLines(Map const& map) const
+{
+    StringList lines;
+
+    for (int phaseIndex = 0; phaseIndex < NUM_MAP_UPDATE_PHASES; ++phaseIndex)
+    {
+        lines.push_back(Stringf("%-32s %6.3f ms", GetMapUpdatePhaseName(static_cast<MapUpdatePhase>(phaseIndex)), m_phaseMilliseconds[phaseIndex]));
+    }
+
+    String entityLine = "Entities ";
+
+    for (int typeIndex = 0; typeIndex < NUM_ENTITY_TYPES; ++typeIndex)
+    {
+        EntityType const type = static_cast<EntityType>(typeIndex);
+
+        entityLine += Stringf(" %s %d", GetEntityTypeName(type), map.GetNumEntitiesOfType(type));
+
+        if (typeIndex % 4 == 3 || typeIndex == NUM_ENTITY_TYPES - 1)
+        {
+            lines.push_back(entityLine);
+            entityLine = "         ";
+        }
+    }
+
+    MapFrameStats const frameStats      = map.GetFrameStats();
+    float const         cacheHitPercent = frameStats.m_numPathRequests > 0 ? 100.f * static_cast<float>(frameStats.m_numFlowFieldCacheHits) / static_cast<float>(frameStats.m_numPathRequests) : 0.f;
+
+    lines.push_back(Stringf("Paths %d  flow field hits %d (%.0f%%)  rays %d", frameStats.m_numPathRequests, frameStats.m_numFlowFieldCacheHits, cacheHitPercent, frameStats.m_numRaycasts));
+    lines.push_back(Stringf("Player sight checks %d  view %s  other sight checks %d (%d from PVS)",
+                            frameStats.m_numPlayerSightChecks,
+                            frameStats.m_didRebuildPlayerView ? "recast" : "cached",
+                            frameStats.m_numLineOfSightChecks,
+                            frameStats.m_numLineOfSightByPvs));
+    lines.push_back(Stringf("AI LOD  %s %d  %s %d  %s %d  full updates %d",
+                            GetAILodTierName(AI_LOD_TIER_NEAR), frameStats.m_numAIAgentsByLodTier[AI_LOD_TIER_NEAR],
+                            GetAILodTierName(AI_LOD_TIER_MID), frameStats.m_numAIAgentsByLodTier[AI_LOD_TIER_MID],
+                            GetAILodTierName(AI_LOD_TIER_FAR), frameStats.m_numAIAgentsByLodTier[AI_LOD_TIER_FAR],
+                            frameStats.m_numFullAIUpdates));
+    lines.push_back(Stringf("Path queue  served %d  sent %d  coalesced %d  floods %d  waiting %d  %.0f us",
+                            frameStats.m_pathRequestService.m_numServed,
+                            frameStats.m_pathRequestService.m_numDispatched,
+                            frameStats.m_pathRequestService.m_numCoalesced,
+                            frameStats.m_pathRequestService.m_numFloods,
+                            frameStats.m_pathRequestService.m_numWaiting,
+                            static_cast<double>(frameStats.m_pathRequestService.m_microseconds)));
+
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    AllocationFrameStats const allocationStats = AllocationTracker::GetLastFrameStats();
+
+    lines.push_back(Stringf("Heap %lld allocs  %.1f KB  peak live %.1f MB",
+                            static_cast<long long>(allocationStats.m_numAllocations),
+                            static_cast<double>(allocationStats.m_numBytes) / 1024.0,
+                            static_cast<double>(allocationStats.m_peakLiveBytes) / (1024.0 * 1024.0)));
+#else
+    lines.push_back("Heap  (define GAME_ENABLE_ALLOCATION_TRACKING)");
+#endif
+
+    return lines;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Oldest sample on the left. Bars are green within the 60 Hz budget, yellow within two frames and red
+// past that; faint lines mark 16.7 and 33.3 ms.
+//
+void PerformanceHud::AddVertsForFrameGraph(VertexList_PCU& verts, AABB2 const& graphBounds) const
+{
+    float const width    = graphBounds.m_maxs.x - graphBounds.m_mins.x;
+    float const barWidth = width / static_cast<float>(NUM_FRAME_SAMPLES);
+    int const   oldest   = (m_nextFrameSample + NUM_FRAME_SAMPLES - m_numFrameSamples) % NUM_FRAME_SAMPLES;
+
+    AddVertsForAABB2D(verts, graphBounds, Rgba8(40, 40, 40, 160));
+
+    for (int sampleIndex = 0; sampleIndex < m_numFrameSamples; ++sampleIndex)
+    {
+        float const milliseconds = m_frameMilliseconds[(oldest + sampleIndex) % NUM_FRAME_SAMPLES];
+        float const barHeight    = GRAPH_HEIGHT * std::min(milliseconds / GRAPH_MAX_MILLISECONDS, 1.f);
+        float const barLeft      = graphBounds.m_mins.x + barWidth * static_cast<float>(NUM_FRAME_SAMPLES - m_numFrameSamples + sampleIndex);
+        Rgba8 const color        = milliseconds <= FRAME_BUDGET_MILLISECONDS ? Rgba8::GREEN : milliseconds <= FRAME_BUDGET_MILLISECONDS * 2.f ? Rgba8::YELLOW : Rgba8::RED;
+
+        AddVertsForAABB2D(verts, AABB2(Vec2(barLeft, graphBounds.m_mins.y), Vec2(barLeft + barWidth, graphBounds.m_mins.y + barHeight)), color);
+    }
+
+    for (float const budgetMilliseconds : {FRAME_BUDGET_MILLISECONDS, FRAME_BUDGET_MILLISECONDS * 2.f})
+    {
+        float const lineY = graphBounds.m_mins.y + GRAPH_HEIGHT * budgetMilliseconds / GRAPH_MAX_MILLISECONDS;
+
+        AddVertsForAABB2D(verts, AABB2(Vec2(graphBounds.m_mins.x, lineY), Vec2(graphBounds.m_maxs.x, lineY + 1.f)), Rgba8(255, 255, 255, 96));
+    }
+}
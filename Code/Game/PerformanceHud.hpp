@@ -0,0 +1,44 @@
+//----------------------------------------------------------------------------------------------------
+// PerformanceHud.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <chrono>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Game/Map.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// The F7 overlay: a rolling graph of real frame times, how long each phase of Map::UpdateSimulation
+// took, entity counts by type, path requests, flow field cache hits, raycasts and enemies per AI
+// level-of-detail tier in the last tick, and heap allocations in the last frame. The Game passes it to Map::Update as the phase listener
+// every frame, so perf.stats can print the same lines while it is hidden. Everything is drawn as
+// untextured triangles in a single DrawVertexArray.
+//
+class PerformanceHud : public MapUpdatePhaseListener
+{
+public:
+    static constexpr int NUM_FRAME_SAMPLES = 240;
+
+    void BeginFrame();
+    void OnMapUpdatePhaseBegin(MapUpdatePhase phase) override;
+    void OnMapUpdatePhaseEnd(MapUpdatePhase phase) override;
+    void Render(Map const& map, AABB2 const& bounds) const;
+
+    String     GetFrameTimeSummary() const;
+    StringList GetStatLines(Map const& map) const;
+
+private:
+    void AddVertsForFrameGraph(VertexList_PCU& verts, AABB2 const& graphBounds) const;
+
+    float                                 m_frameMilliseconds[NUM_FRAME_SAMPLES]     = {};
+    int                                   m_nextFrameSample                          = 0;
+    int                                   m_numFrameSamples                          = 0;
+    bool                                  m_hasFrameStart                            = false;
+    std::chrono::steady_clock::time_point m_frameStartTime;
+    std::chrono::steady_clock::time_point m_phaseStartTime;
+    float                                 m_phaseMilliseconds[NUM_MAP_UPDATE_PHASES] = {};   // Smoothed so the digits are readable
+};
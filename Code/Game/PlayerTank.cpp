@@ -11,18 +11,20 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Game/EntityDefinition.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Log.hpp"
 #include "Game/Map.hpp"
 
 STATIC bool PlayerTank::SHOOT(EventArgs& args)
 {
     String playerName = args.GetValue("SHOOT", "Unknown");
-    printf("SHOOT: %s\n", playerName.c_str());
+    GAME_LOG(LOG_CATEGORY_GAME, LOG_LEVEL_INFO, "SHOOT: %s", playerName);
 
 
 
-    g_theAudio->StartSound(g_theGame->GetPlayerTankShootSoundID());
+    g_theGame->PostSoundEvent(g_theGame->GetPlayerTankShootSoundID(), g_theGame->GetPlayerTank()->m_position, SOUND_PRIORITY_HIGH);
     return false;
 }
 
@@ -30,20 +32,8 @@ STATIC bool PlayerTank::SHOOT(EventArgs& args)
 PlayerTank::PlayerTank(Map* map, EntityType const type, EntityFaction const faction)
     : Entity(map, type, faction)
 {
-    m_physicsRadius      = g_gameConfigBlackboard.GetValue("playerTankPhysicsRadius", 0.3f);
-    m_rotateSpeed        = g_gameConfigBlackboard.GetValue("playerTankBodyRotateSpeed", 180.f);
-    m_health             = g_gameConfigBlackboard.GetValue("playerTankInitHealth", 100);
-    m_isPushedByWalls    = g_gameConfigBlackboard.GetValue("playerTankIsPushedByWalls", true);
-    m_isPushedByEntities = g_gameConfigBlackboard.GetValue("playerTankIsPushedByEntities", true);
-    m_doesPushEntities   = g_gameConfigBlackboard.GetValue("playerTankDoesPushEntities", true);
-    m_canSwim            = g_gameConfigBlackboard.GetValue("playerTankCanSwim", false);
-
-    m_bodyBounds   = AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f));
-    m_turretBounds = AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f));
-
-    m_totalHealth   = m_health;
-    m_bodyTexture   = g_theRenderer->CreateOrGetTextureFromFile(PLAYER_TANK_BODY_IMG);
-    m_turretTexture = g_theRenderer->CreateOrGetTextureFromFile(PLAYER_TANK_TURRET_IMG);
+    m_turretBounds  = AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f));
+    m_turretTexture = m_definition->GetTurretTexture();
     g_theEventSystem->SubscribeEventCallbackFunction("SHOOT", SHOOT);
 }
 
@@ -77,7 +67,7 @@ void PlayerTank::Update(const float deltaSeconds)
             float const turretAbsoluteDegrees = m_orientationDegrees + m_turretRelativeOrientation;
             Vec2 const  fwdNormal             = Vec2::MakeFromPolarDegrees(turretAbsoluteDegrees);
             m_map->SpawnNewEntity(ENTITY_TYPE_BULLET, ENTITY_FACTION_GOOD, m_position + fwdNormal * 0.2f, turretAbsoluteDegrees);
-            m_shootCoolDown = g_gameConfigBlackboard.GetValue("playerTankShootCoolDown", 0.1f);
+            m_shootCoolDown = m_definition->GetShootCoolDown();
 
 
 
@@ -85,7 +75,7 @@ void PlayerTank::Update(const float deltaSeconds)
             m_map->SpawnNewEntity(ENTITY_TYPE_EXPLOSION, ENTITY_FACTION_NEUTRAL, m_position, m_orientationDegrees);
 
 
-            g_theAudio->StartSound(g_theGame->GetPlayerTankShootSoundID());
+            m_map->PostSoundEvent(g_theGame->GetPlayerTankShootSoundID(), m_position, SOUND_PRIORITY_HIGH);
         }
     }
 
@@ -223,7 +213,7 @@ void PlayerTank::UpdateTurret(const float deltaSeconds)
     float const turretGoalRelativeOrientation = m_turretGoalOrientationDegrees - m_orientationDegrees;
 
     TurnToward(m_turretRelativeOrientation, turretGoalRelativeOrientation, deltaSeconds,
-               m_turretRotateSpeed);
+               m_definition->GetTurretRotateSpeed());
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -35,7 +35,6 @@ private:
     Texture* m_turretTexture                = nullptr;
     float    m_turretRelativeOrientation    = 0.f;
     float    m_turretGoalOrientationDegrees = 0.f;
-    float    m_turretRotateSpeed            = g_gameConfigBlackboard.GetValue("playerTankTurretRotateSpeed", 360.f);
     float    m_shootCoolDown                = 0.f;
     float    m_bodyScale                    = 0.f;
     bool     m_isExiting                    = false;
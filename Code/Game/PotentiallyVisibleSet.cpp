@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------------------------------
+// PotentiallyVisibleSet.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/PotentiallyVisibleSet.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/TileMasks.hpp"
+#include "Game/TileVisibility.hpp"
+#include "Game/WorkerPool.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// A row has the same layout as a TileBitmap of the map, so each shadowcast is OR'd into it a word at a
+// time and a lookup is the TileBitmap bit test.
+//
+void PotentiallyVisibleSet::Build(TileBitmap const& transparent, int const maxBytes)
+{
+    PROFILE_SCOPE("PotentiallyVisibleSet::Build");
+
+    Reset();
+
+    m_dimensions = transparent.GetDimensions();
+
+    int const numTiles = m_dimensions.x * m_dimensions.y;
+
+    if (numTiles <= 0) return;
+
+    m_wordsPerTileRow = (m_dimensions.x + 63) / 64;
+    m_wordsPerRow     = m_wordsPerTileRow * m_dimensions.y;
+
+    int const bytesPerRow = m_wordsPerRow * static_cast<int>(sizeof(uint64_t));
+    int       clusterSize = 1;
+
+    // Rows go to clusters with a transparent tile, but the budget is checked against every cluster
+    for (;;)
+    {
+        int const numClusters = ((m_dimensions.x + clusterSize - 1) / clusterSize) * ((m_dimensions.y + clusterSize - 1) / clusterSize);
+
+        if (static_cast<int64_t>(numClusters) * bytesPerRow <= maxBytes || (clusterSize >= m_dimensions.x && clusterSize >= m_dimensions.y)) break;
+
+        clusterSize *= 2;
+    }
+
+    m_clusterDimensions = IntVec2((m_dimensions.x + clusterSize - 1) / clusterSize, (m_dimensions.y + clusterSize - 1) / clusterSize);
+    m_rowIndexByCluster.assign(static_cast<size_t>(m_clusterDimensions.x) * m_clusterDimensions.y, -1);
+
+    std::vector<IntVec2> rowClusters;
+
+    for (int clusterY = 0; clusterY < m_clusterDimensions.y; ++clusterY)
+    {
+        for (int clusterX = 0; clusterX < m_clusterDimensions.x; ++clusterX)
+        {
+            bool hasTransparentTile = false;
+
+            for (int y = clusterY * clusterSize; y < (clusterY + 1) * clusterSize && y < m_dimensions.y; ++y)
+            {
+                for (int x = clusterX * clusterSize; x < (clusterX + 1) * clusterSize && x < m_dimensions.x; ++x)
+                {
+                    hasTransparentTile = hasTransparentTile || transparent.IsSet(IntVec2(x, y));
+                }
+            }
+
+            if (!hasTransparentTile) continue;
+
+            m_rowIndexByCluster[clusterY * m_clusterDimensions.x + clusterX] = static_cast<int>(rowClusters.size());
+            rowClusters.emplace_back(clusterX, clusterY);
+        }
+    }
+
+    m_numRows = static_cast<int>(rowClusters.size());
+    m_rowWords.assign(static_cast<size_t>(m_numRows) * m_wordsPerRow, 0);
+
+    int const radius = m_dimensions.x + m_dimensions.y;
+
+    // Every row belongs to one index, so the workers never write the same word
+    auto const buildRow = [&](int const rowIndex)
+    {
+        IntVec2 const cluster = rowClusters[rowIndex];
+        uint64_t*     row     = m_rowWords.data() + static_cast<size_t>(rowIndex) * m_wordsPerRow;
+        TileBitmap    visible;
+
+        for (int y = cluster.y * clusterSize; y < (cluster.y + 1) * clusterSize && y < m_dimensions.y; ++y)
+        {
+            for (int x = cluster.x * clusterSize; x < (cluster.x + 1) * clusterSize && x < m_dimensions.x; ++x)
+            {
+                if (!transparent.IsSet(IntVec2(x, y))) continue;
+
+                ComputeFieldOfView(transparent, IntVec2(x, y), radius, visible);
+
+                uint64_t const* visibleWords = visible.GetWords();
+
+                for (int wordIndex = 0; wordIndex < m_wordsPerRow; ++wordIndex)
+                {
+                    row[wordIndex] |= visibleWords[wordIndex];
+                }
+            }
+        }
+    };
+
+    if (g_theWorkerPool)
+    {
+        g_theWorkerPool->ParallelFor(m_numRows, buildRow);
+    }
+    else
+    {
+        for (int rowIndex = 0; rowIndex < m_numRows; ++rowIndex)
+        {
+            buildRow(rowIndex);
+        }
+    }
+
+    m_clusterSize = clusterSize;
+}
+
+//----------------------------------------------------------------------------------------------------
+void PotentiallyVisibleSet::Reset()
+{
+    m_dimensions        = IntVec2::ZERO;
+    m_clusterDimensions = IntVec2::ZERO;
+    m_clusterSize       = 0;
+    m_wordsPerTileRow   = 0;
+    m_wordsPerRow       = 0;
+    m_numRows           = 0;
+    m_rowIndexByCluster.clear();
+    m_rowWords.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+// Nothing is visible from an opaque cluster or off the map. Before Build everything might be.
+//
+bool PotentiallyVisibleSet::IsPotentiallyVisible(IntVec2 const& fromCoords, IntVec2 const& toCoords) const
+{
+    if (!IsBuilt()) return true;
+
+    if (fromCoords.x < 0 || fromCoords.x >= m_dimensions.x || fromCoords.y < 0 || fromCoords.y >= m_dimensions.y) return false;
+    if (toCoords.x < 0 || toCoords.x >= m_dimensions.x || toCoords.y < 0 || toCoords.y >= m_dimensions.y) return false;
+
+    int const rowIndex = m_rowIndexByCluster[(fromCoords.y / m_clusterSize) * m_clusterDimensions.x + fromCoords.x / m_clusterSize];
+
+    if (rowIndex < 0) return false;
+
+    uint64_t const word = m_rowWords[static_cast<size_t>(rowIndex) * m_wordsPerRow + toCoords.y * m_wordsPerTileRow + (toCoords.x >> 6)];
+
+    return (word >> (toCoords.x & 63) & 1) != 0;
+}
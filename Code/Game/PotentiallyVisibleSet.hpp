@@ -0,0 +1,44 @@
+//----------------------------------------------------------------------------------------------------
+// PotentiallyVisibleSet.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Math/IntVec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class TileBitmap;
+
+//----------------------------------------------------------------------------------------------------
+// Tile-to-tile visibility for a map whose tiles no longer change, as one bit per (source, target).
+// Sources are square clusters of clusterSize tiles on a side, 1 unless a row per tile would not fit in
+// the byte budget; a cluster's bit is set when any of its tiles sees the target. Clusters with no
+// transparent tile get no row at all. Each row is the OR of one ComputeFieldOfView per source tile, so a
+// bit answers for the line between two tile centers, and rows are built in parallel on g_theWorkerPool.
+//
+class PotentiallyVisibleSet
+{
+public:
+    void Build(TileBitmap const& transparent, int maxBytes);
+    void Reset();
+
+    bool   IsBuilt() const { return m_clusterSize > 0; }
+    int    GetClusterSize() const { return m_clusterSize; }
+    int    GetNumRows() const { return m_numRows; }
+    size_t GetNumBytes() const { return m_rowWords.size() * sizeof(uint64_t); }
+    bool   IsPotentiallyVisible(IntVec2 const& fromCoords, IntVec2 const& toCoords) const;
+
+private:
+    IntVec2               m_dimensions        = IntVec2::ZERO;
+    IntVec2               m_clusterDimensions = IntVec2::ZERO;
+    int                   m_clusterSize       = 0;             // 0 until built
+    int                   m_wordsPerTileRow   = 0;             // One map row of targets, padded to a word
+    int                   m_wordsPerRow       = 0;
+    int                   m_numRows           = 0;
+    std::vector<int>      m_rowIndexByCluster;                 // -1 for clusters that are all opaque
+    std::vector<uint64_t> m_rowWords;
+};
@@ -0,0 +1,284 @@
+//----------------------------------------------------------------------------------------------------
+// Profiler.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/Profiler.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/RingBuffer.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Capacity of each thread's ring. Rings are drained every frame, so this bounds zones per thread per
+// frame; anything past it is counted as dropped rather than stalling the thread.
+//
+static constexpr int EVENTS_PER_THREAD = 16384;
+
+//----------------------------------------------------------------------------------------------------
+struct ProfileEvent
+{
+    char const* m_name       = nullptr;
+    int64_t     m_startTicks = 0;
+    int64_t     m_endTicks   = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+struct CapturedProfileEvent
+{
+    ProfileEvent m_event;
+    int          m_threadID = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+struct ProfilerThreadBuffer
+{
+    RingBuffer<ProfileEvent, EVENTS_PER_THREAD> m_events;
+    std::atomic<int>                            m_numDroppedEvents{0};
+    int                                         m_threadID = 0;
+    String                                      m_threadName;
+};
+
+//----------------------------------------------------------------------------------------------------
+STATIC std::atomic<bool> Profiler::s_isCapturing{false};
+
+//----------------------------------------------------------------------------------------------------
+static std::mutex                         s_threadBuffersMutex;
+static std::vector<ProfilerThreadBuffer*> s_threadBuffers;                   // Owned; freed on Shutdown
+static std::atomic<int>                   s_threadBuffersGeneration{0};      // Bumped on Shutdown so stale thread_local pointers re-register
+static std::vector<CapturedProfileEvent>  s_capturedEvents;                  // Main thread only
+static String                             s_captureFilePath;
+static int                                s_numCaptureFrames          = 0;
+static int                                s_numCaptureFramesRemaining = 0;
+static int                                s_numCaptureDroppedEvents   = 0;
+static int64_t                            s_captureStartTicks         = 0;
+
+static thread_local ProfilerThreadBuffer* t_threadBuffer           = nullptr;
+static thread_local int                   t_threadBufferGeneration = -1;
+static thread_local String                t_threadName;
+
+//----------------------------------------------------------------------------------------------------
+static ProfilerThreadBuffer* GetOrCreateThreadBuffer()
+{
+    int const generation = s_threadBuffersGeneration.load(std::memory_order_acquire);
+
+    if (t_threadBuffer && t_threadBufferGeneration == generation) return t_threadBuffer;
+
+    std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+    ProfilerThreadBuffer* threadBuffer = new ProfilerThreadBuffer();
+
+    threadBuffer->m_threadID   = static_cast<int>(s_threadBuffers.size());
+    threadBuffer->m_threadName = t_threadName.empty() ? Stringf("Thread %d", threadBuffer->m_threadID) : t_threadName;
+    s_threadBuffers.push_back(threadBuffer);
+
+    t_threadBuffer           = threadBuffer;
+    t_threadBufferGeneration = generation;
+
+    return threadBuffer;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Pops everything the threads have pushed so far. Only the main thread calls this, which keeps every
+// ring single-consumer.
+//
+static int DrainThreadBuffers(bool const isKeepingEvents)
+{
+    std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+    int numDroppedEvents = 0;
+
+    for (ProfilerThreadBuffer* threadBuffer : s_threadBuffers)
+    {
+        ProfileEvent event;
+
+        while (threadBuffer->m_events.TryPop(event))
+        {
+            if (isKeepingEvents) s_capturedEvents.push_back({event, threadBuffer->m_threadID});
+        }
+
+        numDroppedEvents += threadBuffer->m_numDroppedEvents.exchange(0, std::memory_order_relaxed);
+    }
+
+    return numDroppedEvents;
+}
+
+//----------------------------------------------------------------------------------------------------
+static double ConvertTicksToMicroseconds(int64_t const ticks)
+{
+    using Period = std::chrono::steady_clock::period;
+
+    return static_cast<double>(ticks) * 1000000.0 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool WriteChromeTrace(String const& filePath)
+{
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+
+    if (!file) return false;
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[\n";
+
+    bool isFirstEvent = true;
+
+    {
+        std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+        for (ProfilerThreadBuffer const* threadBuffer : s_threadBuffers)
+        {
+            file << (isFirstEvent ? "" : ",\n");
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadBuffer->m_threadID;
+            file << ",\"args\":{\"name\":\"" << threadBuffer->m_threadName << "\"}}";
+            isFirstEvent = false;
+        }
+    }
+
+    for (CapturedProfileEvent const& captured : s_capturedEvents)
+    {
+        double const startMicroseconds    = ConvertTicksToMicroseconds(captured.m_event.m_startTicks - s_captureStartTicks);
+        double const durationMicroseconds = ConvertTicksToMicroseconds(captured.m_event.m_endTicks - captured.m_event.m_startTicks);
+
+        file << (isFirstEvent ? "" : ",\n");
+        file << "{\"name\":\"" << captured.m_event.m_name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << captured.m_threadID;
+        file << ",\"ts\":" << startMicroseconds << ",\"dur\":" << durationMicroseconds << "}";
+        isFirstEvent = false;
+    }
+
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC void Profiler::Startup()
+{
+    SetThreadName("Main");
+}
+
+//----------------------------------------------------------------------------------------------------
+// Worker threads must be gone (or idle) by now; their thread_local pointers are invalidated by the
+// generation bump and would re-register on their next zone.
+//
+STATIC void Profiler::Shutdown()
+{
+    s_isCapturing.store(false);
+
+    std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+    for (ProfilerThreadBuffer* threadBuffer : s_threadBuffers)
+    {
+        delete threadBuffer;
+    }
+
+    s_threadBuffers.clear();
+    s_capturedEvents.clear();
+    s_capturedEvents.shrink_to_fit();
+    s_threadBuffersGeneration.fetch_add(1, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Call once per frame on the main thread, outside of every zone, so the frame's outermost zones have
+// already been pushed.
+//
+STATIC void Profiler::EndFrame()
+{
+    bool const isCapturing      = IsCapturing();
+    int const  numDroppedEvents = DrainThreadBuffers(isCapturing);
+
+    if (!isCapturing) return;
+
+    s_numCaptureDroppedEvents += numDroppedEvents;
+
+    --s_numCaptureFramesRemaining;
+
+    if (s_numCaptureFramesRemaining > 0) return;
+
+    s_isCapturing.store(false);
+
+    // Zones still open on other threads land after this; they are discarded by the next EndFrame
+    s_numCaptureDroppedEvents += DrainThreadBuffers(true);
+
+    if (WriteChromeTrace(s_captureFilePath))
+    {
+        g_theDevConsole->AddLine(Rgba8::GREEN, Stringf("Profiler: wrote %d zones over %d frames to %s (%d dropped)",
+                                                       static_cast<int>(s_capturedEvents.size()),
+                                                       s_numCaptureFrames,
+                                                       s_captureFilePath.c_str(),
+                                                       s_numCaptureDroppedEvents));
+    }
+    else
+    {
+        g_theDevConsole->AddLine(Rgba8::RED, Stringf("Profiler: could not write %s", s_captureFilePath.c_str()));
+    }
+
+    s_capturedEvents.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC void Profiler::RequestCapture(int const numFrames, String const& filePath)
+{
+#if defined(GAME_ENABLE_PROFILER)
+    if (IsCapturing())
+    {
+        g_theDevConsole->AddLine(Rgba8::RED, "Profiler: a capture is already running");
+        return;
+    }
+
+    // Anything pushed before this point belongs to no capture
+    DrainThreadBuffers(false);
+
+    s_capturedEvents.clear();
+    s_captureFilePath           = filePath;
+    s_numCaptureFrames          = numFrames > 0 ? numFrames : 1;
+    s_numCaptureFramesRemaining = s_numCaptureFrames;
+    s_numCaptureDroppedEvents   = 0;
+    s_captureStartTicks         = GetTicks();
+    s_isCapturing.store(true);
+
+    g_theDevConsole->AddLine(Rgba8::WHITE, Stringf("Profiler: capturing %d frames", s_numCaptureFrames));
+#else
+    UNUSED(numFrames)
+    UNUSED(filePath)
+
+    g_theDevConsole->AddLine(Rgba8::RED, "Profiler: compiled out (GAME_ENABLE_PROFILER is not defined)");
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+// Names the calling thread in captures. Call it before the thread's first zone, or at any time to
+// rename an already registered thread.
+//
+STATIC void Profiler::SetThreadName(String const& threadName)
+{
+    t_threadName = threadName;
+
+    if (!t_threadBuffer || t_threadBufferGeneration != s_threadBuffersGeneration.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+    t_threadBuffer->m_threadName = threadName;
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC int64_t Profiler::GetTicks()
+{
+    return static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC void Profiler::RecordEvent(char const* name, int64_t const startTicks, int64_t const endTicks)
+{
+    ProfilerThreadBuffer* threadBuffer = GetOrCreateThreadBuffer();
+
+    if (!threadBuffer->m_events.TryPush({name, startTicks, endTicks}))
+    {
+        threadBuffer->m_numDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
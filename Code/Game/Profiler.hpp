@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------------------------------
+// Profiler.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Game/AllocationTracker.hpp"
+#include "Game/GameBuildPreferences.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Frame profiler. Zones are recorded only while a capture is running; each thread pushes its finished
+// zones into its own lock-free ring, and the main thread drains every ring once per frame. When the
+// requested number of frames has been captured, the zones are written out as Chrome trace JSON
+// (open it in chrome://tracing or ui.perfetto.dev). Nesting comes from the timestamps themselves.
+//
+class Profiler
+{
+public:
+    static void Startup();
+    static void Shutdown();
+    static void EndFrame();
+
+    static void RequestCapture(int numFrames, String const& filePath);
+    static bool IsCapturing() { return s_isCapturing.load(std::memory_order_relaxed); }
+    static void SetThreadName(String const& threadName);
+
+    static int64_t GetTicks();
+    static void    RecordEvent(char const* name, int64_t startTicks, int64_t endTicks);
+
+private:
+    static std::atomic<bool> s_isCapturing;
+};
+
+//----------------------------------------------------------------------------------------------------
+#if defined(GAME_ENABLE_PROFILER)
+
+//----------------------------------------------------------------------------------------------------
+// name must outlive the capture; pass a string literal. With allocation tracking on, the scope is also
+// the zone its thread's allocations are charged to.
+//
+class ProfileScope
+{
+public:
+    explicit ProfileScope(char const* name)
+    {
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+        m_previousAllocationZone = AllocationTracker::SetCurrentZone(name);
+#endif
+
+        if (!Profiler::IsCapturing()) return;
+
+        m_name       = name;
+        m_startTicks = Profiler::GetTicks();
+    }
+
+    ~ProfileScope()
+    {
+        if (m_name) Profiler::RecordEvent(m_name, m_startTicks, Profiler::GetTicks());
+
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+        AllocationTracker::SetCurrentZone(m_previousAllocationZone);
+#endif
+    }
+
+    ProfileScope(ProfileScope const&)            = delete;
+    ProfileScope& operator=(ProfileScope const&) = delete;
+
+private:
+    char const* m_name       = nullptr;
+    int64_t     m_startTicks = 0;
+
+#if defined(GAME_ENABLE_ALLOCATION_TRACKING)
+    char const* m_previousAllocationZone = nullptr;
+#endif
+};
+
+#define PROFILE_SCOPE_CONCAT_INNER(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b)       PROFILE_SCOPE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name)              ProfileScope const PROFILE_SCOPE_CONCAT(profileScope_, __LINE__)(name)
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif
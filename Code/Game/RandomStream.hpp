@@ -0,0 +1,54 @@
+//----------------------------------------------------------------------------------------------------
+// RandomStream.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+
+//----------------------------------------------------------------------------------------------------
+// A seeded generator that belongs to one owner, with the same Roll* calls as the Engine's
+// RandomNumberGenerator. The Engine's generator draws from the C runtime's per-thread state, so what it
+// returns depends on which thread asks; each roll here is a hash of (seed, roll index), so a map
+// ticked on any worker thread replays identically.
+//
+class RandomStream
+{
+public:
+    void SetSeed(uint32_t const seed)
+    {
+        m_seed      = seed;
+        m_rollIndex = 0;
+    }
+
+    uint32_t RollRandomUInt32()
+    {
+        uint64_t bits = (static_cast<uint64_t>(m_seed) << 32 | m_rollIndex++) + 0x9E3779B97F4A7C15ull;
+
+        bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ull;
+        bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBull;
+
+        return static_cast<uint32_t>((bits ^ (bits >> 31)) >> 32);
+    }
+
+    int RollRandomIntInRange(int const minInclusive, int const maxInclusive)
+    {
+        uint32_t const range = static_cast<uint32_t>(maxInclusive - minInclusive) + 1u;
+
+        return minInclusive + static_cast<int>(RollRandomUInt32() % range);
+    }
+
+    float RollRandomFloatZeroToOne()
+    {
+        return static_cast<float>(RollRandomUInt32() >> 8) * (1.f / 16777216.f);
+    }
+
+    float RollRandomFloatInRange(float const minInclusive, float const maxInclusive)
+    {
+        return minInclusive + (maxInclusive - minInclusive) * RollRandomFloatZeroToOne();
+    }
+
+private:
+    uint32_t m_seed      = 0;
+    uint32_t m_rollIndex = 0;
+};
@@ -0,0 +1,50 @@
+//----------------------------------------------------------------------------------------------------
+// RingBuffer.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------------------------
+// Fixed-capacity queue for exactly one producer thread and one consumer thread. Neither side takes a
+// lock; a push into a full buffer fails instead of blocking, so the producer never stalls.
+//
+template <typename T, int CAPACITY>
+class RingBuffer
+{
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    bool TryPush(T const& value)
+    {
+        uint32_t const head = m_head.load(std::memory_order_relaxed);
+
+        if (head - m_tail.load(std::memory_order_acquire) == static_cast<uint32_t>(CAPACITY)) return false;
+
+        m_items[head & (CAPACITY - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool TryPop(T& outValue)
+    {
+        uint32_t const tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+
+        outValue = m_items[tail & (CAPACITY - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    int GetCapacity() const { return CAPACITY; }
+
+private:
+    T                                 m_items[CAPACITY];
+    alignas(64) std::atomic<uint32_t> m_head{0};    // Written by the producer only
+    alignas(64) std::atomic<uint32_t> m_tail{0};    // Written by the consumer only
+};
@@ -8,6 +8,7 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Game/EntityDefinition.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
@@ -17,19 +18,8 @@
 Scorpio::Scorpio(Map* map, EntityType const type, EntityFaction const faction)
     : Entity(map, type, faction)
 {
-    m_physicsRadius      = g_gameConfigBlackboard.GetValue("scorpioPhysicsRadius", 0.f);
-    m_detectRange        = g_gameConfigBlackboard.GetValue("scorpioDetectRange", 0.f);
-    m_isPushedByWalls    = g_gameConfigBlackboard.GetValue("scorpioIsPushedByWalls", -1);
-    m_isPushedByEntities = g_gameConfigBlackboard.GetValue("scorpioIsPushedByEntities", -1);
-    m_doesPushEntities   = g_gameConfigBlackboard.GetValue("scorpioDoesPushEntities", -1);
-    m_canSwim            = g_gameConfigBlackboard.GetValue("scorpioCanSwim", -1);
-    m_goalPosition       = m_position;
-    m_health             = g_gameConfigBlackboard.GetValue("scorpioInitHealth", 5);
-
-    m_totalHealth = m_health;
-    
-    m_bodyTexture   = g_theRenderer->CreateOrGetTextureFromFile(SCORPIO_BODY_IMG);
-    m_turretTexture = g_theRenderer->CreateOrGetTextureFromFile(SCORPIO_TURRET_IMG);
+    m_goalPosition  = m_position;
+    m_turretTexture = m_definition->GetTurretTexture();
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -38,12 +28,14 @@ void Scorpio::Update(float const deltaSeconds)
     if (m_isDead)
         return;
 
-    if (g_theGame->GetPlayerTank()->m_isDead)
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
+
+    if (playerTank && playerTank->m_isDead)
         return;
 
     if (m_health <= 0)
     {
-        g_theAudio->StartSound(g_theGame->GetEnemyDiedSoundID());
+        m_map->PostSoundEvent(g_theGame->GetEnemyDiedSoundID(), m_position, SOUND_PRIORITY_HIGH);
         m_map->SpawnNewEntity(ENTITY_TYPE_EXPLOSION, ENTITY_FACTION_NEUTRAL, m_position, m_orientationDegrees);
         m_isGarbage = true;
         m_isDead    = true;
@@ -97,25 +89,25 @@ void Scorpio::UpdateTurret(float const deltaSeconds)
     }
 
     // Turn and shoot ( or turn idly)
-    PlayerTank const* playerTank = g_theGame->GetPlayerTank();
-    if (m_map->HasLineOfSight(m_position, playerTank->m_position, m_detectRange) && !playerTank->m_isDead)
+    PlayerTank const* playerTank = m_map->GetPlayerTank();
+    if (playerTank && m_map->HasLineOfSightToPlayer(m_position, m_detectRange) && !playerTank->m_isDead)
     {
         // Turn toward player
         float const targetOrientationDegrees = (m_goalPosition - m_position).GetOrientationDegrees();
 
-        TurnToward(m_turretOrientationDegrees, targetOrientationDegrees, deltaSeconds, m_turretRotateSpeed);
+        TurnToward(m_turretOrientationDegrees, targetOrientationDegrees, deltaSeconds, m_definition->GetTurretRotateSpeed());
 
         // Shot at player if facing close enough to orientation
         Vec2 const  dispToTarget    = playerTank->m_position - m_position;
         Vec2 const  myFwdNormal     = Vec2::MakeFromPolarDegrees(m_turretOrientationDegrees);
         float const degreesToTarget = GetAngleDegreesBetweenVectors2D(dispToTarget, myFwdNormal);
 
-        if (degreesToTarget < m_shootDegreesThreshold &&
+        if (degreesToTarget < m_definition->GetShootDegreesThreshold() &&
             m_shootCoolDown <= 0.0f)
         {
             m_map->SpawnNewEntity(ENTITY_TYPE_BULLET, ENTITY_FACTION_EVIL, m_position + myFwdNormal * 0.45f, m_turretOrientationDegrees);
-            m_shootCoolDown = g_gameConfigBlackboard.GetValue("scorpioShootCoolDown", 0.3f);
-            g_theAudio->StartSound(g_theGame->GetEnemyShootSoundID());
+            m_shootCoolDown = m_definition->GetShootCoolDown();
+            m_map->PostSoundEvent(g_theGame->GetEnemyShootSoundID(), m_position, SOUND_PRIORITY_NORMAL);
             m_map->SpawnNewEntity(ENTITY_TYPE_EXPLOSION, ENTITY_FACTION_NEUTRAL, m_position, m_orientationDegrees);
         }
 
@@ -124,7 +116,7 @@ void Scorpio::UpdateTurret(float const deltaSeconds)
     else
     {
         // turn blindly
-        m_turretOrientationDegrees += deltaSeconds * m_turretRotateSpeed;
+        m_turretOrientationDegrees += deltaSeconds * m_definition->GetTurretRotateSpeed();
     }
 }
 
@@ -32,6 +32,4 @@ private:
     Texture* m_turretTexture            = nullptr;
     float    m_turretOrientationDegrees = 0.f;
     float    m_shootCoolDown            = 0.f;
-    float    m_turretRotateSpeed        = g_gameConfigBlackboard.GetValue("scorpioTurretRotateSpeed", 90.f);
-    float    m_shootDegreesThreshold    = g_gameConfigBlackboard.GetValue("scorpioShootDegreesThreshold", 5.f);
 };
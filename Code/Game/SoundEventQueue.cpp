@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------------------------------
+// SoundEventQueue.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/SoundEventQueue.hpp"
+
+#include <algorithm>
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/GameAudioSystem.hpp"
+#include "Game/GameCommon.hpp"
+
+//----------------------------------------------------------------------------------------------------
+void SoundEventQueue::SetAudibleBounds(AABB2 const& bounds)
+{
+    m_audibleBounds    = AABB2(bounds.m_mins - Vec2(AUDIBLE_MARGIN, AUDIBLE_MARGIN), bounds.m_maxs + Vec2(AUDIBLE_MARGIN, AUDIBLE_MARGIN));
+    m_hasAudibleBounds = true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Merging here rather than in Flush keeps the pending list as short as the number of distinct sounds.
+//
+void SoundEventQueue::Post(SoundID const soundID, Vec2 const& position, SoundPriority const priority)
+{
+    if (soundID == MISSING_SOUND_ID) return;
+
+    ++m_frameStats.m_numPosted;
+
+    if (m_hasAudibleBounds && !m_audibleBounds.IsPointInside(position))
+    {
+        ++m_frameStats.m_numCulled;
+        return;
+    }
+
+    for (PendingSoundEvent& pendingEvent : m_pendingEvents)
+    {
+        if (pendingEvent.m_soundID != soundID) continue;
+
+        pendingEvent.m_priority = std::max(pendingEvent.m_priority, priority);
+        ++pendingEvent.m_numEvents;
+        ++m_frameStats.m_numMerged;
+        return;
+    }
+
+    PendingSoundEvent pendingEvent;
+
+    pendingEvent.m_soundID   = soundID;
+    pendingEvent.m_priority  = priority;
+    pendingEvent.m_numEvents = 1;
+
+    m_pendingEvents.push_back(pendingEvent);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Highest priority first, so a full budget is spent on the sounds that matter most. Every posted event
+// ends up counted exactly once as culled, merged, started or dropped.
+//
+void SoundEventQueue::Flush(double const nowSeconds)
+{
+    RetireFinishedVoices(nowSeconds);
+
+    std::stable_sort(m_pendingEvents.begin(), m_pendingEvents.end(), [](PendingSoundEvent const& a, PendingSoundEvent const& b)
+    {
+        return a.m_priority > b.m_priority;
+    });
+
+    for (PendingSoundEvent const& pendingEvent : m_pendingEvents)
+    {
+        int const coalescingVoiceIndex = FindCoalescingVoice(pendingEvent.m_soundID, nowSeconds);
+
+        if (coalescingVoiceIndex >= 0)
+        {
+            ActiveVoice& voice = m_activeVoices[coalescingVoiceIndex];
+
+            voice.m_numEvents += pendingEvent.m_numEvents;
+            voice.m_priority   = std::max(voice.m_priority, pendingEvent.m_priority);
+            g_theAudio->SetSoundPlaybackVolume(voice.m_playbackID, GetVolumeForNumEvents(voice.m_numEvents));
+            ++m_frameStats.m_numMerged;
+            continue;
+        }
+
+        if (GetNumVoicesOfSound(pendingEvent.m_soundID) >= MAX_VOICES_PER_SOUND)
+        {
+            ++m_frameStats.m_numDropped;
+            continue;
+        }
+
+        if (static_cast<int>(m_activeVoices.size()) >= MAX_VOICES)
+        {
+            int const stealIndex = FindVoiceToSteal(pendingEvent.m_priority);
+
+            if (stealIndex < 0)
+            {
+                ++m_frameStats.m_numDropped;
+                continue;
+            }
+
+            g_theAudio->StopSound(m_activeVoices[stealIndex].m_playbackID);
+            m_activeVoices.erase(m_activeVoices.begin() + stealIndex);
+            ++m_frameStats.m_numStolen;
+        }
+
+        ActiveVoice voice;
+
+        voice.m_soundID      = pendingEvent.m_soundID;
+        voice.m_priority     = pendingEvent.m_priority;
+        voice.m_startSeconds = nowSeconds;
+        voice.m_numEvents    = pendingEvent.m_numEvents;
+        voice.m_playbackID   = g_theAudio->StartSound(pendingEvent.m_soundID, false, GetVolumeForNumEvents(pendingEvent.m_numEvents));
+
+        m_activeVoices.push_back(voice);
+        ++m_frameStats.m_numStarted;
+    }
+
+    m_pendingEvents.clear();
+
+    m_frameStats.m_numActiveVoices = static_cast<int>(m_activeVoices.size());
+    m_lastFlushStats               = m_frameStats;
+    m_frameStats                   = SoundEventFrameStats();
+}
+
+//----------------------------------------------------------------------------------------------------
+void SoundEventQueue::StopAll()
+{
+    for (ActiveVoice const& voice : m_activeVoices)
+    {
+        g_theAudio->StopSound(voice.m_playbackID);
+    }
+
+    m_activeVoices.clear();
+    m_pendingEvents.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+STATIC float SoundEventQueue::GetVolumeForNumEvents(int const numEvents)
+{
+    return std::min(1.f + VOLUME_PER_MERGED_EVENT * static_cast<float>(numEvents - 1), MAX_MERGED_VOLUME);
+}
+
+//----------------------------------------------------------------------------------------------------
+void SoundEventQueue::RetireFinishedVoices(double const nowSeconds)
+{
+    m_activeVoices.erase(std::remove_if(m_activeVoices.begin(), m_activeVoices.end(), [nowSeconds](ActiveVoice const& voice)
+    {
+        return nowSeconds - voice.m_startSeconds >= VOICE_LIFETIME_SECONDS;
+    }), m_activeVoices.end());
+}
+
+//----------------------------------------------------------------------------------------------------
+// Voices are kept in start order, so the last match is the newest.
+//
+int SoundEventQueue::FindCoalescingVoice(SoundID const soundID, double const nowSeconds) const
+{
+    for (int voiceIndex = static_cast<int>(m_activeVoices.size()) - 1; voiceIndex >= 0; --voiceIndex)
+    {
+        ActiveVoice const& voice = m_activeVoices[voiceIndex];
+
+        if (nowSeconds - voice.m_startSeconds > COALESCE_WINDOW_SECONDS) return -1;
+        if (voice.m_soundID == soundID) return voiceIndex;
+    }
+
+    return -1;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The oldest voice of the lowest priority below the given one, or -1 if every voice outranks it.
+//
+int SoundEventQueue::FindVoiceToSteal(SoundPriority const priority) const
+{
+    int stealIndex = -1;
+
+    for (int voiceIndex = 0; voiceIndex < static_cast<int>(m_activeVoices.size()); ++voiceIndex)
+    {
+        SoundPriority const voicePriority = m_activeVoices[voiceIndex].m_priority;
+
+        if (voicePriority >= priority) continue;
+        if (stealIndex < 0 || voicePriority < m_activeVoices[stealIndex].m_priority) stealIndex = voiceIndex;
+    }
+
+    return stealIndex;
+}
+
+//----------------------------------------------------------------------------------------------------
+int SoundEventQueue::GetNumVoicesOfSound(SoundID const soundID) const
+{
+    int numVoices = 0;
+
+    for (ActiveVoice const& voice : m_activeVoices)
+    {
+        if (voice.m_soundID == soundID) ++numVoices;
+    }
+
+    return numVoices;
+}
@@ -0,0 +1,92 @@
+//----------------------------------------------------------------------------------------------------
+// SoundEventQueue.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <vector>
+
+#include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Math/AABB2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// When every voice is taken, a new sound only plays by stopping a voice of strictly lower priority.
+//
+enum SoundPriority : int
+{
+    SOUND_PRIORITY_LOW,         // Hits
+    SOUND_PRIORITY_NORMAL,      // Enemy shots and discovery
+    SOUND_PRIORITY_HIGH,        // Deaths, player shots and player hits
+    NUM_SOUND_PRIORITIES
+};
+
+//----------------------------------------------------------------------------------------------------
+struct SoundEventFrameStats
+{
+    int m_numPosted       = 0;
+    int m_numCulled       = 0;      // Posted outside the audible bounds
+    int m_numMerged       = 0;      // Folded into another event or a voice that just started
+    int m_numStarted      = 0;
+    int m_numStolen       = 0;      // Lower-priority voices stopped to make room, not counted as events
+    int m_numDropped      = 0;      // Over the per-sound cap, or nothing lower to steal
+    int m_numActiveVoices = 0;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Gameplay posts sound events here instead of calling StartSound. Events outside the audible bounds
+// are culled on Post, and events with the same SoundID are merged while they wait, so the pending list
+// never holds more than one entry per sound however many ticks run before the next Flush. Flush starts
+// at most one voice per pending sound, louder the more events it stands for, and folds events into a
+// voice of the same sound that started within the coalescing window instead. Voices are capped per
+// sound and overall. The AudioSystem cannot say when a playback ends, so a voice is assumed to last
+// VOICE_LIFETIME_SECONDS after it starts.
+//
+class SoundEventQueue
+{
+public:
+    static constexpr int    MAX_VOICES_PER_SOUND    = 4;
+    static constexpr int    MAX_VOICES              = 16;
+    static constexpr double COALESCE_WINDOW_SECONDS = 0.05;
+    static constexpr double VOICE_LIFETIME_SECONDS  = 0.75;
+    static constexpr float  AUDIBLE_MARGIN          = 2.f;        // World units past the camera edge
+    static constexpr float  VOLUME_PER_MERGED_EVENT = 0.15f;
+    static constexpr float  MAX_MERGED_VOLUME       = 2.f;
+
+    void SetAudibleBounds(AABB2 const& bounds);
+    void Post(SoundID soundID, Vec2 const& position, SoundPriority priority);
+    void Flush(double nowSeconds);
+    void StopAll();
+
+    SoundEventFrameStats const& GetLastFlushStats() const { return m_lastFlushStats; }
+
+private:
+    struct PendingSoundEvent
+    {
+        SoundID       m_soundID   = MISSING_SOUND_ID;
+        SoundPriority m_priority  = SOUND_PRIORITY_LOW;
+        int           m_numEvents = 0;
+    };
+
+    struct ActiveVoice
+    {
+        SoundID         m_soundID      = MISSING_SOUND_ID;
+        SoundPlaybackID m_playbackID   = MISSING_SOUND_ID;
+        SoundPriority   m_priority     = SOUND_PRIORITY_LOW;
+        double          m_startSeconds = 0.0;
+        int             m_numEvents    = 0;
+    };
+
+    static float GetVolumeForNumEvents(int numEvents);
+
+    void RetireFinishedVoices(double nowSeconds);
+    int  FindCoalescingVoice(SoundID soundID, double nowSeconds) const;
+    int  FindVoiceToSteal(SoundPriority priority) const;
+    int  GetNumVoicesOfSound(SoundID soundID) const;
+
+    std::vector<PendingSoundEvent> m_pendingEvents;
+    std::vector<ActiveVoice>       m_activeVoices;
+    AABB2                          m_audibleBounds;
+    bool                           m_hasAudibleBounds = false;
+    SoundEventFrameStats           m_frameStats;
+    SoundEventFrameStats           m_lastFlushStats;
+};
@@ -6,6 +6,7 @@
 #include "Game/TileDefinition.hpp"
 
 #include "Engine/Core/EngineCommon.hpp"
+#include "Game/DefinitionCache.hpp"
 
 //----------------------------------------------------------------------------------------------------
 class SpriteSheet;
@@ -20,33 +21,78 @@ TileDefinition::TileDefinition(XmlElement const& tileDefElement, SpriteSheet con
     m_isSolid                  = ParseXmlAttribute(tileDefElement, "isSolid", false);
     m_isWater                  = ParseXmlAttribute(tileDefElement, "isWater", false);
     IntVec2 const spriteCoords = ParseXmlAttribute(tileDefElement, "spriteCoords", IntVec2(-1, -1));
-    int const     spriteIndex  = spriteCoords.x + spriteCoords.y * 8;
+    m_spriteIndex              = spriteCoords.x + spriteCoords.y * 8;
 
-    if (spriteIndex != -1)
+    if (m_spriteIndex != -1)
     {
-        m_spriteDef = spriteSheet.GetSpriteDef(spriteIndex);
+        m_spriteDef = spriteSheet.GetSpriteDef(m_spriteIndex);
     }
 
     m_tintColor = ParseXmlAttribute(tileDefElement, "tintColor", Rgba8::WHITE);
 }
 
 //----------------------------------------------------------------------------------------------------
-TileDefinition::~TileDefinition()
+// Reads back exactly what WriteToCache wrote, in the same order.
+//
+TileDefinition::TileDefinition(DefinitionCacheReader& cacheReader, SpriteSheet const& spriteSheet)
 {
-    for (TileDefinition const* tileDef : s_tileDefinitions)
+    m_name        = cacheReader.ReadString();
+    m_isSolid     = cacheReader.ReadBool();
+    m_isWater     = cacheReader.ReadBool();
+    m_spriteIndex = cacheReader.ReadInt();
+    m_tintColor   = cacheReader.ReadRgba8();
+
+    if (m_spriteIndex != -1 && !cacheReader.HasFailed())
     {
-        delete tileDef;
+        m_spriteDef = spriteSheet.GetSpriteDef(m_spriteIndex);
     }
+}
 
-    s_tileDefinitions.clear();
+//----------------------------------------------------------------------------------------------------
+void TileDefinition::WriteToCache(DefinitionCacheWriter& cacheWriter) const
+{
+    cacheWriter.WriteString(m_name);
+    cacheWriter.WriteBool(m_isSolid);
+    cacheWriter.WriteBool(m_isWater);
+    cacheWriter.WriteInt(m_spriteIndex);
+    cacheWriter.WriteRgba8(m_tintColor);
 }
 
 //----------------------------------------------------------------------------------------------------
+// Loads from TileDefinitions.xml.cache when it matches the XML, otherwise parses the XML and rewrites
+// the cache. Definitions read from a damaged cache are dropped before s_tileDefinitions sees them.
+//
 STATIC void TileDefinition::InitializeTileDefs(SpriteSheet const& spriteSheet)
 {
-    XmlDocument tileDefXml;
+    String const          sourcePath = "Data/Definitions/TileDefinitions.xml";
+    DefinitionCacheReader cacheReader;
+
+    if (cacheReader.Open(sourcePath))
+    {
+        std::vector<TileDefinition*> cachedTileDefs;
+        int const                    numTileDefs = cacheReader.ReadInt();
+
+        for (int tileDefIndex = 0; tileDefIndex < numTileDefs && !cacheReader.HasFailed(); ++tileDefIndex)
+        {
+            cachedTileDefs.push_back(new TileDefinition(cacheReader, spriteSheet));
+        }
 
-    if (tileDefXml.LoadFile("Data/Definitions/TileDefinitions.xml") != XmlResult::XML_SUCCESS)
+        if (!cacheReader.HasFailed())
+        {
+            s_tileDefinitions.insert(s_tileDefinitions.end(), cachedTileDefs.begin(), cachedTileDefs.end());
+            return;
+        }
+
+        for (TileDefinition const* tileDef : cachedTileDefs)
+        {
+            delete tileDef;
+        }
+    }
+
+    XmlDocument  tileDefXml;
+    size_t const firstNewTileDef = s_tileDefinitions.size();
+
+    if (tileDefXml.LoadFile(sourcePath.c_str()) != XmlResult::XML_SUCCESS)
         return;
 
     if (XmlElement* root = tileDefXml.FirstChildElement("TileDefinitions"))
@@ -57,6 +103,16 @@ STATIC void TileDefinition::InitializeTileDefs(SpriteSheet const& spriteSheet)
             s_tileDefinitions.push_back(tileDef);
         }
     }
+
+    DefinitionCacheWriter cacheWriter(cacheReader.GetSourceHash());
+    cacheWriter.WriteInt(static_cast<int>(s_tileDefinitions.size() - firstNewTileDef));
+
+    for (size_t tileDefIndex = firstNewTileDef; tileDefIndex < s_tileDefinitions.size(); ++tileDefIndex)
+    {
+        s_tileDefinitions[tileDefIndex]->WriteToCache(cacheWriter);
+    }
+
+    cacheWriter.Save(sourcePath);
 }
 
 //----------------------------------------------------------------------------------------------------
@@ -11,11 +11,18 @@
 #include "Engine/Renderer/SpriteDefinition.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 
+//----------------------------------------------------------------------------------------------------
+class DefinitionCacheReader;
+class DefinitionCacheWriter;
+
 //----------------------------------------------------------------------------------------------------
 struct TileDefinition
 {
     TileDefinition(XmlElement const& tileDefElement, SpriteSheet const& spriteSheet);
-    ~TileDefinition();
+    TileDefinition(DefinitionCacheReader& cacheReader, SpriteSheet const& spriteSheet);
+    ~TileDefinition() = default;
+
+    void WriteToCache(DefinitionCacheWriter& cacheWriter) const;
 
     static void                         InitializeTileDefs(SpriteSheet const& spriteSheet);
     static TileDefinition const*        GetTileDefByName(String const& name);
@@ -32,7 +39,8 @@ struct TileDefinition
 private:
     String           m_name;
     SpriteDefinition m_spriteDef;
-    bool             m_isSolid = false;
-    bool             m_isWater = false;
+    int              m_spriteIndex = -1;
+    bool             m_isSolid     = false;
+    bool             m_isWater     = false;
     Rgba8            m_tintColor;
 };
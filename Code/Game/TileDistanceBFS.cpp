@@ -0,0 +1,159 @@
+//----------------------------------------------------------------------------------------------------
+// TileDistanceBFS.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/TileDistanceBFS.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/TileDistanceField.hpp"
+#include "Game/TileMasks.hpp"
+#include "Game/WorkerPool.hpp"
+
+//----------------------------------------------------------------------------------------------------
+// Below this many frontier tiles per chunk, handing work to other threads costs more than it saves.
+//
+static constexpr int MIN_FRONTIER_TILES_PER_CHUNK = 2048;
+static constexpr int MAX_CHUNKS_PER_THREAD        = 4;
+
+//----------------------------------------------------------------------------------------------------
+void PopulateDistanceFieldBFS(TileBitmap const& passable, IntVec2 const& startCoords, TileDistanceField& outField)
+{
+    PROFILE_SCOPE("PopulateDistanceFieldBFS");
+
+    IntVec2 const dimensions = passable.GetDimensions();
+
+    if (outField.GetDimensions() != dimensions)
+    {
+        ERROR_AND_DIE("PopulateDistanceFieldBFS: field does not match the passable mask")
+    }
+
+    outField.SetValueAtAllTiles(TileDistanceField::UNREACHABLE);
+
+    if (startCoords.x < 0 || startCoords.x >= dimensions.x || startCoords.y < 0 || startCoords.y >= dimensions.y) return;
+
+    // A tile is "claimed" once its bit is set. Impassable tiles start out claimed, so one atomic
+    // fetch_or both tests passability and wins the tile for exactly one thread.
+    int const                                wordsPerRow = passable.GetWordsPerRow();
+    int const                                numWords    = passable.GetNumWords();
+    std::unique_ptr<std::atomic<uint64_t>[]> claimed(new std::atomic<uint64_t>[numWords]);
+
+    for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+    {
+        claimed[wordIndex].store(~passable.GetWords()[wordIndex], std::memory_order_relaxed);
+    }
+
+    int const startWord = startCoords.y * wordsPerRow + (startCoords.x >> 6);
+    claimed[startWord].fetch_or(uint64_t(1) << (startCoords.x & 63), std::memory_order_relaxed);
+    outField.SetValueAtCoords(startCoords, 0);
+
+    WorkerPool* const pool       = g_theWorkerPool;
+    int const         numThreads = pool ? pool->GetNumWorkerThreads() + 1 : 1;
+    int const         maxChunks  = numThreads * MAX_CHUNKS_PER_THREAD;
+
+    std::vector<IntVec2>              frontier(1, startCoords);
+    std::vector<std::vector<IntVec2>> nextFrontiers(maxChunks);
+    int                               distance = 0;
+
+    while (!frontier.empty())
+    {
+        uint16_t const nextDistance = static_cast<uint16_t>(std::min(distance + 1, static_cast<int>(TileDistanceField::MAX_DISTANCE)));
+        int const      numTiles     = static_cast<int>(frontier.size());
+        int const      numChunks    = std::clamp(numTiles / MIN_FRONTIER_TILES_PER_CHUNK, 1, maxChunks);
+
+        auto const expandChunk = [&](int const chunkIndex)
+        {
+            std::vector<IntVec2>& next      = nextFrontiers[chunkIndex];
+            int const             firstTile = static_cast<int>(static_cast<int64_t>(numTiles) * chunkIndex / numChunks);
+            int const             lastTile  = static_cast<int>(static_cast<int64_t>(numTiles) * (chunkIndex + 1) / numChunks);
+
+            next.clear();
+
+            for (int tileIndex = firstTile; tileIndex < lastTile; ++tileIndex)
+            {
+                IntVec2 const currentCoords = frontier[tileIndex];
+
+                for (IntVec2 const& offset : {IntVec2(1, 0), IntVec2(0, 1), IntVec2(0, -1), IntVec2(-1, 0)})
+                {
+                    IntVec2 const neighbor = currentCoords + offset;
+
+                    if (neighbor.x < 0 || neighbor.x >= dimensions.x || neighbor.y < 0 || neighbor.y >= dimensions.y) continue;
+
+                    std::atomic<uint64_t>& word = claimed[neighbor.y * wordsPerRow + (neighbor.x >> 6)];
+                    uint64_t const         bit  = uint64_t(1) << (neighbor.x & 63);
+
+                    // Cheap read first; only tiles that look free pay for the read-modify-write
+                    if ((word.load(std::memory_order_relaxed) & bit) != 0) continue;
+                    if ((word.fetch_or(bit, std::memory_order_relaxed) & bit) != 0) continue;
+
+                    outField.SetValueAtCoords(neighbor, nextDistance);
+                    next.push_back(neighbor);
+                }
+            }
+        };
+
+        if (numChunks == 1 || !pool)
+        {
+            for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+            {
+                expandChunk(chunkIndex);
+            }
+        }
+        else
+        {
+            pool->ParallelFor(numChunks, expandChunk);
+        }
+
+        frontier.clear();
+
+        for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+        {
+            frontier.insert(frontier.end(), nextFrontiers[chunkIndex].begin(), nextFrontiers[chunkIndex].end());
+        }
+
+        ++distance;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+void WritePathDownDistanceField(TileDistanceField const& field, IntVec2 const& startCoords, Vec2 const& goal, Vec2* outPoints)
+{
+    IntVec2 const dimensions    = field.GetDimensions();
+    IntVec2       currentCoords = startCoords;
+    int const     numSteps      = field.GetValueAtCoords(startCoords);
+
+    outPoints[0] = goal;
+
+    for (int step = 0; step < numSteps; ++step)
+    {
+        outPoints[numSteps - step] = Vec2(static_cast<float>(currentCoords.x) + 0.5f, static_cast<float>(currentCoords.y) + 0.5f);
+
+        // Walk to the neighbor with the lowest distance
+        IntVec2  bestNeighbor   = currentCoords;
+        uint16_t lowestDistance = field.GetValueAtCoords(currentCoords);
+
+        for (IntVec2 const& offset : {IntVec2(-1, 0), IntVec2(1, 0), IntVec2(0, -1), IntVec2(0, 1)})
+        {
+            IntVec2 const neighbor = currentCoords + offset;
+
+            if (neighbor.x < 0 || neighbor.x >= dimensions.x || neighbor.y < 0 || neighbor.y >= dimensions.y) continue;
+
+            uint16_t const distance = field.GetValueAtCoords(neighbor);
+
+            if (distance < lowestDistance)
+            {
+                lowestDistance = distance;
+                bestNeighbor   = neighbor;
+            }
+        }
+
+        currentCoords = bestNeighbor;
+    }
+}
@@ -0,0 +1,28 @@
+//----------------------------------------------------------------------------------------------------
+// TileDistanceBFS.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class TileBitmap;
+class TileDistanceField;
+
+//----------------------------------------------------------------------------------------------------
+// Breadth-first tile distances from startCoords over the set bits of passable (4-neighbor steps).
+// Wide frontiers are split across g_theWorkerPool, level by level; the result matches a serial BFS
+// exactly because every tile still receives its level number, whichever thread claims it.
+//
+void PopulateDistanceFieldBFS(TileBitmap const& passable, IntVec2 const& startCoords, TileDistanceField& outField);
+
+//----------------------------------------------------------------------------------------------------
+// Walks downhill through field from startCoords to the tile it was flooded from, writing the path
+// goal-first: outPoints[0] is goal and outPoints[numSteps] the start tile's center, where numSteps is
+// field's distance at startCoords. outPoints must hold numSteps + 1 points. Reads only, so any number
+// of threads may descend one field at once.
+//
+void WritePathDownDistanceField(TileDistanceField const& field, IntVec2 const& startCoords, Vec2 const& goal, Vec2* outPoints);
@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------------------------------
+// TileDistanceField.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/TileDistanceField.hpp"
+
+#include <algorithm>
+#include <new>
+
+#include "Engine/Core/HeatMaps.hpp"
+
+//----------------------------------------------------------------------------------------------------
+TileDistanceField::TileDistanceField(IntVec2 const& dimensions, uint16_t const initialValue)
+    : m_dimensions(dimensions)
+{
+    constexpr int valuesPerLane = ROW_ALIGNMENT_BYTES / static_cast<int>(sizeof(uint16_t));
+
+    m_rowPitch = (dimensions.x + valuesPerLane - 1) / valuesPerLane * valuesPerLane;
+
+    size_t const numBytes = static_cast<size_t>(m_rowPitch) * static_cast<size_t>(dimensions.y) * sizeof(uint16_t);
+
+    m_values = static_cast<uint16_t*>(::operator new(numBytes, std::align_val_t(ROW_ALIGNMENT_BYTES)));
+
+    SetValueAtAllTiles(initialValue);
+}
+
+//----------------------------------------------------------------------------------------------------
+TileDistanceField::~TileDistanceField()
+{
+    ::operator delete(m_values, std::align_val_t(ROW_ALIGNMENT_BYTES));
+    m_values = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Padding columns are written too, so a full-width pass over a row never reads garbage.
+//
+void TileDistanceField::SetValueAtAllTiles(uint16_t const value)
+{
+    std::fill_n(m_values, static_cast<size_t>(m_rowPitch) * static_cast<size_t>(m_dimensions.y), value);
+
+    m_sourceKey = 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+void TileDistanceField::CopyToTileHeatMap(TileHeatMap const& heatMap, float const unreachableValue) const
+{
+    for (int tileY = 0; tileY < m_dimensions.y; ++tileY)
+    {
+        uint16_t const* row = GetRow(tileY);
+
+        for (int tileX = 0; tileX < m_dimensions.x; ++tileX)
+        {
+            float const value = row[tileX] == UNREACHABLE ? unreachableValue : static_cast<float>(row[tileX]);
+
+            heatMap.SetValueAtCoords(IntVec2(tileX, tileY), value);
+        }
+    }
+}
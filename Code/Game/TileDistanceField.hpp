@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------------------------------------
+// TileDistanceField.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+
+#include "Engine/Math/IntVec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class TileHeatMap;
+
+//----------------------------------------------------------------------------------------------------
+// Integer tile distances, one uint16 per tile. Each row is padded to a whole number of 32-byte
+// lanes and the storage is 32-byte aligned, so rows can be processed with full-width SIMD loads.
+//
+class TileDistanceField
+{
+public:
+    static constexpr uint16_t UNREACHABLE         = 0xFFFF;
+    static constexpr uint16_t MAX_DISTANCE        = 0xFFFE;
+    static constexpr int      ROW_ALIGNMENT_BYTES = 32;
+
+    explicit TileDistanceField(IntVec2 const& dimensions, uint16_t initialValue = UNREACHABLE);
+    ~TileDistanceField();
+
+    TileDistanceField(TileDistanceField const&)            = delete;
+    TileDistanceField& operator=(TileDistanceField const&) = delete;
+
+    IntVec2         GetDimensions() const { return m_dimensions; }
+    int             GetRowPitch() const { return m_rowPitch; }
+    uint16_t*       GetRow(int const y) { return m_values + y * m_rowPitch; }
+    uint16_t const* GetRow(int const y) const { return m_values + y * m_rowPitch; }
+    uint16_t        GetValueAtCoords(int const x, int const y) const { return m_values[y * m_rowPitch + x]; }
+    uint16_t        GetValueAtCoords(IntVec2 const& coords) const { return GetValueAtCoords(coords.x, coords.y); }
+    bool            IsReachable(IntVec2 const& coords) const { return GetValueAtCoords(coords) != UNREACHABLE; }
+
+    void SetValueAtCoords(int const x, int const y, uint16_t const value) { m_values[y * m_rowPitch + x] = value; }
+    void SetValueAtCoords(IntVec2 const& coords, uint16_t const value) { SetValueAtCoords(coords.x, coords.y, value); }
+    void SetValueAtAllTiles(uint16_t value);
+
+    // Debug visualization only; unreachable tiles become unreachableValue
+    void CopyToTileHeatMap(TileHeatMap const& heatMap, float unreachableValue = 999.f) const;
+
+    // What the field was last flooded to, so a repeat request can skip the flood. 0 means unknown;
+    // SetValueAtAllTiles, which every flood starts with, resets it.
+    uint64_t GetSourceKey() const { return m_sourceKey; }
+    void     SetSourceKey(uint64_t const sourceKey) { m_sourceKey = sourceKey; }
+
+private:
+    IntVec2   m_dimensions = IntVec2::ZERO;
+    int       m_rowPitch   = 0;
+    uint16_t* m_values     = nullptr;
+    uint64_t  m_sourceKey  = 0;
+};
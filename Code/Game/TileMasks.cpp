@@ -0,0 +1,467 @@
+//----------------------------------------------------------------------------------------------------
+// TileMasks.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/TileMasks.hpp"
+
+#include <algorithm>
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Game/TileDistanceField.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define TILE_MASKS_X64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions inside functions that ask for them; MSVC always does
+#if defined(TILE_MASKS_X64) && !defined(_MSC_VER)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+//----------------------------------------------------------------------------------------------------
+typedef void (*PassableMaskKernel)(uint8_t const* flags, uint64_t const* occupied, uint64_t* outWords, int numWords, uint8_t blockFlags, uint8_t allowFlags);
+typedef void (*ExpandMaskKernel)(uint64_t const* maskRow, uint16_t* fieldRow, int numChunks);
+
+//----------------------------------------------------------------------------------------------------
+void TileFlagGrid::Resize(IntVec2 const& dimensions)
+{
+    m_dimensions = dimensions;
+    m_rowPitch   = (dimensions.x + TILES_PER_WORD - 1) / TILES_PER_WORD * TILES_PER_WORD;
+
+    m_flags.assign(static_cast<size_t>(m_rowPitch) * static_cast<size_t>(dimensions.y), TILE_FLAG_NONE);
+
+    for (int y = 0; y < dimensions.y; ++y)
+    {
+        std::fill(m_flags.begin() + y * m_rowPitch + dimensions.x, m_flags.begin() + (y + 1) * m_rowPitch, TILE_FLAG_SOLID);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+void TileBitmap::Resize(IntVec2 const& dimensions)
+{
+    m_dimensions  = dimensions;
+    m_wordsPerRow = (dimensions.x + 63) / 64;
+
+    m_words.assign(static_cast<size_t>(m_wordsPerRow) * static_cast<size_t>(dimensions.y), 0);
+}
+
+//----------------------------------------------------------------------------------------------------
+void TileBitmap::ClearAll()
+{
+    std::fill(m_words.begin(), m_words.end(), 0);
+}
+
+//----------------------------------------------------------------------------------------------------
+static void BuildPassableMask_Scalar(uint8_t const* flags, uint64_t const* occupied, uint64_t* outWords, int const numWords, uint8_t const blockFlags, uint8_t const allowFlags)
+{
+    for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+    {
+        uint8_t const* tiles       = flags + wordIndex * 64;
+        uint64_t       blockedBits = 0;
+
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            bool const isBlocked = (tiles[bit] & blockFlags) != 0 && (tiles[bit] & allowFlags) == 0;
+
+            blockedBits |= static_cast<uint64_t>(isBlocked) << bit;
+        }
+
+        uint64_t const occupiedBits = occupied ? occupied[wordIndex] : 0;
+
+        outWords[wordIndex] = ~(blockedBits | occupiedBits);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+static void ExpandPassableMask_Scalar(uint64_t const* maskRow, uint16_t* fieldRow, int const numChunks)
+{
+    for (int tileX = 0; tileX < numChunks * 16; ++tileX)
+    {
+        bool const isPassable = (maskRow[tileX >> 6] >> (tileX & 63) & 1) != 0;
+
+        fieldRow[tileX] = isPassable ? 0 : TileDistanceField::UNREACHABLE;
+    }
+}
+
+#if defined(TILE_MASKS_X64)
+
+//----------------------------------------------------------------------------------------------------
+// 16 tiles per compare; four compares fill one 64-bit word.
+//
+static void BuildPassableMask_SSE2(uint8_t const* flags, uint64_t const* occupied, uint64_t* outWords, int const numWords, uint8_t const blockFlags, uint8_t const allowFlags)
+{
+    __m128i const block = _mm_set1_epi8(static_cast<char>(blockFlags));
+    __m128i const allow = _mm_set1_epi8(static_cast<char>(allowFlags));
+    __m128i const zero  = _mm_setzero_si128();
+
+    for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+    {
+        uint64_t blockedBits = 0;
+
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            __m128i const tiles          = _mm_loadu_si128(reinterpret_cast<__m128i const*>(flags + wordIndex * 64 + lane * 16));
+            __m128i const hasNoBlockFlag = _mm_cmpeq_epi8(_mm_and_si128(tiles, block), zero);
+            __m128i const hasNoAllowFlag = _mm_cmpeq_epi8(_mm_and_si128(tiles, allow), zero);
+            __m128i const isBlocked      = _mm_andnot_si128(hasNoBlockFlag, hasNoAllowFlag);
+
+            blockedBits |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(isBlocked))) << (lane * 16);
+        }
+
+        uint64_t const occupiedBits = occupied ? occupied[wordIndex] : 0;
+
+        outWords[wordIndex] = ~(blockedBits | occupiedBits);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Broadcasts 16 mask bits to 16 lanes, isolates one bit per lane, and turns clear bits into UNREACHABLE.
+//
+static void ExpandPassableMask_SSE2(uint64_t const* maskRow, uint16_t* fieldRow, int const numChunks)
+{
+    __m128i const lowBits  = _mm_setr_epi16(1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7);
+    __m128i const highBits = _mm_slli_epi16(lowBits, 8);
+    __m128i const zero     = _mm_setzero_si128();
+
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        uint64_t const bits16 = maskRow[chunk >> 2] >> ((chunk & 3) * 16) & 0xFFFF;
+        __m128i const  low    = _mm_set1_epi16(static_cast<short>(bits16 & 0xFF));
+        __m128i const  high   = _mm_set1_epi16(static_cast<short>(bits16 & 0xFF00));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(fieldRow + chunk * 16), _mm_cmpeq_epi16(_mm_and_si128(low, lowBits), zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(fieldRow + chunk * 16 + 8), _mm_cmpeq_epi16(_mm_and_si128(high, highBits), zero));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// 32 tiles per compare; two compares fill one 64-bit word.
+//
+TARGET_AVX2 static void BuildPassableMask_AVX2(uint8_t const* flags, uint64_t const* occupied, uint64_t* outWords, int const numWords, uint8_t const blockFlags, uint8_t const allowFlags)
+{
+    __m256i const block = _mm256_set1_epi8(static_cast<char>(blockFlags));
+    __m256i const allow = _mm256_set1_epi8(static_cast<char>(allowFlags));
+    __m256i const zero  = _mm256_setzero_si256();
+
+    for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+    {
+        uint64_t blockedBits = 0;
+
+        for (int lane = 0; lane < 2; ++lane)
+        {
+            __m256i const tiles          = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(flags + wordIndex * 64 + lane * 32));
+            __m256i const hasNoBlockFlag = _mm256_cmpeq_epi8(_mm256_and_si256(tiles, block), zero);
+            __m256i const hasNoAllowFlag = _mm256_cmpeq_epi8(_mm256_and_si256(tiles, allow), zero);
+            __m256i const isBlocked      = _mm256_andnot_si256(hasNoBlockFlag, hasNoAllowFlag);
+
+            blockedBits |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(isBlocked))) << (lane * 32);
+        }
+
+        uint64_t const occupiedBits = occupied ? occupied[wordIndex] : 0;
+
+        outWords[wordIndex] = ~(blockedBits | occupiedBits);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+TARGET_AVX2 static void ExpandPassableMask_AVX2(uint64_t const* maskRow, uint16_t* fieldRow, int const numChunks)
+{
+    __m256i const laneBits = _mm256_setr_epi16(1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7,
+                                               1 << 8, 1 << 9, 1 << 10, 1 << 11, 1 << 12, 1 << 13, 1 << 14, static_cast<short>(1 << 15));
+    __m256i const zero     = _mm256_setzero_si256();
+
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        uint64_t const bits16 = maskRow[chunk >> 2] >> ((chunk & 3) * 16) & 0xFFFF;
+        __m256i const  bits   = _mm256_set1_epi16(static_cast<short>(bits16));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(fieldRow + chunk * 16), _mm256_cmpeq_epi16(_mm256_and_si256(bits, laneBits), zero));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// AVX2 also needs the OS to save YMM registers, which __builtin_cpu_supports checks for us.
+//
+static bool IsAVX2Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    __cpuid(info, 1);
+    bool const hasOSXSave = (info[2] & (1 << 27)) != 0;
+    bool const hasAVX     = (info[2] & (1 << 28)) != 0;
+    if (!hasOSXSave || !hasAVX) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------
+struct TileMaskKernels
+{
+    PassableMaskKernel m_buildPassableMask  = BuildPassableMask_Scalar;
+    ExpandMaskKernel   m_expandPassableMask = ExpandPassableMask_Scalar;
+    char const*        m_name               = "Scalar";
+};
+
+//----------------------------------------------------------------------------------------------------
+// Picked once, on first use.
+//
+static TileMaskKernels const& GetTileMaskKernels()
+{
+    static TileMaskKernels const s_kernels = []
+    {
+        TileMaskKernels kernels;
+#if defined(TILE_MASKS_X64)
+        if (IsAVX2Supported())
+        {
+            kernels.m_buildPassableMask  = BuildPassableMask_AVX2;
+            kernels.m_expandPassableMask = ExpandPassableMask_AVX2;
+            kernels.m_name               = "AVX2";
+        }
+        else
+        {
+            kernels.m_buildPassableMask  = BuildPassableMask_SSE2;
+            kernels.m_expandPassableMask = ExpandPassableMask_SSE2;
+            kernels.m_name               = "SSE2";
+        }
+#endif
+        return kernels;
+    }();
+
+    return s_kernels;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The flag grid pitch and the bitmap row are both whole 64-tile words, so the grid is one flat pass.
+//
+void BuildPassableMask(TileFlagGrid const& flags,
+                       TileBitmap const*   occupied,
+                       uint8_t const       blockFlags,
+                       uint8_t const       allowFlags,
+                       TileBitmap&         outMask)
+{
+    if (outMask.GetDimensions() != flags.GetDimensions())
+    {
+        outMask.Resize(flags.GetDimensions());
+    }
+
+    if (occupied && occupied->GetDimensions() != flags.GetDimensions())
+    {
+        ERROR_AND_DIE("BuildPassableMask: occupancy bitmap does not match the tile grid")
+    }
+
+    GetTileMaskKernels().m_buildPassableMask(flags.GetRow(0),
+                                             occupied ? occupied->GetWords() : nullptr,
+                                             outMask.GetWords(),
+                                             outMask.GetNumWords(),
+                                             blockFlags,
+                                             allowFlags);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Passable tiles become 0 and everything else UNREACHABLE, padding included.
+//
+void ExpandPassableMaskToDistanceField(TileBitmap const& mask, TileDistanceField& outField)
+{
+    if (mask.GetDimensions() != outField.GetDimensions())
+    {
+        ERROR_AND_DIE("ExpandPassableMaskToDistanceField: mask does not match the field")
+    }
+
+    ExpandMaskKernel const kernel    = GetTileMaskKernels().m_expandPassableMask;
+    int const              numChunks = outField.GetRowPitch() / 16;
+
+    for (int tileY = 0; tileY < outField.GetDimensions().y; ++tileY)
+    {
+        kernel(mask.GetRow(tileY), outField.GetRow(tileY), numChunks);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Kogge-Stone occluded fills: spread seed bits through runs of passable bits, toward higher or lower
+// bit indices, in log2(64) steps without looping over individual tiles.
+//
+static uint64_t FillTowardHighBits(uint64_t seeds, uint64_t passable)
+{
+    seeds &= passable;
+    seeds |= passable & (seeds << 1);
+    passable &= passable << 1;
+    seeds |= passable & (seeds << 2);
+    passable &= passable << 2;
+    seeds |= passable & (seeds << 4);
+    passable &= passable << 4;
+    seeds |= passable & (seeds << 8);
+    passable &= passable << 8;
+    seeds |= passable & (seeds << 16);
+    passable &= passable << 16;
+    seeds |= passable & (seeds << 32);
+
+    return seeds;
+}
+
+//----------------------------------------------------------------------------------------------------
+static uint64_t FillTowardLowBits(uint64_t seeds, uint64_t passable)
+{
+    seeds &= passable;
+    seeds |= passable & (seeds >> 1);
+    passable &= passable >> 1;
+    seeds |= passable & (seeds >> 2);
+    passable &= passable >> 2;
+    seeds |= passable & (seeds >> 4);
+    passable &= passable >> 4;
+    seeds |= passable & (seeds >> 8);
+    passable &= passable >> 8;
+    seeds |= passable & (seeds >> 16);
+    passable &= passable >> 16;
+    seeds |= passable & (seeds >> 32);
+
+    return seeds;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Spreads the reached bits of one row along their whole passable runs, carrying across word
+// boundaries. One pass each way is enough: the upward pass reaches the top of every seeded run and
+// the downward pass then covers the rest of it.
+//
+static void FillRowRuns(uint64_t* reached, uint64_t const* passable, int const numWords)
+{
+    uint64_t carry = 0;
+
+    for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+    {
+        reached[wordIndex] = FillTowardHighBits(reached[wordIndex] | carry, passable[wordIndex]);
+        carry              = reached[wordIndex] >> 63;
+    }
+
+    carry = 0;
+
+    for (int wordIndex = numWords - 1; wordIndex >= 0; --wordIndex)
+    {
+        reached[wordIndex] = FillTowardLowBits(reached[wordIndex] | carry, passable[wordIndex]);
+        carry              = reached[wordIndex] << 63;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Pulls reached bits in from the rows above and below; returns whether the row gained any tiles.
+//
+static bool SpreadIntoRow(TileBitmap& reached, TileBitmap const& passable, int const tileY)
+{
+    int const       numWords   = passable.GetWordsPerRow();
+    int const       numRows    = passable.GetDimensions().y;
+    uint64_t*       row        = reached.GetRow(tileY);
+    uint64_t const* passRow    = passable.GetRow(tileY);
+    uint64_t const* rowBelow   = tileY > 0 ? reached.GetRow(tileY - 1) : nullptr;
+    uint64_t const* rowAbove   = tileY < numRows - 1 ? reached.GetRow(tileY + 1) : nullptr;
+    bool            hasChanged = false;
+
+    for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+    {
+        uint64_t neighbors = 0;
+
+        if (rowBelow) neighbors |= rowBelow[wordIndex];
+        if (rowAbove) neighbors |= rowAbove[wordIndex];
+
+        uint64_t const newBits = neighbors & passRow[wordIndex] & ~row[wordIndex];
+
+        if (newBits != 0)
+        {
+            row[wordIndex] |= newBits;
+            hasChanged = true;
+        }
+    }
+
+    if (hasChanged)
+    {
+        FillRowRuns(row, passRow, numWords);
+    }
+
+    return hasChanged;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Marks every passable tile 4-connected to startCoords. Each row is 64 tiles per word, so a sweep
+// moves whole runs at once; sweeps alternate upward and downward until one adds nothing. A row is
+// only revisited when a neighboring row has gained tiles since it was last processed.
+//
+void FloodFillPassableMask(TileBitmap const& passable, IntVec2 const& startCoords, TileBitmap& outReached)
+{
+    IntVec2 const dimensions = passable.GetDimensions();
+
+    if (outReached.GetDimensions() != dimensions)
+    {
+        outReached.Resize(dimensions);
+    }
+    else
+    {
+        outReached.ClearAll();
+    }
+
+    if (startCoords.x < 0 || startCoords.x >= dimensions.x || startCoords.y < 0 || startCoords.y >= dimensions.y) return;
+    if (!passable.IsSet(startCoords)) return;
+
+    outReached.Set(startCoords);
+    FillRowRuns(outReached.GetRow(startCoords.y), passable.GetRow(startCoords.y), passable.GetWordsPerRow());
+
+    // Step counters: when each row last gained tiles, and when it was last processed
+    std::vector<int> changedAtStep(dimensions.y, 0);
+    std::vector<int> visitedAtStep(dimensions.y, 0);
+    int              step       = 1;
+    bool             hasChanged = true;
+
+    changedAtStep[startCoords.y] = step;
+
+    auto const visitRow = [&](int const tileY)
+    {
+        int const belowStep = tileY > 0 ? changedAtStep[tileY - 1] : 0;
+        int const aboveStep = tileY < dimensions.y - 1 ? changedAtStep[tileY + 1] : 0;
+
+        if (std::max(belowStep, aboveStep) <= visitedAtStep[tileY]) return;
+
+        visitedAtStep[tileY] = ++step;
+
+        if (SpreadIntoRow(outReached, passable, tileY))
+        {
+            changedAtStep[tileY] = step;
+            hasChanged           = true;
+        }
+    };
+
+    while (hasChanged)
+    {
+        hasChanged = false;
+
+        for (int tileY = 0; tileY < dimensions.y; ++tileY)
+        {
+            visitRow(tileY);
+        }
+
+        for (int tileY = dimensions.y - 1; tileY >= 0; --tileY)
+        {
+            visitRow(tileY);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+char const* GetTileMaskKernelName()
+{
+    return GetTileMaskKernels().m_name;
+}
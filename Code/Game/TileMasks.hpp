@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------------------------------------
+// TileMasks.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Math/IntVec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class TileDistanceField;
+
+//----------------------------------------------------------------------------------------------------
+enum TileFlag : uint8_t
+{
+    TILE_FLAG_NONE  = 0,
+    TILE_FLAG_SOLID = 1 << 0,
+    TILE_FLAG_WATER = 1 << 1
+};
+
+//----------------------------------------------------------------------------------------------------
+// One flag byte per tile, cached from the TileDefinitions so hot loops never look tiles up by name.
+// Rows are padded to a multiple of 64 tiles and the padding reads as solid, so the mask kernels run
+// over whole 64-tile words without a tail loop.
+//
+class TileFlagGrid
+{
+public:
+    static constexpr int TILES_PER_WORD = 64;
+
+    void Resize(IntVec2 const& dimensions);
+
+    IntVec2        GetDimensions() const { return m_dimensions; }
+    int            GetRowPitch() const { return m_rowPitch; }
+    uint8_t const* GetRow(int const y) const { return m_flags.data() + y * m_rowPitch; }
+    uint8_t        GetFlagsAtCoords(IntVec2 const& coords) const { return m_flags[coords.y * m_rowPitch + coords.x]; }
+    void           SetFlagsAtCoords(IntVec2 const& coords, uint8_t const flags) { m_flags[coords.y * m_rowPitch + coords.x] = flags; }
+
+private:
+    IntVec2              m_dimensions = IntVec2::ZERO;
+    int                  m_rowPitch   = 0;
+    std::vector<uint8_t> m_flags;
+};
+
+//----------------------------------------------------------------------------------------------------
+// One bit per tile, 64 tiles per word, rows stored back to back. Bits past the map width stay clear.
+//
+class TileBitmap
+{
+public:
+    TileBitmap() = default;
+    explicit TileBitmap(IntVec2 const& dimensions) { Resize(dimensions); }
+
+    void Resize(IntVec2 const& dimensions);
+    void ClearAll();
+
+    IntVec2         GetDimensions() const { return m_dimensions; }
+    int             GetWordsPerRow() const { return m_wordsPerRow; }
+    int             GetNumWords() const { return static_cast<int>(m_words.size()); }
+    uint64_t*       GetRow(int const y) { return m_words.data() + y * m_wordsPerRow; }
+    uint64_t const* GetRow(int const y) const { return m_words.data() + y * m_wordsPerRow; }
+    uint64_t*       GetWords() { return m_words.data(); }
+    uint64_t const* GetWords() const { return m_words.data(); }
+
+    bool IsSet(IntVec2 const& coords) const { return (GetRow(coords.y)[coords.x >> 6] >> (coords.x & 63) & 1) != 0; }
+    void Set(IntVec2 const& coords) { GetRow(coords.y)[coords.x >> 6] |= uint64_t(1) << (coords.x & 63); }
+    void Clear(IntVec2 const& coords) { GetRow(coords.y)[coords.x >> 6] &= ~(uint64_t(1) << (coords.x & 63)); }
+
+private:
+    IntVec2               m_dimensions  = IntVec2::ZERO;
+    int                   m_wordsPerRow = 0;
+    std::vector<uint64_t> m_words;
+};
+
+//----------------------------------------------------------------------------------------------------
+// A tile is passable when it has none of blockFlags (or any of allowFlags) and its occupied bit, if
+// an occupancy bitmap is given, is clear. Runs the widest kernel the CPU supports.
+//
+void        BuildPassableMask(TileFlagGrid const& flags, TileBitmap const* occupied, uint8_t blockFlags, uint8_t allowFlags, TileBitmap& outMask);
+void        ExpandPassableMaskToDistanceField(TileBitmap const& mask, TileDistanceField& outField);
+void        FloodFillPassableMask(TileBitmap const& passable, IntVec2 const& startCoords, TileBitmap& outReached);
+char const* GetTileMaskKernelName();
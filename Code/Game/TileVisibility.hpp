@@ -0,0 +1,22 @@
+//----------------------------------------------------------------------------------------------------
+// TileVisibility.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+
+//----------------------------------------------------------------------------------------------------
+class TileBitmap;
+
+//----------------------------------------------------------------------------------------------------
+// Recursive shadowcasting: sets in outVisible every tile within radius tiles of originCoords that can
+// be seen from it, treating tiles clear in transparent (and everything off the map) as opaque. A tile
+// counts as seen when the line from the origin's center to its own is unshadowed, so the result agrees
+// with a center-to-center raycast except for lines that graze a wall corner. Each octant is scanned
+// row by row outward and a wall only splits the remaining slope range, so the work is proportional to
+// the tiles visited rather than to rays times their length. outVisible is resized to transparent's
+// dimensions and cleared first.
+//
+void ComputeFieldOfView(TileBitmap const& transparent, IntVec2 const& originCoords, int radius, TileBitmap& outVisible);
@@ -0,0 +1,172 @@
+//----------------------------------------------------------------------------------------------------
+// WorkerPool.cpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#include "Game/WorkerPool.hpp"
+
+#include "Game/Profiler.hpp"
+
+//----------------------------------------------------------------------------------------------------
+WorkerPool::WorkerPool(int const numWorkerThreads)
+{
+    m_threads.reserve(numWorkerThreads > 0 ? numWorkerThreads : 0);
+
+    for (int threadIndex = 0; threadIndex < numWorkerThreads; ++threadIndex)
+    {
+        m_threads.emplace_back(&WorkerPool::WorkerThreadMain, this, threadIndex);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Work that nobody waited on is dropped; owners wait on their tasks before the pool goes away.
+//
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isQuitting = true;
+    }
+
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+
+    m_threads.clear();
+    m_pendingTasks.clear();
+}
+
+//----------------------------------------------------------------------------------------------------
+WorkerTaskHandle WorkerPool::Submit(std::function<void(int)> function, int const count)
+{
+    WorkerTaskHandle task = std::make_shared<WorkerTask>();
+
+    task->m_function = std::move(function);
+    task->m_count    = count > 0 ? count : 0;
+    task->m_numRemaining.store(task->m_count);
+
+    if (task->m_count == 0) return task;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingTasks.push_back(task);
+    }
+
+    m_condition.notify_all();
+
+    return task;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Once every index of the task is claimed, the rest are already running elsewhere; sleep until the
+// thread that finishes the last one signals.
+//
+void WorkerPool::Wait(WorkerTaskHandle const& task)
+{
+    if (!task) return;
+
+    while (task->m_numRemaining.load(std::memory_order_acquire) > 0)
+    {
+        if (RunOnePendingIndex(task.get())) continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [&task]
+        {
+            return task->m_numRemaining.load(std::memory_order_acquire) == 0;
+        });
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+bool WorkerPool::IsDone(WorkerTaskHandle const& task) const
+{
+    return !task || task->m_numRemaining.load(std::memory_order_acquire) == 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+void WorkerPool::ParallelFor(int const count, std::function<void(int)> function)
+{
+    if (count <= 0) return;
+
+    if (count == 1)
+    {
+        function(0);
+        return;
+    }
+
+    Wait(Submit(std::move(function), count));
+}
+
+//----------------------------------------------------------------------------------------------------
+void WorkerPool::WorkerThreadMain(int const threadIndex)
+{
+    Profiler::SetThreadName(Stringf("Worker %d", threadIndex));
+
+    for (;;)
+    {
+        if (RunOnePendingIndex(nullptr)) continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_isQuitting || !m_pendingTasks.empty(); });
+
+        if (m_isQuitting) return;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// Claims and runs one index: from onlyTask when a waiting thread passes its task, otherwise from the
+// oldest queued task. Returns false when there was nothing to claim.
+//
+bool WorkerPool::RunOnePendingIndex(WorkerTask* onlyTask)
+{
+    WorkerTaskHandle claimedTask;
+    WorkerTask*      taskToRun = nullptr;
+    int              index     = -1;
+
+    if (onlyTask)
+    {
+        if (onlyTask->m_nextIndex.load(std::memory_order_relaxed) >= onlyTask->m_count) return false;
+
+        index = onlyTask->m_nextIndex.fetch_add(1);
+
+        if (index < onlyTask->m_count) taskToRun = onlyTask;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        while (!m_pendingTasks.empty())
+        {
+            WorkerTaskHandle const front = m_pendingTasks.front();
+
+            index = front->m_nextIndex.fetch_add(1);
+
+            if (index >= front->m_count - 1) m_pendingTasks.pop_front();
+
+            if (index < front->m_count)
+            {
+                claimedTask = front;
+                taskToRun   = front.get();
+                break;
+            }
+        }
+    }
+
+    if (!taskToRun) return false;
+
+    taskToRun->m_function(index);
+
+    if (taskToRun->m_numRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+
+        m_condition.notify_all();
+    }
+
+    return true;
+}
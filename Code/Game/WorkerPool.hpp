@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------------------------------
+// WorkerPool.hpp
+//----------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------
+// count calls of one function, m_function(0) ... m_function(count - 1). Indices are claimed one at a
+// time by whichever thread gets there first: any worker, or a thread waiting on this task.
+//
+struct WorkerTask
+{
+    std::function<void(int)> m_function;
+    int                      m_count = 0;
+    std::atomic<int>         m_nextIndex{0};
+    std::atomic<int>         m_numRemaining{0};
+};
+
+typedef std::shared_ptr<WorkerTask> WorkerTaskHandle;
+
+//----------------------------------------------------------------------------------------------------
+// Fixed set of worker threads fed from one shared queue. A thread that waits on a task helps run that
+// task's own indices and nothing else, so a short ParallelFor is never stuck behind someone's map tick,
+// and tasks may still submit and wait on tasks of their own.
+//
+class WorkerPool
+{
+public:
+    explicit WorkerPool(int numWorkerThreads);
+    ~WorkerPool();
+
+    WorkerPool(WorkerPool const&)            = delete;
+    WorkerPool& operator=(WorkerPool const&) = delete;
+
+    int              GetNumWorkerThreads() const { return static_cast<int>(m_threads.size()); }
+    WorkerTaskHandle Submit(std::function<void(int)> function, int count = 1);
+    void             Wait(WorkerTaskHandle const& task);
+    bool             IsDone(WorkerTaskHandle const& task) const;
+    void             ParallelFor(int count, std::function<void(int)> function);
+
+private:
+    void WorkerThreadMain(int threadIndex);
+    bool RunOnePendingIndex(WorkerTask* onlyTask);
+
+    std::vector<std::thread>     m_threads;
+    std::deque<WorkerTaskHandle> m_pendingTasks;     // Tasks that still have unclaimed indices
+    std::mutex                   m_mutex;
+    std::condition_variable      m_condition;        // Signaled when work is queued or a task finishes
+    bool                         m_isQuitting = false;
+};